@@ -161,7 +161,7 @@ void buildTopList(Graph &cg)
 
 void buildCallGraph(const Storage &stor)
 {
-    StopWatch watch;
+    StopWatch watch("buildCallGraph");
 
     for (Fnc *fnc : stor.fncs)
         handleFnc(fnc);
@@ -24,7 +24,9 @@
 #include <cl/easy.hh>
 #include <cl/killer.hh>
 #include <cl/memdebug.hh>
+#include <cl/metrics.hh>
 #include <cl/storage.hh>
+#include <cl/timeline.hh>
 
 #include "callgraph.hh"
 #include "cl_storage.hh"
@@ -49,6 +51,12 @@ class ClEasy: public ClStorageBuilder {
         {
             CL_DEBUG("ClEasy initialized: \"" << configString << "\"");
             printMemUsage("ClEasy::ClEasy");
+
+            // record the timeline of analysis phases if asked to do so
+            Timeline::enableByConfig(configString_);
+
+            // write the registered metrics to a file if asked to do so
+            Metrics::enableByConfig(configString_);
         }
 
     protected:
@@ -78,9 +86,14 @@ class ClEasy: public ClStorageBuilder {
             printMemUsage("killLocalVariables");
 
             CL_DEBUG("ClEasy is calling the analyzer...");
-            StopWatch watch;
-            clEasyRun(stor, configString_.c_str());
-            CL_PRINT_TIME(watch);
+            {
+                StopWatch watch("clEasyRun");
+                clEasyRun(stor, configString_.c_str());
+                CL_PRINT_TIME(watch);
+            }
+
+            Timeline::dump();
+            Metrics::dump();
         }
 
     private:
@@ -20,6 +20,7 @@
 #include "config_cl.h"
 #include "cl_storage.hh"
 
+#include <cl/cl_msg.hh>
 #include <cl/clutil.hh>
 #include <cl/storage.hh>
 
@@ -356,8 +357,57 @@ ClStorageBuilder::~ClStorageBuilder()
     delete d;
 }
 
+/// assign Var::denseIdx and Var::fncIdx to all variables of the storage
+void assignDenseVarIds(Storage &stor)
+{
+    // global variables
+    int cntGl = 0;
+    for (const Var &varRO : stor.vars) {
+        Var &var = stor.vars[varRO.uid];
+        if (!isOnStack(var))
+            var.denseIdx = cntGl++;
+    }
+
+    // variables on stack, numbered per each function
+    int fncIdx = 0;
+    for (const Fnc *fnc : stor.fncs) {
+        int cntLc = 0;
+        for (const cl_uid_t uid : fnc->vars) {
+            Var &var = stor.vars[uid];
+            if (!isOnStack(var))
+                continue;
+
+            CL_BREAK_IF(-1 != var.denseIdx);
+            var.denseIdx = cntLc++;
+            var.fncIdx = fncIdx;
+        }
+
+        ++fncIdx;
+    }
+
+    // variables on stack not used by any function should never appear, but
+    // if they do, give them a frame of their own so that the indices are valid
+    int cntOrphans = 0;
+    for (const Var &varRO : stor.vars) {
+        Var &var = stor.vars[varRO.uid];
+        if (!isOnStack(var) || -1 != var.denseIdx)
+            continue;
+
+        CL_WARN_MSG(&var.loc, "internal error: variable #" << var.uid
+                << " is on stack but not used by any function");
+        var.denseIdx = cntOrphans++;
+        var.fncIdx = fncIdx;
+    }
+}
+
 void ClStorageBuilder::acknowledge()
 {
+    // the type graph is complete at this point
+    d->stor.types.canonicalize();
+
+    // so is the set of variables
+    assignDenseVarIds(d->stor);
+
     this->run(d->stor);
 }
 
@@ -28,9 +28,46 @@
 #include <sstream>
 #include <tuple>
 
+static TypeCmpStats typeCmpStatsData;
+static bool typeCmpStatsEnabled;
+
+void enableTypeCmpStats()
+{
+    typeCmpStatsEnabled = true;
+}
+
+const TypeCmpStats& typeCmpStats()
+{
+    return typeCmpStatsData;
+}
+
 bool operator==(const struct cl_type &a, const struct cl_type &b)
 {
+    TypeCmpStats &st = typeCmpStatsData;
+    if (typeCmpStatsEnabled)
+        ++st.cntTotal;
+
+    if (a.uid == b.uid) {
+        if (typeCmpStatsEnabled)
+            ++st.cntByUid;
+
+        return true;
+    }
+
+    const int canonA = canonTypeId(&a);
+    const int canonB = canonTypeId(&b);
+    if (-1 != canonA && -1 != canonB) {
+        // both types have been hash-consed by TypeDb::canonicalize()
+        if (typeCmpStatsEnabled)
+            ++st.cntByCanonId;
+
+        return canonA == canonB;
+    }
+
     // go through the given types recursively and match UIDs etc.
+    if (typeCmpStatsEnabled)
+        ++st.cntByWalk;
+
     typedef std::pair<const struct cl_type *, const struct cl_type *> TItem;
     TItem item(&a, &b);
     WorkList<TItem> wl(item);
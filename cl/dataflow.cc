@@ -0,0 +1,139 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config_cl.h"
+#include <cl/dataflow.hh>
+
+#include <cl/cl_msg.hh>
+#include <cl/storage.hh>
+
+#include <stack>
+
+namespace CodeStorage {
+namespace DataFlow {
+
+bool BitVector::unite(const BitVector &other)
+{
+    const unsigned cnt = other.words_.size();
+    if (words_.size() < cnt)
+        words_.resize(cnt, 0UL);
+
+    bool anyChange = false;
+    for (unsigned pos = 0; pos < cnt; ++pos) {
+        const unsigned long w = words_[pos] | other.words_[pos];
+        if (w == words_[pos])
+            continue;
+
+        words_[pos] = w;
+        anyChange = true;
+    }
+
+    return anyChange;
+}
+
+bool BitVector::uniteMinus(const BitVector &other, const BitVector &mask)
+{
+    const unsigned cnt = other.words_.size();
+    if (words_.size() < cnt)
+        words_.resize(cnt, 0UL);
+
+    const unsigned cntMask = mask.words_.size();
+
+    bool anyChange = false;
+    for (unsigned pos = 0; pos < cnt; ++pos) {
+        unsigned long add = other.words_[pos];
+        if (pos < cntMask)
+            add &= ~mask.words_[pos];
+
+        const unsigned long w = words_[pos] | add;
+        if (w == words_[pos])
+            continue;
+
+        words_[pos] = w;
+        anyChange = true;
+    }
+
+    return anyChange;
+}
+
+BlockOrder::BlockOrder(const ControlFlow &cfg)
+{
+    const unsigned cnt = cfg.size();
+    if (!cnt)
+        return;
+
+    // iterative DFS from the entry, collecting blocks in post-order
+    typedef std::pair<TBlock, unsigned /* next target */> TItem;
+    std::stack<TItem> dfsStack;
+    std::map<TBlock, bool> seen;
+    std::vector<TBlock> postOrder;
+
+    const TBlock entry = cfg.entry();
+    dfsStack.push(TItem(entry, 0U));
+    seen[entry] = true;
+    while (!dfsStack.empty()) {
+        TItem &item = dfsStack.top();
+        const TTargetList &targets = item.first->targets();
+        if (item.second < targets.size()) {
+            const TBlock bbNext = targets[item.second++];
+            if (seen[bbNext])
+                continue;
+
+            seen[bbNext] = true;
+            dfsStack.push(TItem(bbNext, 0U));
+            continue;
+        }
+
+        postOrder.push_back(item.first);
+        dfsStack.pop();
+    }
+
+    blocks_.assign(postOrder.rbegin(), postOrder.rend());
+
+    // blocks unreachable from the entry go last
+    for (const TBlock bb : cfg)
+        if (!seen[bb])
+            blocks_.push_back(bb);
+
+    const unsigned cntBlocks = blocks_.size();
+    for (unsigned idx = 0; idx < cntBlocks; ++idx)
+        idxByBlock_[blocks_[idx]] = idx;
+
+    succs_.resize(cntBlocks);
+    preds_.resize(cntBlocks);
+    for (unsigned idx = 0; idx < cntBlocks; ++idx) {
+        for (const TBlock bbDst : blocks_[idx]->targets()) {
+            const unsigned idxDst = this->indexOf(bbDst);
+            succs_[idx].push_back(idxDst);
+            preds_[idxDst].push_back(idx);
+        }
+    }
+}
+
+unsigned BlockOrder::indexOf(TBlock bb) const
+{
+    const std::map<TBlock, unsigned>::const_iterator it = idxByBlock_.find(bb);
+    if (idxByBlock_.end() == it) {
+        CL_BREAK_IF("BlockOrder::indexOf() got a block out of the CFG");
+        return 0;
+    }
+
+    return it->second;
+}
+
+} // namespace DataFlow
+} // namespace CodeStorage
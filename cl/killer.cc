@@ -23,6 +23,8 @@
 #include <cl/cl_msg.hh>
 #include <cl/cldebug.hh>
 #include <cl/clutil.hh>
+#include <cl/dataflow.hh>
+#include <cl/metrics.hh>
 #include <cl/storage.hh>
 
 #include "pointsto.hh"
@@ -55,7 +57,6 @@ typedef const struct cl_loc                *TLoc;
 typedef const CodeStorage::Var             *TStorVar;
 typedef const CodeStorage::Fnc             *TFnc;
 typedef const Block                        *TBlock;
-typedef std::set<TBlock>                    TBlockSet;
 typedef std::vector<TSet>                   TLivePerTarget;
 
 typedef std::map<TBlock, BlockData>         TMap;
@@ -63,7 +64,6 @@ typedef std::map<TBlock, BlockData>         TMap;
 /// shared data
 struct Data {
     TStorRef                                stor;
-    TBlockSet                               todo;
     TMap                                    blocks;
     TFnc                                    fnc;
     TAliasMap                               derefAliases;
@@ -79,47 +79,19 @@ struct VarData {
     const Var  *v;
 };
 
-/**
- * this is used just to make some statistics of how many variables is killed
- * with help of PointsTo analysis.
- */
-class PTStats {
-    static PTStats *inst;
-
-    public:
-        int count;
-        int fullCount;
-
-    public:
-        static PTStats *getInstance() {
-            if (!inst)
-                inst = new PTStats();
-            return inst;
-        }
-
-
-
-    private:
-        // singleton
-        PTStats() :
-            count(0),
-            fullCount(0)
-        {
-        }
-};
-// initialize
-PTStats *PTStats::inst = 0;
+/// how many variables are killed with help of PointsTo analysis
+static Metrics::Counter cntPtKillsTotal("killer.pt_kills_total");
+static Metrics::Counter cntPtKillsNonLocal("killer.pt_kills_nonlocal");
 
 void countPtStat(Data &data, cl_uid_t uid)
 {
-    PTStats *stats = PTStats::getInstance();
-    stats->fullCount++;
+    cntPtKillsTotal.inc();
 
     if (hasKey(data.fnc->vars, uid))
         // is local uid
         return;
 
-    stats->count ++;
+    cntPtKillsNonLocal.inc();
 
     // killing pointer target
     VK_DEBUG(0, "killing " << uid << " by its pointer!");
@@ -274,51 +246,127 @@ void scanInsn(BlockData *pDst, const Insn *insn, TAliasMap *pAliasMap)
     }
 }
 
-void updateBlock(Data &data, TBlock bb)
+/// liveness of local variables as a backward problem over bit-vectors
+class LivenessProblem {
+    public:
+        LivenessProblem(Data &data, const DataFlow::BlockOrder &order);
+
+        /// live(bb) = gen(bb) | (live(succ_1) | ... | live(succ_n)) & ~kill(bb)
+        bool update(unsigned idx);
+
+        /// store the live variables back to BlockData::gen of each block
+        void commit();
+
+    private:
+        typedef DataFlow::BitVector                 TBits;
+
+        unsigned idxOf(TVar uid);
+        void toBits(TBits *pDst, const TSet &src);
+
+        Data                                       &data_;
+        const DataFlow::BlockOrder                 &order_;
+        std::vector<TVar>                           varByIdx_;
+        unsigned                                    cntLocals_;
+        std::map<TVar, unsigned>                    idxByForeignVar_;
+        std::vector<TBits>                          gen_;
+        std::vector<TBits>                          kill_;
+        std::vector<TBits>                          live_;
+};
+
+unsigned LivenessProblem::idxOf(const TVar uid)
 {
-    VK_DEBUG_MSG(2, &bb->front()->loc, "updateBlock: " << bb->name());
-    BlockData &bData = data.blocks[bb];
-    bool anyChange = false;
+    const Var &var = data_.stor.vars[uid];
+    if (isOnStack(var) && hasKey(data_.fnc->vars, uid))
+        // a variable of this function, Var::denseIdx is in [0, cntLocals_)
+        return var.denseIdx;
 
-    // go through all variables generated by successors
-    for (TBlock bbSrc : bb->targets()) {
-        BlockData &bDataSrc = data.blocks[bbSrc];
+    // a variable of another function, reached through a pointer (rare)
+    const unsigned idx = varByIdx_.size();
+    const std::pair<std::map<TVar, unsigned>::iterator, bool> ret =
+        idxByForeignVar_.insert(std::make_pair(uid, idx));
 
-        // update self
-        for (TVar uid : bDataSrc.gen) {
-            if (hasKey(bData.kill, uid))
-                // we are killing the variable
-                continue;
+    if (ret.second)
+        varByIdx_.push_back(uid);
 
-            if (insertOnce(bData.gen, uid))
-                anyChange = true;
-        }
+    return ret.first->second;
+}
+
+void LivenessProblem::toBits(TBits *pDst, const TSet &src)
+{
+    for (const TVar uid : src)
+        pDst->set(this->idxOf(uid));
+}
+
+LivenessProblem::LivenessProblem(
+        Data                                       &data,
+        const DataFlow::BlockOrder                 &order):
+    data_(data),
+    order_(order),
+    cntLocals_(0)
+{
+    // the variables of this function are addressed by Var::denseIdx
+    for (const TVar uid : data.fnc->vars) {
+        const Var &var = data.stor.vars[uid];
+        if (!isOnStack(var))
+            continue;
+
+        CL_BREAK_IF(var.denseIdx < 0);
+        const unsigned idx = var.denseIdx;
+        if (cntLocals_ <= idx)
+            cntLocals_ = idx + 1U;
     }
 
-    if (!anyChange)
-        // nothing updated actually
-        return;
+    varByIdx_.resize(cntLocals_, /* not used */ -1);
+    for (const TVar uid : data.fnc->vars) {
+        const Var &var = data.stor.vars[uid];
+        if (isOnStack(var))
+            varByIdx_[var.denseIdx] = uid;
+    }
 
-    // schedule all predecessors
-    for (TBlock bbDst : bb->inbound())
-        data.todo.insert(bbDst);
+    const unsigned cnt = order.size();
+    gen_.resize(cnt, TBits(cntLocals_));
+    kill_.resize(cnt, TBits(cntLocals_));
+    live_.resize(cnt, TBits(cntLocals_));
+
+    for (unsigned idx = 0; idx < cnt; ++idx) {
+        const BlockData &bData = data.blocks[order[idx]];
+        this->toBits(&gen_[idx], bData.gen);
+        this->toBits(&kill_[idx], bData.kill);
+    }
+}
+
+bool LivenessProblem::update(const unsigned idx)
+{
+    TBits &live = live_[idx];
+    bool anyChange = live.unite(gen_[idx]);
+
+    // go through all variables generated by successors
+    for (const unsigned idxSrc : order_.succs(idx))
+        anyChange |= live.uniteMinus(live_[idxSrc], kill_[idx]);
+
+    return anyChange;
+}
+
+void LivenessProblem::commit()
+{
+    const unsigned cnt = order_.size();
+    for (unsigned idx = 0; idx < cnt; ++idx) {
+        TSet &gen = data_.blocks[order_[idx]].gen;
+        live_[idx].forEach([this, &gen](unsigned idxVar) {
+            gen.insert(varByIdx_[idxVar]);
+        });
+    }
 }
 
 void computeFixPoint(Data &data)
 {
     // fixed-point computation
-    unsigned cntSteps = 1;
-    TBlockSet &todo = data.todo;
-    while (!todo.empty()) {
-        TBlockSet::iterator i = todo.begin();
-        TBlock bb = *i;
-        todo.erase(i);
-
-        // (re)compute a single basic block
-        updateBlock(data, bb);
-        ++cntSteps;
-    }
+    const DataFlow::BlockOrder order(data.fnc->cfg);
+    LivenessProblem prob(data, order);
+    const unsigned cntSteps =
+        DataFlow::solve(prob, order, DataFlow::DF_BACKWARD);
 
+    prob.commit();
     VK_DEBUG(2, "fixed-point reached in " << cntSteps << " steps");
 }
 
@@ -601,7 +649,6 @@ void analyzeFnc(Fnc &fnc)
 
     TLoc loc = &fnc.def.data.cst.data.cst_fnc.loc;
     VK_DEBUG_MSG(2, loc, ">>> entering " << nameOf(fnc) << "()");
-    CL_BREAK_IF(!data.todo.empty());
 
     // pre-compute dereferences
     findAliases(data, fnc);
@@ -618,8 +665,6 @@ void analyzeFnc(Fnc &fnc)
 
         // guarantee to distribute pointer-targests exist when function finishes
         presetLive(data, bb);
-
-        data.todo.insert(bb);
     }
 
     // compute a fixed-point for a single function
@@ -637,7 +682,7 @@ void analyzeFnc(Fnc &fnc)
 
 void killLocalVariables(Storage &stor)
 {
-    StopWatch watch;
+    StopWatch watch("killLocalVariables");
 
     // analyze all _defined_ functions
     for (Fnc *pFnc : stor.fncs) {
@@ -649,10 +694,11 @@ void killLocalVariables(Storage &stor)
         VarKiller::analyzeFnc(fnc);
     }
 
-    VarKiller::PTStats *stats = VarKiller::PTStats::getInstance();
-    if (stats->count > 0) {
-        VK_DEBUG(0, "there was killed " << stats->count 
-                << "/" << stats->fullCount << " variables by PointsTo");
+    const unsigned long cntPtKills = VarKiller::cntPtKillsNonLocal.value();
+    if (cntPtKills > 0) {
+        VK_DEBUG(0, "there was killed " << cntPtKills
+                << "/" << VarKiller::cntPtKillsTotal.value()
+                << " variables by PointsTo");
     }
 
     CL_DEBUG("killLocalVariables() took " << watch);
@@ -143,7 +143,7 @@ void analyzeFnc(Fnc &fnc)
 
 void findLoopClosingEdges(Storage &stor)
 {
-    StopWatch watch;
+    StopWatch watch("findLoopClosingEdges");
 
     // go through all _defined_ functions
     for (Fnc *pFnc : stor.fncs) {
@@ -24,6 +24,81 @@
 
 #include <iomanip>
 
+struct AmountFormatter {
+    float       value;
+    unsigned    width;
+    unsigned    pre;
+
+    AmountFormatter(ssize_t value_, unsigned div, unsigned dig, unsigned dec):
+        value(value_),
+        width(dig + 1 + dec),
+        pre(dec)
+    {
+        const float ratio = static_cast<float>(1U << div);
+        value /= ratio;
+    }
+};
+
+std::ostream& operator<<(std::ostream &str, const AmountFormatter &fmt)
+{
+    const std::ios_base::fmtflags oldFlags = str.flags();
+    const int oldPrecision = str.precision();
+
+    using namespace std;
+    str << fixed << setw(fmt.width) << setprecision(fmt.pre) << fmt.value;
+
+    str.flags(oldFlags);
+    str.precision(oldPrecision);
+    return str;
+}
+
+MemCategoryStats memCategoryStats[MC_TOTAL];
+
+static const char *memCategoryNames[MC_TOTAL] = {
+    "CodeStorage",
+    "symbolic heaps",
+    "block states",
+    "trace graph",
+    "call cache",
+    "fixed-point"
+};
+
+bool printMemAccounting()
+{
+    for (int cat = 0; cat < MC_TOTAL; ++cat) {
+        const MemCategoryStats &st = memCategoryStats[cat];
+        CL_NOTE("memory usage of " << std::left << std::setw(16)
+                << memCategoryNames[cat] << std::right
+                << AmountFormatter(st.live,
+                    /* MiB */ 20,
+                    /* int digits */ 4,
+                    /* dec digits */ 2)
+                << " MB live, "
+                << AmountFormatter(st.peak,
+                    /* MiB */ 20,
+                    /* int digits */ 4,
+                    /* dec digits */ 2)
+                << " MB peak");
+    }
+
+    return true;
+}
+
+void* memAccountedNew(const EMemCategory cat, const std::size_t size)
+{
+    memAccount(cat, size);
+    return ::operator new(size);
+}
+
+void memAccountedDelete(
+        const EMemCategory          cat,
+        void                       *ptr,
+        const std::size_t           size)
+{
+    memAccount(cat, -static_cast<ssize_t>(size));
+    ::operator delete(ptr);
+}
+
 #if DEBUG_MEM_USAGE
 #   include <malloc.h>
 
@@ -84,34 +159,6 @@ bool currentMemUsage(ssize_t *pDst)
     return true;
 }
 
-struct AmountFormatter {
-    float       value;
-    unsigned    width;
-    unsigned    pre;
-
-    AmountFormatter(ssize_t value_, unsigned div, unsigned dig, unsigned dec):
-        value(value_),
-        width(dig + 1 + dec),
-        pre(dec)
-    {
-        const float ratio = static_cast<float>(1U << div);
-        value /= ratio;
-    }
-};
-
-std::ostream& operator<<(std::ostream &str, const AmountFormatter &fmt)
-{
-    const std::ios_base::fmtflags oldFlags = str.flags();
-    const int oldPrecision = str.precision();
-
-    using namespace std;
-    str << fixed << setw(fmt.width) << setprecision(fmt.pre) << fmt.value;
-
-    str.flags(oldFlags);
-    str.precision(oldPrecision);
-    return str;
-}
-
 #include <iostream>
 bool printMemUsage(const char *fnc)
 {
@@ -143,7 +190,7 @@ bool printPeakMemUsage()
                 /* dec digits */ 2)
             << " MB");
 
-    return true;
+    return printMemAccounting();
 }
 
 #else // DEBUG_MEM_USAGE
@@ -0,0 +1,211 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config_cl.h"
+#include <cl/metrics.hh>
+
+#include <cl/cl_msg.hh>
+#include <cl/json.hh>
+#include <cl/timeline.hh>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+namespace Metrics {
+
+/// tick() looks at the clock only once per this count of calls
+static const unsigned ticksPerClockCheck = 0x100;
+
+typedef std::vector<const Metric *> TRegistry;
+
+// constructed on the first use since metrics live in static objects
+static TRegistry& registry()
+{
+    static TRegistry reg;
+    return reg;
+}
+
+static bool                 isEnabled;
+static std::string          fileName;
+static double               period;
+static double               epoch;
+static double               lastDump;
+static unsigned             cntTicks;
+
+Metric::Metric(const char *name):
+    name_(name)
+{
+    registry().push_back(this);
+}
+
+void Counter::printJson(std::ostream &str) const
+{
+    str << value_;
+}
+
+void Gauge::printJson(std::ostream &str) const
+{
+    str << "{\"value\": " << value_ << ", \"max\": " << max_ << "}";
+}
+
+Histogram::Histogram(const char *name):
+    Metric(name),
+    cnt_(0UL),
+    sum_(0UL),
+    min_(0UL),
+    max_(0UL)
+{
+    for (unsigned long &cnt : buckets_)
+        cnt = 0UL;
+
+    min_ = ~min_;
+}
+
+void Histogram::printJson(std::ostream &str) const
+{
+    str << "{\"count\": " << cnt_ << ", \"sum\": " << sum_;
+    if (cnt_)
+        str << ", \"min\": " << min_ << ", \"max\": " << max_;
+
+    // label each non-empty bucket by the range of values it covers
+    str << ", \"buckets\": {";
+    const char *sep = "";
+    for (unsigned idx = 0; idx < cntBuckets; ++idx) {
+        const unsigned long cnt = buckets_[idx];
+        if (!cnt)
+            continue;
+
+        str << sep << "\"";
+        if (idx < 2U)
+            str << idx;
+        else {
+            const unsigned long lo = 1UL << (idx - 1U);
+            str << lo << ".." << (lo + (lo - 1UL));
+        }
+
+        str << "\": " << cnt;
+        sep = ", ";
+    }
+
+    str << "}}";
+}
+
+bool enabled()
+{
+    return isEnabled;
+}
+
+void enableByConfig(const std::string &configString)
+{
+    static const std::string opt = "metrics";
+    static const std::string optPeriod = "metrics_period:";
+
+    std::string::size_type pos = 0;
+    while (pos <= configString.size()) {
+        std::string::size_type end = configString.find(',', pos);
+        if (std::string::npos == end)
+            end = configString.size();
+
+        const std::string item = configString.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (!item.compare(0, optPeriod.size(), optPeriod)) {
+            period = atof(item.substr(optPeriod.size()).c_str());
+            continue;
+        }
+
+        if (item == opt)
+            fileName = "metrics.json";
+        else if (!item.compare(0, opt.size() + 1, opt + ":"))
+            fileName = item.substr(opt.size() + 1);
+        else
+            continue;
+
+        if (fileName.empty())
+            fileName = "metrics.json";
+
+        isEnabled = true;
+    }
+
+    epoch = lastDump = Timeline::wallClock();
+}
+
+void printJson(std::ostream &str)
+{
+    typedef std::map<std::string, const Metric *> TByName;
+    TByName byName;
+    for (const Metric *m : registry())
+        byName[m->name()] = m;
+
+    str << "{\n  \"elapsed_s\": " << std::fixed << std::setprecision(3)
+        << (Timeline::wallClock() - epoch);
+
+    for (TByName::const_reference item : byName) {
+        str << ",\n  " << JsonStr(item.first) << ": ";
+        item.second->printJson(str);
+    }
+
+    str << "\n}\n";
+}
+
+void tick()
+{
+    if (period <= 0.0 || !isEnabled)
+        return;
+
+    if (++cntTicks < ticksPerClockCheck)
+        return;
+
+    cntTicks = 0U;
+    if (Timeline::wallClock() < lastDump + period)
+        return;
+
+    dump();
+}
+
+void dump()
+{
+    if (!isEnabled)
+        return;
+
+    // write a temporary file first so that readers never see a partial dump
+    const std::string tmpName = fileName + ".tmp";
+    {
+        std::fstream str(tmpName.c_str(), std::ios::out);
+        if (!str) {
+            CL_ERROR("unable to create file '" << tmpName << "'");
+            return;
+        }
+
+        printJson(str);
+    }
+
+    if (rename(tmpName.c_str(), fileName.c_str())) {
+        CL_ERROR("unable to rename '" << tmpName << "' to '"
+                << fileName << "'");
+        return;
+    }
+
+    lastDump = Timeline::wallClock();
+    CL_DEBUG("metrics written to '" << fileName << "'");
+}
+
+} // namespace Metrics
@@ -25,6 +25,7 @@
 
 #include "pointsto.hh"
 #include "pointsto_fics.hh"
+#include "pointsto_steens.hh"
 #include "pointsto_assert.hh"
 
 #include "worklist.hh"
@@ -556,6 +557,12 @@ static void ptParseOpts(BuildCtx &ctx, const char *ptr)
             PT_DEBUG(0, "Request for plotting PT-graph when graph changed.");
             ctx.plot.progress = "points-to-progress";
         }
+        else if (STREQ(option, "points_to:fics"))
+            ctx.algorithm = PT_ALGO_FICS;
+        else if (STREQ(option, "points_to:steensgaard")) {
+            PT_DEBUG(0, "Request for unification-based points-to analysis.");
+            ctx.algorithm = PT_ALGO_STEENSGAARD;
+        }
         else
             PT_ERROR("Bad argument '" << option << "'");
     }
@@ -653,7 +660,7 @@ bool existsError(const Storage &stor)
 
 void pointsToAnalyse(Storage &stor, const std::string &conf)
 {
-    StopWatch watch;
+    StopWatch watch("pointsToAnalyse");
 
     PointsTo::BuildCtx ctx(stor);
     ptParseOpts(ctx, conf.c_str());
@@ -663,9 +670,16 @@ void pointsToAnalyse(Storage &stor, const std::string &conf)
         PT_ERROR("points-to analyse requires correct call graph");
         goto done;
     }
-    // FICS only for now
-    if (!PointsTo::runFICS(ctx)) {
-        stor.ptd.dead = true;
+    switch (ctx.algorithm) {
+        case PointsTo::PT_ALGO_FICS:
+            if (!PointsTo::runFICS(ctx))
+                stor.ptd.dead = true;
+            break;
+
+        case PointsTo::PT_ALGO_STEENSGAARD:
+            if (!PointsTo::runSteensgaard(ctx))
+                stor.ptd.dead = true;
+            break;
     }
 
 done:
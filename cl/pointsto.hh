@@ -48,6 +48,11 @@ namespace PointsTo {
 #define FICS_PHASE_2 0x02
 #define FICS_PHASE_3 0x04
 
+    enum EAlgorithm {
+        PT_ALGO_FICS = 0,           ///< three-phase FICS (the default)
+        PT_ALGO_STEENSGAARD         ///< near-linear unification-based
+    };
+
     // structure used for keeping building context among functions
     class BuildCtx {
         public:
@@ -55,6 +60,9 @@ namespace PointsTo {
             CodeStorage::Storage       &stor;
             Graph                      *ptg;
 
+            // which algorithm is going to build the graphs
+            EAlgorithm                  algorithm;
+
             struct plot {
                 // set this variable when you want to plot all points-to graphs
                 // when some of them is changed.  Content of this variable will
@@ -71,7 +79,8 @@ namespace PointsTo {
 
             BuildCtx(Storage &stor_) :
                 stor(stor_),
-                ptg(NULL)
+                ptg(NULL),
+                algorithm(PT_ALGO_FICS)
             {
                 plot.progress = NULL; // disable by default
                 debug.phases = FICS_PHASE_1 | FICS_PHASE_2 | FICS_PHASE_3;
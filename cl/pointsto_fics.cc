@@ -166,7 +166,7 @@ inline bool isPtrRelatedType(const cl_type *type)
     return isDataPtr(type);
 }
 
-inline bool isPtrRelated(const cl_operand &op)
+bool isPtrRelated(const cl_operand &op)
 {
     if (op.code == CL_OPERAND_VOID)
         return false;
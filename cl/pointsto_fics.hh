@@ -30,6 +30,15 @@ namespace PointsTo {
 
 bool runFICS(BuildCtx &ctx);
 
+// helpers shared with the other points-to algorithms
+bool isNull(const cl_operand &op);
+bool isPtrRelated(const cl_operand &op);
+const char *fncNameFromInsn(const Insn *insn);
+cl_uid_t generateMallocUid(const Insn *insn);
+bool isWhiteListed(const Insn *insn);
+bool isWhiteListed(const Fnc *fnc);
+void makeBlackHole(Fnc &fnc);
+
 } /* namespace PointsTo */
 } /* namespace CodeStorage */
 
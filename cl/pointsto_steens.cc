@@ -0,0 +1,508 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "util.hh"
+#include "builtins.hh"
+
+#include <cl/clutil.hh>
+#include <cl/storage.hh>
+
+#include "pointsto.hh"
+#include "pointsto_fics.hh"
+#include "pointsto_steens.hh"
+
+#include <algorithm>
+
+namespace CodeStorage {
+namespace PointsTo {
+
+/**
+ * union-find over equivalence class representatives (ECRs), each class points
+ * to at most one other class
+ *
+ * All the data are kept in flat arrays indexed by a dense ECR index, so that
+ * even large programs need just a few words per variable.
+ */
+class EcrSet {
+    public:
+        EcrSet():
+            cntJoins_(0)
+        {
+        }
+
+        /// create a new singleton class, item may be NULL for anonymous targets
+        int add(const Item *item) {
+            const int idx = parent_.size();
+            parent_.push_back(idx);
+            rank_.push_back(0);
+            pointee_.push_back(-1);
+            items_.push_back(item);
+            return idx;
+        }
+
+        int find(int idx) {
+            while (parent_[idx] != idx) {
+                // path halving
+                parent_[idx] = parent_[parent_[idx]];
+                idx = parent_[idx];
+            }
+
+            return idx;
+        }
+
+        /// return the class pointed by ecr, create an anonymous one if needed
+        int pointee(int ecr) {
+            ecr = this->find(ecr);
+            if (-1 == pointee_[ecr]) {
+                const int target = this->add(/* anonymous */ 0);
+                pointee_[ecr] = target;
+                return target;
+            }
+
+            return this->find(pointee_[ecr]);
+        }
+
+        /// return the class pointed by ecr, or -1 if there is none
+        int pointeeIfAny(int ecr) {
+            ecr = this->find(ecr);
+            const int target = pointee_[ecr];
+            return (-1 == target)
+                ? -1
+                : this->find(target);
+        }
+
+        /// unify the classes of a and b, together with their targets
+        void join(int a, int b);
+
+        unsigned size() const {
+            return parent_.size();
+        }
+
+        const Item* item(int idx) const {
+            return items_[idx];
+        }
+
+        unsigned cntJoins() const {
+            return cntJoins_;
+        }
+
+    private:
+        std::vector<int>                parent_;
+        std::vector<unsigned char>      rank_;
+        std::vector<int>                pointee_;
+        std::vector<const Item *>       items_;
+        unsigned                        cntJoins_;
+};
+
+void EcrSet::join(int a, int b)
+{
+    // the unification of targets is done iteratively to avoid deep recursion
+    typedef std::pair<int, int> TPair;
+    std::vector<TPair> todo(1, TPair(a, b));
+
+    while (!todo.empty()) {
+        a = this->find(todo.back().first);
+        b = this->find(todo.back().second);
+        todo.pop_back();
+        if (a == b)
+            continue;
+
+        ++cntJoins_;
+        const int pa = pointee_[a];
+        const int pb = pointee_[b];
+
+        // union by rank
+        if (rank_[a] < rank_[b])
+            std::swap(a, b);
+        else if (rank_[a] == rank_[b])
+            ++rank_[a];
+
+        parent_[b] = a;
+
+        if (-1 == pa || -1 == pb) {
+            pointee_[a] = (-1 == pa) ? pb : pa;
+            continue;
+        }
+
+        pointee_[a] = pa;
+        todo.push_back(TPair(pa, pb));
+    }
+}
+
+class SteensBuilder {
+    public:
+        SteensBuilder(Storage &stor):
+            stor_(stor),
+            blackHole_(-1)
+        {
+        }
+
+        bool run();
+
+    private:
+        int ecrOfUid(cl_uid_t uid, Item *item);
+        int ecrOfVar(const Var &var);
+        int ecrOfRet(const Fnc &fnc);
+        int ecrOfHeap(const Insn &insn);
+        int blackHole();
+
+        int access(const cl_operand &op, bool *referenced);
+        void assign(int dst, const cl_operand &src);
+
+        bool handleCall(const Insn &insn);
+        bool handleInsn(const Fnc &fnc, const Insn &insn);
+
+        void materialize(Graph &ptg, const std::vector<int> &roots);
+
+    private:
+        typedef std::map<cl_uid_t, int>     TEcrByUid;
+
+        Storage                            &stor_;
+        EcrSet                              ecrs_;
+        TEcrByUid                           ecrByUid_;
+        int                                 blackHole_;
+
+        /// items of each class, filled in by run() once unification is done
+        std::vector<TItemList>              members_;
+};
+
+// register a new class for the given (not yet seen) uid
+int SteensBuilder::ecrOfUid(cl_uid_t uid, Item *item)
+{
+    CL_BREAK_IF(hasKey(ecrByUid_, uid));
+    const int ecr = ecrs_.add(item);
+    ecrByUid_[uid] = ecr;
+    return ecr;
+}
+
+int SteensBuilder::ecrOfVar(const Var &var)
+{
+    const TEcrByUid::const_iterator it = ecrByUid_.find(var.uid);
+    if (ecrByUid_.end() != it)
+        return it->second;
+
+    return this->ecrOfUid(var.uid, new Item(&var));
+}
+
+int SteensBuilder::ecrOfRet(const Fnc &fnc)
+{
+    const cl_uid_t uid = uidOf(fnc);
+    const TEcrByUid::const_iterator it = ecrByUid_.find(uid);
+    if (ecrByUid_.end() != it)
+        return it->second;
+
+    Item *item = new Item(PT_ITEM_RET);
+    item->data.fnc = &fnc;
+    return this->ecrOfUid(uid, item);
+}
+
+int SteensBuilder::ecrOfHeap(const Insn &insn)
+{
+    const cl_uid_t uid = -generateMallocUid(&insn);
+    const TEcrByUid::const_iterator it = ecrByUid_.find(uid);
+    if (ecrByUid_.end() != it)
+        return it->second;
+
+    Item *item = new Item(PT_ITEM_MALLOC);
+    item->data.mallocId = uid;
+    return this->ecrOfUid(uid, item);
+}
+
+// the class standing for anything an undefined function can touch
+int SteensBuilder::blackHole()
+{
+    if (-1 != blackHole_)
+        return blackHole_;
+
+    blackHole_ = ecrs_.add(/* anonymous */ 0);
+    ecrs_.join(ecrs_.pointee(blackHole_), blackHole_);
+
+    // an undefined function may access any of the global variables
+    for (const Var &var : stor_.vars)
+        if (VAR_GL == var.code)
+            ecrs_.join(this->ecrOfVar(var), blackHole_);
+
+    return blackHole_;
+}
+
+// the same semantics as nodeAccessS(), only working with classes
+int SteensBuilder::access(const cl_operand &op, bool *referenced)
+{
+    CL_BREAK_IF(CL_OPERAND_VAR != op.code);
+    int ecr = this->ecrOfVar(stor_.vars[varIdFromOperand(&op)]);
+    if (referenced)
+        *referenced = false;
+
+    for (const cl_accessor *ac = op.accessor; ac; ac = ac->next) {
+        switch (ac->code) {
+            case CL_ACCESSOR_DEREF:
+                ecr = ecrs_.pointee(ecr);
+                break;
+
+            case CL_ACCESSOR_ITEM:
+            case CL_ACCESSOR_OFFSET:
+            case CL_ACCESSOR_DEREF_ARRAY:
+                // field-insensitive
+                continue;
+
+            case CL_ACCESSOR_REF:
+                if (referenced)
+                    *referenced = true;
+                return ecr;
+        }
+    }
+
+    return ecr;
+}
+
+// dst = src, where dst is the class of the location being written
+void SteensBuilder::assign(int dst, const cl_operand &src)
+{
+    if (CL_OPERAND_VAR != src.code)
+        // constants do not create any points-to relation
+        return;
+
+    bool referenced;
+    const int ecrSrc = this->access(src, &referenced);
+    const int target = (referenced)
+        ? ecrSrc
+        : ecrs_.pointee(ecrSrc);
+
+    ecrs_.join(ecrs_.pointee(dst), target);
+}
+
+bool SteensBuilder::handleCall(const Insn &insn)
+{
+    const TOperandList &opList = insn.operands;
+    const cl_operand &retOp = opList[0];
+    const cl_operand &calleeOp = opList[1];
+
+    cl_uid_t calleeUid;
+    if (!fncUidFromOperand(&calleeUid, &calleeOp)) {
+        PT_ERROR("TODO: indirect call");
+        return false;
+    }
+
+    if (isBuiltInFnc(calleeOp))
+        return true;
+
+    const bool hasRet = (CL_OPERAND_VAR == retOp.code) && isPtrRelated(retOp);
+
+    const char *name = fncNameFromInsn(&insn);
+    if (name && STREQ(name, "malloc")) {
+        if (hasRet)
+            ecrs_.join(ecrs_.pointee(this->access(retOp, 0)),
+                    this->ecrOfHeap(insn));
+        return true;
+    }
+
+    if (isWhiteListed(&insn))
+        return true;
+
+    const Fnc &callee = *stor_.fncs[calleeUid];
+    const bool defined = isDefined(callee);
+    if (defined && opList.size() - 2 > callee.args.size()) {
+        PT_ERROR("TODO: bad number of parameters: " << insn
+                << " (" << callee.args.size() << " expected)");
+        return false;
+    }
+
+    // bind the actual parameters to the formal ones
+    for (unsigned i = 2; i < opList.size(); ++i) {
+        const cl_operand &op = opList[i];
+        if (!isPtrRelated(op) || isNull(op))
+            continue;
+
+        const int formal = (defined)
+            ? this->ecrOfVar(stor_.vars[callee.args[i - 2]])
+            : this->blackHole();
+
+        this->assign(formal, op);
+    }
+
+    if (!hasRet)
+        return true;
+
+    // bind the return value
+    const int dst = this->access(retOp, 0);
+    if (defined)
+        ecrs_.join(ecrs_.pointee(dst),
+                ecrs_.pointee(this->ecrOfRet(callee)));
+    else
+        ecrs_.join(ecrs_.pointee(dst), this->blackHole());
+
+    return true;
+}
+
+bool SteensBuilder::handleInsn(const Fnc &fnc, const Insn &insn)
+{
+    const TOperandList &opList = insn.operands;
+
+    switch (insn.code) {
+        case CL_INSN_CALL:
+            return this->handleCall(insn);
+
+        case CL_INSN_RET:
+            if (1 == opList.size() && isPtrRelated(opList[0]))
+                this->assign(this->ecrOfRet(fnc), opList[0]);
+            return true;
+
+        case CL_INSN_UNOP:
+        case CL_INSN_BINOP:
+            break;
+
+        default:
+            return true;
+    }
+
+    const cl_operand &dst = opList[0];
+    if (CL_OPERAND_VAR != dst.code)
+        return true;
+
+    // pointer arithmetic stays within the target and an assignment of
+    // a pointer to an integer (or vice versa) is followed conservatively
+    bool ptrRelated = isPtrRelated(dst);
+    for (unsigned i = 1; i < opList.size(); ++i)
+        ptrRelated |= isPtrRelated(opList[i]);
+
+    if (!ptrRelated)
+        return true;
+
+    if (CL_INSN_BINOP == insn.code && !isPtrRelated(dst))
+        // comparison of pointers or such
+        return true;
+
+    const int ecrDst = this->access(dst, 0);
+    for (unsigned i = 1; i < opList.size(); ++i)
+        this->assign(ecrDst, opList[i]);
+
+    return true;
+}
+
+// create one node per class reachable from roots and connect them
+void SteensBuilder::materialize(Graph &ptg, const std::vector<int> &roots)
+{
+    std::map<int, Node *> nodeByEcr;
+    std::vector<int> todo;
+
+    for (const int root : roots) {
+        const int ecr = ecrs_.find(root);
+        if (hasKey(nodeByEcr, ecr))
+            continue;
+
+        nodeByEcr[ecr] = 0;
+        todo.push_back(ecr);
+    }
+
+    for (unsigned i = 0; i < todo.size(); ++i) {
+        const int ecr = todo[i];
+        const int target = ecrs_.pointeeIfAny(ecr);
+        if (-1 == target || hasKey(nodeByEcr, target))
+            continue;
+
+        nodeByEcr[target] = 0;
+        todo.push_back(target);
+    }
+
+    for (const int ecr : todo) {
+        Node *node = new Node;
+        for (const Item *item : members_[ecr])
+            bindItem(ptg, node, item);
+
+        nodeByEcr[ecr] = node;
+    }
+
+    for (const int ecr : todo) {
+        const int target = ecrs_.pointeeIfAny(ecr);
+        if (-1 != target)
+            addEdge(nodeByEcr[ecr], nodeByEcr[target]);
+    }
+}
+
+bool SteensBuilder::run()
+{
+    for (const Fnc *pFnc : stor_.callGraph.topOrder) {
+        Fnc &fnc = *const_cast<Fnc *>(pFnc);
+        if (isBuiltInFnc(fnc.def))
+            continue;
+
+        if (!isDefined(fnc)) {
+            if (!isWhiteListed(&fnc))
+                makeBlackHole(fnc);
+
+            continue;
+        }
+
+        for (const Block *bb : fnc.cfg)
+            for (const Insn *insn : *bb)
+                if (!this->handleInsn(fnc, *insn))
+                    return false;
+    }
+
+    PT_DEBUG(1, "steensgaard: " << ecrs_.size() << " classes, "
+            << ecrs_.cntJoins() << " joins");
+
+    // collect the items of each class
+    const unsigned cnt = ecrs_.size();
+    members_.resize(cnt);
+    for (unsigned idx = 0; idx < cnt; ++idx) {
+        const Item *item = ecrs_.item(idx);
+        if (item)
+            members_[ecrs_.find(idx)].push_back(item);
+    }
+
+    // materialise the graphs of functions
+    std::vector<int> roots;
+    for (const Fnc *pFnc : stor_.callGraph.topOrder) {
+        Fnc &fnc = *const_cast<Fnc *>(pFnc);
+        if (!isDefined(fnc) || isBuiltInFnc(fnc.def))
+            continue;
+
+        roots.clear();
+        for (const cl_uid_t uid : fnc.vars) {
+            const TEcrByUid::const_iterator it = ecrByUid_.find(uid);
+            if (ecrByUid_.end() != it)
+                roots.push_back(it->second);
+        }
+
+        const TEcrByUid::const_iterator it = ecrByUid_.find(uidOf(fnc));
+        if (ecrByUid_.end() != it)
+            roots.push_back(it->second);
+
+        this->materialize(fnc.ptg, roots);
+    }
+
+    // materialise the global graph
+    roots.clear();
+    for (unsigned idx = 0; idx < cnt; ++idx) {
+        const Item *item = ecrs_.item(idx);
+        if (item && item->isGlobal())
+            roots.push_back(idx);
+    }
+
+    this->materialize(stor_.ptd.gptg, roots);
+    return true;
+}
+
+bool runSteensgaard(BuildCtx &ctx)
+{
+    SteensBuilder builder(ctx.stor);
+    return builder.run();
+}
+
+} /* namespace PointsTo */
+} /* namespace CodeStorage */
@@ -0,0 +1,42 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_CL_PT_STEENS_H
+#define H_GUARD_CL_PT_STEENS_H
+
+#include "pointsto.hh"
+
+namespace CodeStorage {
+namespace PointsTo {
+
+/**
+ * unification-based (Steensgaard-style) points-to analysis
+ *
+ * All instructions of the program are processed exactly once, each assignment
+ * unifies the targets of both sides in a union-find structure.  The resulting
+ * classes are then materialised into single-output graphs of the same shape
+ * as the FICS algorithm produces, so that the consumers need not care which of
+ * the algorithms has been used.
+ *
+ * @return false if the analysis has failed (the result is not usable then)
+ */
+bool runSteensgaard(BuildCtx &ctx);
+
+} /* namespace PointsTo */
+} /* namespace CodeStorage */
+
+#endif /* H_GUARD_CL_PT_STEENS_H */
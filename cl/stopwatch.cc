@@ -18,21 +18,32 @@
  */
 
 #include "stopwatch.hh"
+#include <cl/timeline.hh>
 #include <iomanip>
 #include <time.h>
 
 struct StopWatch::Private {
     clock_t start;
+    const char *name;
+    double timelineStart;
 };
 
-StopWatch::StopWatch():
+StopWatch::StopWatch(const char *name):
     d(new Private)
 {
+    d->name = name;
+    d->timelineStart = (name && Timeline::enabled())
+        ? Timeline::now()
+        : -1.0;
+
     this->reset();
 }
 
 StopWatch::~StopWatch()
 {
+    if (0.0 <= d->timelineStart)
+        Timeline::record(d->name, d->timelineStart);
+
     delete d;
 }
 
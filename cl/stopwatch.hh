@@ -24,7 +24,8 @@
 
 class StopWatch {
     public:
-        StopWatch();
+        /// if a name is given, the lifetime is recorded in the Timeline
+        explicit StopWatch(const char *name = 0);
         ~StopWatch();
 
         void reset();
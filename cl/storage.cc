@@ -21,13 +21,18 @@
 
 #include <cl/storage.hh>
 #include <cl/cl_msg.hh>
+#include <cl/clutil.hh>
 
 #include "cl_storage.hh"
 #include "util.hh"
 
+#include <algorithm>
 #include <cstddef>
 #include <map>
 #include <stack>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 namespace CodeStorage {
 
@@ -148,7 +153,7 @@ bool isOnStack(const Var &var)
 // /////////////////////////////////////////////////////////////////////////////
 // VarDb implementation
 struct VarDb::Private {
-    typedef std::map<cl_uid_t, unsigned> TMap;
+    typedef std::unordered_map<cl_uid_t, unsigned> TMap;
     TMap db;
 };
 
@@ -183,6 +188,10 @@ struct TypeDb::Private {
     typedef std::map<cl_uid_t, const struct cl_type *> TMap;
     TMap db;
 
+    /// canonical IDs indexed by UIDs of types, -1 for UIDs not seen
+    typedef std::vector<int> TCanonList;
+    TCanonList canon;
+
     int codePtrSizeof;
     int dataPtrSizeof;
     const struct cl_type *genericDataPtr;
@@ -203,8 +212,22 @@ TypeDb::TypeDb():
 {
 }
 
+/// canonical IDs queried by canonTypeId(), set by TypeDb::canonicalize()
+static const std::vector<int> *canonTypeIds;
+
+static inline int canonIdLookup(const std::vector<int> &canon, cl_uid_t uid)
+{
+    if (uid < 0 || canon.size() <= static_cast<size_t>(uid))
+        return -1;
+
+    return canon[uid];
+}
+
 TypeDb::~TypeDb()
 {
+    if (&d->canon == canonTypeIds)
+        canonTypeIds = 0;
+
     delete d;
 }
 
@@ -271,6 +294,116 @@ const struct cl_type* TypeDb::genericDataPtr() const
     return d->genericDataPtr;
 }
 
+/// key of the initial partition, covers everything operator==() looks at
+typedef std::pair<std::vector<long>, std::vector<std::string> > TTypeKey;
+
+static void initialTypeKey(TTypeKey *pKey, const struct cl_type *clt)
+{
+    std::vector<long> &nums = pKey->first;
+    nums.push_back(clt->code);
+    nums.push_back(clt->item_cnt);
+
+    switch (clt->code) {
+        case CL_TYPE_VOID:
+        case CL_TYPE_INT:
+        case CL_TYPE_CHAR:
+        case CL_TYPE_BOOL:
+        case CL_TYPE_REAL:
+        case CL_TYPE_ENUM:
+            nums.push_back(clt->size);
+            nums.push_back(clt->is_unsigned);
+            break;
+
+        case CL_TYPE_UNKNOWN:
+        case CL_TYPE_STRING:
+            // never equal to anything but itself
+            nums.push_back(clt->uid);
+            break;
+
+        default:
+            break;
+    }
+
+    for (int i = 0; i < clt->item_cnt; ++i) {
+        const char *name = clt->items[i].name;
+        nums.push_back(!!name);
+        pKey->second.push_back((name) ? name : "");
+    }
+}
+
+void TypeDb::canonicalize()
+{
+    const unsigned cnt = types_.size();
+    std::unordered_map<cl_uid_t, unsigned> idxByUid;
+    for (unsigned i = 0; i < cnt; ++i)
+        idxByUid[types_[i]->uid] = i;
+
+    // initial partition by the properties of the types themselves
+    std::vector<int> cls(cnt);
+    std::map<TTypeKey, int> keys;
+    for (unsigned i = 0; i < cnt; ++i) {
+        TTypeKey key;
+        initialTypeKey(&key, types_[i]);
+        const int id = keys.size();
+        cls[i] = keys.insert(std::make_pair(key, id)).first->second;
+    }
+
+    // refine the partition by classes of the nested types until it stabilises
+    size_t cntClasses = keys.size();
+    for (;;) {
+        typedef std::vector<int> TSig;
+        std::map<TSig, int> sigs;
+        std::vector<int> next(cnt);
+
+        for (unsigned i = 0; i < cnt; ++i) {
+            const struct cl_type *clt = types_[i];
+
+            TSig sig(1, cls[i]);
+            for (int n = 0; n < clt->item_cnt; ++n) {
+                const struct cl_type *sub = clt->items[n].type;
+                int subCls = -1;
+                if (sub) {
+                    // readTypeTree() inserts the whole type graph
+                    CL_BREAK_IF(!hasKey(idxByUid, sub->uid));
+                    subCls = cls[idxByUid[sub->uid]];
+                }
+                sig.push_back(subCls);
+            }
+
+            const int id = sigs.size();
+            next[i] = sigs.insert(std::make_pair(sig, id)).first->second;
+        }
+
+        cls.swap(next);
+        if (sigs.size() == cntClasses)
+            break;
+
+        cntClasses = sigs.size();
+    }
+
+    cl_uid_t maxUid = -1;
+    for (const struct cl_type *clt : types_)
+        maxUid = std::max(maxUid, clt->uid);
+
+    Private::TCanonList &canon = d->canon;
+    canon.assign(maxUid + 1, -1);
+    for (unsigned i = 0; i < cnt; ++i) {
+        const cl_uid_t uid = types_[i]->uid;
+        if (0 <= uid)
+            canon[uid] = cls[i];
+    }
+
+    CL_DEBUG("TypeDb::canonicalize() reduced " << cnt << " types to "
+            << cntClasses << " canonical IDs");
+
+    canonTypeIds = &canon;
+}
+
+int TypeDb::canonId(cl_uid_t uid) const
+{
+    return canonIdLookup(d->canon, uid);
+}
+
 void readTypeTree(TypeDb &db, const struct cl_type *clt)
 {
     if (!clt) {
@@ -608,3 +741,12 @@ const Fnc* fncByCfg(const ControlFlow *pCfg)
 }
 
 } // namespace CodeStorage
+
+int canonTypeId(const struct cl_type *clt)
+{
+    using CodeStorage::canonTypeIds;
+    if (!canonTypeIds)
+        return -1;
+
+    return CodeStorage::canonIdLookup(*canonTypeIds, clt->uid);
+}
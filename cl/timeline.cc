@@ -0,0 +1,186 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config_cl.h"
+#include <cl/timeline.hh>
+
+#include <cl/cl_msg.hh>
+#include <cl/json.hh>
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+#include <time.h>
+#include <unistd.h>
+
+namespace Timeline {
+
+/// phases shorter than this (in microseconds) are only counted, not recorded
+static const double minDuration = 50.0;
+
+struct Event {
+    std::string                 name;
+    double                      start;
+    double                      dur;
+};
+
+/// count and total duration of phases of the same name
+struct Totals {
+    unsigned long               cnt;
+    double                      dur;
+
+    Totals():
+        cnt(0UL),
+        dur(0.0)
+    {
+    }
+};
+
+static bool                                 isEnabled;
+static std::string                          fileName;
+static double                               epoch;
+static std::vector<Event>                   events;
+static std::map<const char *, Totals>       totalsByLiteral;
+static std::map<std::string, Totals>        totalsByName;
+
+bool enabled()
+{
+    return isEnabled;
+}
+
+double wallClock()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+void enableByConfig(const std::string &configString)
+{
+    static const std::string opt = "timeline";
+
+    std::string::size_type pos = 0;
+    while (pos <= configString.size()) {
+        std::string::size_type end = configString.find(',', pos);
+        if (std::string::npos == end)
+            end = configString.size();
+
+        const std::string item = configString.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (item == opt)
+            fileName = "timeline.json";
+        else if (!item.compare(0, opt.size() + 1, opt + ":"))
+            fileName = item.substr(opt.size() + 1);
+        else
+            continue;
+
+        if (fileName.empty())
+            fileName = "timeline.json";
+
+        epoch = wallClock();
+        isEnabled = true;
+    }
+}
+
+double now()
+{
+    return 1e6 * (wallClock() - epoch);
+}
+
+void record(const char *name, const double start)
+{
+    const double dur = now() - start;
+
+    // phases named by string literals are counted without any allocation
+    Totals &tot = totalsByLiteral[name];
+    tot.cnt += 1UL;
+    tot.dur += dur;
+
+    if (dur < minDuration)
+        return;
+
+    const Event ev = { name, start, dur };
+    events.push_back(ev);
+}
+
+void record(const std::string &name, const double start)
+{
+    const double dur = now() - start;
+
+    Totals &tot = totalsByName[name];
+    tot.cnt += 1UL;
+    tot.dur += dur;
+
+    if (dur < minDuration)
+        return;
+
+    const Event ev = { name, start, dur };
+    events.push_back(ev);
+}
+
+void dump()
+{
+    if (!isEnabled)
+        return;
+
+    std::fstream str(fileName.c_str(), std::ios::out);
+    if (!str) {
+        CL_ERROR("unable to create file '" << fileName << "'");
+        return;
+    }
+
+    const int pid = getpid();
+    str << std::fixed << std::setprecision(3)
+        << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+    const char *sep = "\n";
+    for (const Event &ev : events) {
+        str << sep << "  {\"name\": " << JsonStr(ev.name)
+            << ", \"ph\": \"X\", \"pid\": " << pid << ", \"tid\": " << pid
+            << ", \"ts\": " << ev.start << ", \"dur\": " << ev.dur << "}";
+        sep = ",\n";
+    }
+
+    // totals including the short phases that have not been recorded
+    str << sep << "  {\"name\": \"totals\", \"ph\": \"i\", \"s\": \"g\""
+        << ", \"pid\": " << pid << ", \"tid\": " << pid
+        << ", \"ts\": " << now() << ", \"args\": {";
+
+    std::map<std::string, Totals> totals = totalsByName;
+    for (const std::pair<const char *const, Totals> &item : totalsByLiteral) {
+        Totals &tot = totals[item.first];
+        tot.cnt += item.second.cnt;
+        tot.dur += item.second.dur;
+    }
+
+    sep = "";
+    for (const std::pair<const std::string, Totals> &item : totals) {
+        str << sep << JsonStr(item.first)
+            << ": {\"count\": " << item.second.cnt
+            << ", \"total_us\": " << item.second.dur << "}";
+        sep = ", ";
+    }
+
+    str << "}}\n]}\n";
+    CL_NOTE("timeline of " << events.size() << " phases written to '"
+            << fileName << "'");
+}
+
+} // namespace Timeline
@@ -24,9 +24,12 @@
 #include <cl/clutil.hh>
 #include <cl/storage.hh>
 
+#include <algorithm>
 #include <map>
 #include <queue>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 // required by the gcc plug-in API
 extern "C" {
@@ -43,6 +46,7 @@ enum EVarState {
     VS_NULL_DEDUCED,            ///< value is guaranteed to be NULL
     VS_NOT_NULL_DEDUCED,        ///< value is guaranteed to be not-NULL
     VS_MIGHT_BE_NULL,
+    VS_MIGHT_BE_NULL_RET,       ///< returned by a fnc that might return NULL
 
     VS_FALSE,                   ///< value is 'false', valid only for booleans
     VS_TRUE,                    ///< value is 'true', valid only for booleans
@@ -51,7 +55,7 @@ enum EVarState {
     VS_NOT_NULL_IFF             ///< if true, peer is not-NULL and vice versa
 };
 
-typedef int                                             TVar;
+typedef int                                             TVar;   ///< var idx
 typedef const struct cl_loc                            *TLoc;
 typedef const struct cl_operand                         TOperand;
 typedef const CodeStorage::TOperandList                 TOperandList;
@@ -73,38 +77,215 @@ struct VarState {
     }
 };
 
-typedef std::map<TVar, VarState>                        TState;
+/// state of all variables of a function (scope of its validity is basic block)
+struct BlockState {
+    /// states of variables indexed by the dense index TVar
+    std::vector<VarState>   vars;
+
+    /// per each argument, where it is dereferenced on all paths (0 if not)
+    std::vector<TLoc>       argDeref;
+
+    /// false until some state has been propagated to the block
+    bool                    reached;
+
+    BlockState():
+        reached(false)
+    {
+    }
+
+    VarState& operator[](const TVar idx) {
+        return vars[idx];
+    }
+};
+
+typedef BlockState                                      TState;
+
+/// what callers need to know about a function
+struct FncSummary {
+    /// per each argument, where it is dereferenced on all paths (0 if not)
+    std::vector<TLoc>       argDeref;
+
+    /// where the function returns a value that might be NULL (0 if nowhere)
+    TLoc                    retMayBeNull;
+
+    /// false until a return instruction of the function has been reached
+    bool                    returns;
+
+    FncSummary():
+        retMayBeNull(0),
+        returns(false)
+    {
+    }
+};
+
+typedef std::map<cl_uid_t, FncSummary>                  TSummaryMap;
+
+/// true if both summaries tell the callers the same (locations do not matter)
+bool operator==(const FncSummary &a, const FncSummary &b)
+{
+    if (a.returns != b.returns || !a.retMayBeNull != !b.retMayBeNull)
+        return false;
+
+    const unsigned cnt = a.argDeref.size();
+    if (b.argDeref.size() != cnt)
+        return false;
+
+    for (unsigned pos = 0; pos < cnt; ++pos)
+        if (!a.argDeref[pos] != !b.argDeref[pos])
+            return false;
+
+    return true;
+}
+
+enum EMsgKind {
+    MK_ERROR,
+    MK_WARN,
+    MK_NOTE
+};
+
+/// a diagnostic message recorded while computing the fixed-point
+struct Message {
+    EMsgKind            kind;
+    TLoc                loc;
+    const char         *text;
+
+    Message(EMsgKind kind_, TLoc loc_, const char *text_):
+        kind(kind_),
+        loc(loc_),
+        text(text_)
+    {
+    }
+};
+
+typedef std::vector<Message>                            TMsgList;
 
 /// state of computation at function level
 struct Data {
     typedef std::queue<TBlock>                          TSched;
     typedef std::set<TBlock>                            TSchedLookup;
     typedef std::map<TBlock, TState>                    TStateMap;
+    typedef std::map<TBlock, TMsgList>                  TMsgMap;
+    typedef std::unordered_map<cl_uid_t, TVar>          TIdxMap;
 
     TSched          todo;       ///< block scheduled for processing
     TSchedLookup    todoLookup; ///< block scheduled for processing
     TStateMap       stateMap;   ///< holds states of all vars per each block
     TState          localState; ///< holds intermediate state between insns
-    bool            silent;     ///< if true, do not print diagnostic messages
+    TState          initState;  ///< state of all vars on entry of the fnc
+    TMsgMap         msgMap;     ///< messages from the last run of each block
+    TMsgList       *msgs;       ///< messages of the block being processed
 
-    Data():
-        silent(true)
-    {
+    const CodeStorage::VarDb &vars; ///< all variables of the program
+    TVar            cntLocals;  ///< locals are indexed by Var::denseIdx
+    TIdxMap         idxByGlUid; ///< indexes of gl variables (behind locals)
+    std::vector<int> argByIdx;  ///< position among args, -1 for other vars
+
+    const TSummaryMap &summaries;   ///< summaries of the fncs analysed so far
+    FncSummary     &summary;    ///< summary of the current function
+
+    Data(const CodeStorage::Fnc &fnc, const TSummaryMap &summaries_,
+            FncSummary &summary_);
+
+    TVar varIdx(const cl_uid_t uid) const {
+        const CodeStorage::Var &var = vars[uid];
+        if (isOnStack(var))
+            return var.denseIdx;
+
+        const TIdxMap::const_iterator it = idxByGlUid.find(uid);
+        CL_BREAK_IF(idxByGlUid.end() == it);
+        return it->second;
+    }
+
+    TVar varIdx(TOperand *op) const {
+        return this->varIdx(varIdFromOperand(op));
+    }
+
+    void emit(EMsgKind kind, TLoc loc, const char *text) {
+        msgs->push_back(Message(kind, loc, text));
     }
 };
 
+/// return true if the given argument of the function is ever written to
+bool isArgWritten(const CodeStorage::Fnc &fnc, const cl_uid_t uid)
+{
+    for (const TBlock bb : fnc.cfg) {
+        for (const TInsn insn : *bb) {
+            for (unsigned i = 0; i < insn->operands.size(); ++i) {
+                TOperand &op = insn->operands[i];
+                if (CL_OPERAND_VAR != op.code || uid != varIdFromOperand(&op))
+                    continue;
+
+                if (seekRefAccessor(op.accessor))
+                    // address of the argument taken
+                    return true;
+
+                if (!i && !op.accessor && !cl_is_term_insn(insn->code))
+                    // the argument is the destination operand
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+Data::Data(
+        const CodeStorage::Fnc     &fnc,
+        const TSummaryMap          &summaries_,
+        FncSummary                 &summary_):
+    msgs(0),
+    vars(fnc.stor->vars),
+    cntLocals(0),
+    summaries(summaries_),
+    summary(summary_)
+{
+    // variables on stack are numbered densely by CodeStorage already
+    for (const cl_uid_t uid : fnc.vars) {
+        const CodeStorage::Var &var = vars[uid];
+        if (isOnStack(var) && cntLocals <= var.denseIdx)
+            cntLocals = var.denseIdx + 1;
+    }
+
+    // gl variables used by the function go behind them
+    TVar cnt = cntLocals;
+    for (const cl_uid_t uid : fnc.vars)
+        if (!isOnStack(vars[uid]))
+            idxByGlUid[uid] = cnt++;
+
+    argByIdx.resize(cnt, -1);
+    const unsigned cntArgs = fnc.args.size();
+    for (unsigned pos = 0; pos < cntArgs; ++pos) {
+        const cl_uid_t uid = fnc.args[pos];
+        if (!fnc.vars.count(uid) || isArgWritten(fnc, uid))
+            // only the values passed by the caller are of our interest
+            continue;
+
+        argByIdx[this->varIdx(uid)] = pos;
+    }
+
+    summary.argDeref.resize(cntArgs, 0);
+
+    // all variables are undefined on entry of the function
+    initState.vars.resize(cnt);
+    initState.argDeref.resize(cntArgs, 0);
+    initState.reached = true;
+}
+
 /**
  * @param data state of computation per current function
  * @param op either source or destination operand that contains a dereference
  * @param loc location info of the current instruction
+ * @param calleeLoc where the value is dereferenced by the called function if
+ * it is passed to a function, NULL for a dereference in the current function
  */
 void handleVarDeref(
         Data                       &data,
         TOperand                   *op,
-        const TLoc                  loc)
+        const TLoc                  loc,
+        const TLoc                  calleeLoc = 0)
 {
-    const TVar uid = varIdFromOperand(op);
-    VarState &vs = data.localState[uid];
+    const TVar idx = data.varIdx(op);
+    VarState &vs = data.localState[idx];
     const EVarState code = vs.code;
     switch (code) {
         case VS_UNDEF:
@@ -116,33 +297,56 @@ void handleVarDeref(
         case VS_NOT_NULL:
         case VS_NOT_NULL_DEDUCED:
         case VS_DEREF:
-            return;
+            break;
 
         default:
-            break;
+            goto report;
     }
 
-    if (data.silent)
-        return;
+    if (VS_DEREF == vs.code && -1 != data.argByIdx[idx]) {
+        // the value passed by the caller is dereferenced on this path
+        TLoc &argLoc = data.localState.argDeref[data.argByIdx[idx]];
+        if (!argLoc)
+            argLoc = loc;
+    }
+
+    return;
 
+report:
     switch (code) {
         case VS_NULL:
-            CL_ERROR_MSG(loc, "dereference of NULL value");
-            CL_NOTE_MSG(vs.loc, "the NULL value comes from here");
-            return;
+            data.emit(MK_ERROR, loc, "dereference of NULL value");
+            data.emit(MK_NOTE, vs.loc, "the NULL value comes from here");
+            break;
 
         case VS_NULL_DEDUCED:
-            CL_ERROR_MSG(loc, "dereference of NULL value");
-            CL_NOTE_MSG(vs.loc, "the condition seems to be used incorrectly");
+            data.emit(MK_ERROR, loc, "dereference of NULL value");
+            data.emit(MK_NOTE, vs.loc,
+                    "the condition seems to be used incorrectly");
+            // fall through!
 
         case VS_MIGHT_BE_NULL:
-            CL_WARN_MSG(loc, "dereference of a value that might be NULL");
-            CL_NOTE_MSG(vs.loc, "the same value was compared with NULL here");
-            return;
+            data.emit(MK_WARN, loc,
+                    "dereference of a value that might be NULL");
+            data.emit(MK_NOTE, vs.loc,
+                    "the same value was compared with NULL here");
+            break;
+
+        case VS_MIGHT_BE_NULL_RET:
+            data.emit(MK_WARN, loc,
+                    "dereference of a value that might be NULL");
+            data.emit(MK_NOTE, vs.loc, "the value is returned by a function"
+                    " that might return NULL");
+            break;
 
         default:
             CL_BREAK_IF("invalid call of handleVarDeref()");
+            return;
     }
+
+    if (calleeLoc)
+        data.emit(MK_NOTE, calleeLoc,
+                "the called function dereferences it here");
 }
 
 /**
@@ -235,8 +439,7 @@ void handleInsnUnop(Data &data, const TInsn insn)
         return;
 
     // resolve state of the variable
-    const TVar uid = varIdFromOperand(&dst);
-    VarState &vs = data.localState[uid];
+    VarState &vs = data.localState[data.varIdx(&dst)];
 
     const enum cl_unop_e code = static_cast<enum cl_unop_e>(insn->subCode);
     if (CL_UNOP_ASSIGN != code) {
@@ -275,8 +478,7 @@ void handleInsnUnop(Data &data, const TInsn insn)
     }
 
     // single assignment ... let's just propagate the value
-    const TVar uidSrc = varIdFromOperand(&src);
-    mergeValues(vs, data.localState[uidSrc]);
+    mergeValues(vs, data.localState[data.varIdx(&src)]);
 }
 
 /**
@@ -302,8 +504,8 @@ bool handleInsnCmpNull(
         // we're interested only in pointers comparison here
         return false;
 
-    const TVar uidSrc = varIdFromOperand(src);
-    const VarState &vsSrc = data.localState[uidSrc];
+    const TVar idxSrc = data.varIdx(src);
+    const VarState &vsSrc = data.localState[idxSrc];
     const EVarState code = vsSrc.code;
     switch (code) {
         case VS_NULL:
@@ -318,13 +520,13 @@ bool handleInsnCmpNull(
         case VS_UNDEF:
         case VS_UNKNOWN:
         case VS_MIGHT_BE_NULL:
+        case VS_MIGHT_BE_NULL_RET:
             break;
 
         case VS_DEREF:
-            if (data.silent)
-                break;
-            CL_WARN_MSG(loc, "comparing pointer with NULL");
-            CL_NOTE_MSG(vsSrc.loc, "the pointer was already dereferenced here");
+            data.emit(MK_WARN, loc, "comparing pointer with NULL");
+            data.emit(MK_NOTE, vsSrc.loc,
+                    "the pointer was already dereferenced here");
             break;
 
         default:
@@ -336,7 +538,7 @@ bool handleInsnCmpNull(
         ? VS_NOT_NULL_IFF
         : VS_NULL_IFF;
 
-    vsDst.peer = uidSrc;
+    vsDst.peer = idxSrc;
     vsDst.loc  = loc;
     return true;
 
@@ -371,8 +573,7 @@ void handleInsnBinop(Data &data, const TInsn insn)
     // resolve operands
     TOperand &dst = opList[0];
     CL_BREAK_IF(dst.accessor);
-    const TVar uidDst = varIdFromOperand(&dst);
-    VarState &vs = data.localState[uidDst];
+    VarState &vs = data.localState[data.varIdx(&dst)];
 
     TOperand &src1 = opList[1];
     TOperand &src2 = opList[2];
@@ -417,6 +618,49 @@ who_knows:
     vs.code = VS_UNKNOWN;
 }
 
+/// return true if the operand is a NULL pointer constant
+bool isNullCst(TOperand &op)
+{
+    return CL_OPERAND_CST == op.code
+        && CL_TYPE_PTR == op.type->code
+        && CL_TYPE_INT == op.data.cst.code
+        && !intCstFromOperand(&op);
+}
+
+/**
+ * check the arguments of a call against the summary of the called function
+ * @param data state of computation per current function
+ * @param insn call instruction
+ * @param summary summary of the called function
+ */
+void handleCallArgs(Data &data, const TInsn insn, const FncSummary &summary)
+{
+    const TOperandList &opList = insn->operands;
+    const unsigned cntArgs = summary.argDeref.size();
+    for (unsigned pos = 0; pos < cntArgs && pos + 2 < opList.size(); ++pos) {
+        const TLoc calleeLoc = summary.argDeref[pos];
+        if (!calleeLoc)
+            // not dereferenced on all paths through the called function
+            continue;
+
+        TOperand &op = opList[pos + /* dst, fnc */ 2];
+        if (isNullCst(op)) {
+            data.emit(MK_ERROR, &insn->loc,
+                    "NULL value passed to a function that dereferences it");
+            data.emit(MK_NOTE, calleeLoc,
+                    "the called function dereferences it here");
+            continue;
+        }
+
+        if (CL_OPERAND_VAR != op.code || op.accessor
+                || CL_TYPE_PTR != op.type->code)
+            // we're interested only in direct manipulation of variables here
+            continue;
+
+        handleVarDeref(data, &op, &insn->loc, calleeLoc);
+    }
+}
+
 /**
  * process call instruction
  * @param data state of computation per current function
@@ -424,6 +668,19 @@ who_knows:
  */
 void handleInsnCall(Data &data, const TInsn insn)
 {
+    // look for the summary of the called function (if analysed already), in
+    // case of recursion it comes from the previous round over the component
+    const FncSummary *summary = 0;
+    cl_uid_t uid;
+    if (fncUidFromOperand(&uid, &insn->operands[/* fnc */ 1])) {
+        const TSummaryMap::const_iterator it = data.summaries.find(uid);
+        if (data.summaries.end() != it && it->second.returns)
+            summary = &it->second;
+    }
+
+    if (summary)
+        handleCallArgs(data, insn, *summary);
+
     TOperand &dst = insn->operands[0];
     if (dst.accessor)
         // we're interested only in direct manipulation of variables here
@@ -432,9 +689,14 @@ void handleInsnCall(Data &data, const TInsn insn)
     if (CL_OPERAND_VAR != dst.code)
         return;
 
+    VarState &vs = data.localState[data.varIdx(&dst)];
+    if (summary && summary->retMayBeNull && CL_TYPE_PTR == dst.type->code) {
+        vs.code = VS_MIGHT_BE_NULL_RET;
+        vs.loc  = &insn->loc;
+        return;
+    }
+
     // abstract out the return value
-    const TVar uid = varIdFromOperand(&dst);
-    VarState &vs = data.localState[uid];
     vs.code = VS_UNKNOWN;
 }
 
@@ -444,7 +706,7 @@ void handleInsnCall(Data &data, const TInsn insn)
  * @param opList list of operands to check for direct references
  */
 void treatRefAsSideEffect(
-        TState                     &state,
+        Data                       &data,
         TOperandList               &opList)
 {
     // for each operand
@@ -459,8 +721,7 @@ void treatRefAsSideEffect(
             continue;
 
         // kill any up to now reasoning about the variable
-        const TVar uid = varIdFromOperand(&op);
-        state[uid].code = VS_UNKNOWN;
+        data.localState[data.varIdx(&op)].code = VS_UNKNOWN;
     }
 }
 
@@ -471,7 +732,7 @@ void treatRefAsSideEffect(
  */
 void handleInsnNonterm(Data &data, const TInsn insn)
 {
-    treatRefAsSideEffect(data.localState, insn->operands);
+    treatRefAsSideEffect(data, insn->operands);
 
     const enum cl_insn_e code = insn->code;
     switch (code) {
@@ -510,11 +771,29 @@ void updateState(
 {
     // target state
     TState &dstState = data.stateMap[block];
+    bool changed = false;
+    if (!dstState.reached) {
+        dstState.vars.resize(state.vars.size());
+        dstState.argDeref = state.argDeref;
+        dstState.reached = true;
+        changed = true;
+    }
+    else {
+        // an argument is dereferenced only if it is so along all paths
+        const unsigned cntArgs = state.argDeref.size();
+        for (unsigned pos = 0; pos < cntArgs; ++pos) {
+            if (state.argDeref[pos] || !dstState.argDeref[pos])
+                continue;
+
+            dstState.argDeref[pos] = 0;
+            changed = true;
+        }
+    }
 
     // for each variable
-    bool changed = false;
-    for (TState::const_reference item : state) {
-        if (mergeValues(dstState[item.first], item.second))
+    const unsigned cntVars = state.vars.size();
+    for (TVar idx = 0; idx < static_cast<TVar>(cntVars); ++idx) {
+        if (mergeValues(dstState[idx], state.vars[idx]))
             changed = true;
     }
 
@@ -526,12 +805,12 @@ void updateState(
  * replace state of the branch-by variable by VS_NULL_DEDUCED or
  * VS_NOT_NULL_DEDUCED
  * @param state state valid per current instruction
- * @param uid CodeStorage uid of the branch-by variable
+ * @param idx dense index of the branch-by variable
  * @param val true in 'then' branch, false in 'else' branch
  */
-void replaceInBranch(TState &state, const TVar uid, bool val)
+void replaceInBranch(TState &state, const TVar idx, bool val)
 {
-    VarState &vs = state[uid];
+    VarState &vs = state[idx];
     bool isNull;
 
     const EVarState code = vs.code;
@@ -582,9 +861,9 @@ void handleInsnCondNondet(
     TState stateElse(state);
 
     // reflect the value of branch-by variable (if possible)
-    const TVar uid = varIdFromOperand(&cond);
-    replaceInBranch(stateThen, uid, true);
-    replaceInBranch(stateElse, uid, false);
+    const TVar idx = data.varIdx(&cond);
+    replaceInBranch(stateThen, idx, true);
+    replaceInBranch(stateElse, idx, false);
 
     // go to both targets and update the state there
     updateState(data, stateThen, targets[0]);
@@ -602,8 +881,7 @@ void handleInsnCond(
     // resolve branch-by operand
     TOperand &cond = insn->operands[0];
     TState &state = data.localState;
-    const TVar uid = varIdFromOperand(&cond);
-    const VarState &vs = state[uid];
+    const VarState &vs = state[data.varIdx(&cond)];
 
     // now check if we know the value
     const EVarState code = vs.code;
@@ -622,6 +900,54 @@ void handleInsnCond(
     }
 }
 
+/**
+ * update the summary of the current function by the state at its return
+ * @param data state of computation per current function
+ * @param insn return instruction
+ */
+void handleInsnRet(Data &data, const TInsn insn)
+{
+    FncSummary &summary = data.summary;
+    const TState &state = data.localState;
+
+    // arguments dereferenced along all paths reaching a return
+    const unsigned cntArgs = state.argDeref.size();
+    for (unsigned pos = 0; pos < cntArgs; ++pos)
+        if (!summary.returns)
+            summary.argDeref[pos] = state.argDeref[pos];
+        else if (!state.argDeref[pos])
+            summary.argDeref[pos] = 0;
+
+    summary.returns = true;
+
+    if (insn->operands.empty() || summary.retMayBeNull)
+        return;
+
+    TOperand &src = insn->operands[0];
+    if (CL_OPERAND_VOID == src.code || CL_TYPE_PTR != src.type->code)
+        return;
+
+    if (isNullCst(src)) {
+        summary.retMayBeNull = &insn->loc;
+        return;
+    }
+
+    if (CL_OPERAND_VAR != src.code || src.accessor)
+        return;
+
+    switch (data.localState[data.varIdx(&src)].code) {
+        case VS_NULL:
+        case VS_NULL_DEDUCED:
+        case VS_MIGHT_BE_NULL:
+        case VS_MIGHT_BE_NULL_RET:
+            summary.retMayBeNull = &insn->loc;
+            break;
+
+        default:
+            break;
+    }
+}
+
 /**
  * process a terminal instruction
  * @param data state of computation per current function
@@ -643,6 +969,9 @@ void handleInsnTerm(
             return;
 
         case CL_INSN_RET:
+            handleInsnRet(data, insn);
+            return;
+
         case CL_INSN_ABORT:
             // we're not interested in such instructions here
             return;
@@ -654,8 +983,15 @@ void handleInsnTerm(
 
 void handleBlock(Data &data, const TBlock bb)
 {
+    // messages from a previous run of the block are obsolete now
+    data.msgs = &data.msgMap[bb];
+    data.msgs->clear();
+
     // go through the sequence of instructions of the current basic block
-    data.localState = data.stateMap[bb];
+    const TState &state = data.stateMap[bb];
+    data.localState = (state.reached)
+        ? state
+        : data.initState;
     for (const TInsn insn : *bb) {
         if (cl_is_term_insn(insn->code))
             // terminal instruction
@@ -667,14 +1003,26 @@ void handleBlock(Data &data, const TBlock bb)
     }
 }
 
-void handleFnc(const CodeStorage::Fnc &fnc)
+/**
+ * compute fixed-point of the function, its summary and collect messages
+ * @param fnc function to analyse
+ * @param summaries summaries of the functions analysed so far
+ * @param summary destination for the summary of the function
+ * @param msgs destination list for the messages issued for the function
+ */
+void handleFnc(
+        const CodeStorage::Fnc     &fnc,
+        const TSummaryMap          &summaries,
+        FncSummary                 &summary,
+        TMsgList                   &msgs)
 {
-    Data data;
+    Data data(fnc, summaries, summary);
     Data::TSched &todo = data.todo;
     const CodeStorage::ControlFlow &cfg = fnc.cfg;
 
     // block-level scheduler
     TBlock bb = cfg.entry();
+    data.stateMap[bb] = data.initState;
     todo.push(bb);
     data.todoLookup.insert(bb);
     while (!todo.empty()) {
@@ -690,26 +1038,177 @@ void handleFnc(const CodeStorage::Fnc &fnc)
         handleBlock(data, bb);
     }
 
-    // finally report all errors/warning over the already computed fixed-point
-    data.silent = false;
+    // messages are recorded during the fixed-point computation, they only
+    // have to be produced for blocks unreachable from the entry
     for (const TBlock bb : cfg)
-        handleBlock(data, bb);
+        if (!data.msgMap.count(bb))
+            handleBlock(data, bb);
+
+    for (const TBlock bb : cfg) {
+        const TMsgList &bbMsgs = data.msgMap[bb];
+        msgs.insert(msgs.end(), bbMsgs.begin(), bbMsgs.end());
+    }
 }
 
-// /////////////////////////////////////////////////////////////////////////////
-// see easy.hh for details
-void clEasyRun(const CodeStorage::Storage &stor, const char *)
+void printMessages(const TMsgList &msgs)
 {
-    using namespace CodeStorage;
+    for (const Message &msg : msgs) {
+        switch (msg.kind) {
+            case MK_ERROR:
+                CL_ERROR_MSG(msg.loc, msg.text);
+                break;
+
+            case MK_WARN:
+                CL_WARN_MSG(msg.loc, msg.text);
+                break;
+
+            case MK_NOTE:
+                CL_NOTE_MSG(msg.loc, msg.text);
+                break;
+        }
+    }
+}
+
+/// strongly connected components of the call graph by Tarjan's algorithm
+class SccFinder {
+    public:
+        typedef CodeStorage::TFncList                   TScc;
+        typedef std::vector<TScc>                       TSccList;
+
+        /// components are appended in the bottom-up order (callees first)
+        SccFinder(TSccList &dst):
+            dst_(dst)
+        {
+        }
+
+        /// find the components reachable from fnc unless already done
+        void add(const CodeStorage::Fnc *fnc) {
+            if (!index_.count(fnc))
+                this->visit(fnc);
+        }
+
+    private:
+        typedef std::map<const CodeStorage::Fnc *, int> TIdxMap;
+
+        TSccList                       &dst_;
+        TIdxMap                         index_;
+        TIdxMap                         lowLink_;
+        TScc                            stack_;
+        std::set<const CodeStorage::Fnc *> onStack_;
+
+        void visit(const CodeStorage::Fnc *);
+};
 
-    for (const Fnc *pFnc : stor.callGraph.topOrder) {
-        const Fnc &fnc = *pFnc;
-        if (!isDefined(fnc))
+void SccFinder::visit(const CodeStorage::Fnc *fnc)
+{
+    const int idx = index_.size();
+    index_[fnc] = idx;
+    lowLink_[fnc] = idx;
+    stack_.push_back(fnc);
+    onStack_.insert(fnc);
+
+    for (CodeStorage::TInsnListByFnc::const_reference item
+            : fnc->cgNode->calls)
+    {
+        const CodeStorage::Fnc *callee = item.first;
+        if (!callee || !isDefined(*callee))
+            // indirect call or external function
             continue;
 
-        const struct cl_loc *loc = locationOf(fnc);
-        CL_DEBUG_MSG(loc, "analyzing function " << nameOf(fnc) << "()...");
+        if (!index_.count(callee)) {
+            this->visit(callee);
+            lowLink_[fnc] = std::min(lowLink_[fnc], lowLink_[callee]);
+        }
+        else if (onStack_.count(callee))
+            lowLink_[fnc] = std::min(lowLink_[fnc], index_[callee]);
+    }
+
+    if (lowLink_[fnc] != idx)
+        return;
 
-        handleFnc(fnc);
+    // fnc is the root of a component, pop it from the stack
+    TScc scc;
+    const CodeStorage::Fnc *member;
+    do {
+        member = stack_.back();
+        stack_.pop_back();
+        onStack_.erase(member);
+        scc.push_back(member);
     }
+    while (member != fnc);
+
+    dst_.push_back(scc);
+}
+
+/// true if the functions of the component call each other (or themselves)
+bool isRecursive(const SccFinder::TScc &scc)
+{
+    if (1 < scc.size())
+        return true;
+
+    const CodeStorage::Fnc *fnc = scc.front();
+    return fnc->cgNode->calls.count(const_cast<CodeStorage::Fnc *>(fnc));
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// see easy.hh for details
+void clEasyRun(const CodeStorage::Storage &stor, const char *)
+{
+    using namespace CodeStorage;
+    const TFncList &topOrder = stor.callGraph.topOrder;
+
+    // messages are reported in the top-down order, functions that are not
+    // reachable from any root of the call graph go last
+    std::map<const Fnc *, unsigned> rankOf;
+    for (const Fnc *fnc : topOrder)
+        rankOf.insert(std::make_pair(fnc, rankOf.size()));
+    for (const Fnc *fnc : stor.fncs)
+        rankOf.insert(std::make_pair(fnc, rankOf.size()));
+
+    // the order of topOrder is breadth-first, thus not bottom-up in general
+    SccFinder::TSccList sccs;
+    SccFinder finder(sccs);
+    for (const Fnc *fnc : topOrder)
+        if (isDefined(*fnc))
+            finder.add(fnc);
+    for (const Fnc *fnc : stor.fncs)
+        if (isDefined(*fnc))
+            finder.add(fnc);
+
+    // analyse the components bottom-up so that the summaries of callees are
+    // available when analysing their callers, recursive components are
+    // analysed repeatedly until the summaries of their functions stabilise
+    TSummaryMap summaries;
+    std::vector<TMsgList> msgsByRank(rankOf.size());
+    for (const SccFinder::TScc &scc : sccs) {
+        const bool recursive = isRecursive(scc);
+        for (unsigned round = 0; round < (FWNULL_SCC_MAX_ROUNDS); ++round) {
+            bool changed = false;
+            for (const Fnc *pFnc : scc) {
+                const Fnc &fnc = *pFnc;
+                const struct cl_loc *loc = locationOf(fnc);
+                CL_DEBUG_MSG(loc, "analyzing function " << nameOf(fnc)
+                        << "()...");
+
+                FncSummary summary;
+                TMsgList &msgs = msgsByRank[rankOf[pFnc]];
+                msgs.clear();
+                handleFnc(fnc, summaries, summary, msgs);
+
+                FncSummary &dst = summaries[uidOf(fnc)];
+                if (dst == summary)
+                    continue;
+
+                dst = summary;
+                changed = true;
+            }
+
+            if (!recursive || !changed)
+                break;
+        }
+    }
+
+    // report in the top-down order
+    for (const TMsgList &msgs : msgsByRank)
+        printMessages(msgs);
 }
@@ -24,3 +24,9 @@
 
 #define GIT_SHA1 fwnull_git_sha1
 #include "trap.h"
+
+/**
+ * maximal count of rounds over a recursive component of the call graph, the
+ * summaries of its functions are used as they are once the limit is reached
+ */
+#define FWNULL_SCC_MAX_ROUNDS               0x10
@@ -40,6 +40,23 @@ namespace CodeStorage {
 /// compare given two pieces of static type-info semantically
 bool operator==(const struct cl_type &cltA, const struct cl_type &cltB);
 
+/// canonical ID of the given type as assigned by TypeDb::canonicalize(), or -1
+int canonTypeId(const struct cl_type *);
+
+/// counters of the comparisons performed by operator==() on cl_type
+struct TypeCmpStats {
+    unsigned long       cntTotal;       ///< all comparisons
+    unsigned long       cntByUid;       ///< decided by the same UID
+    unsigned long       cntByCanonId;   ///< decided by the canonical IDs
+    unsigned long       cntByWalk;      ///< decided by walking the type trees
+};
+
+/// start counting type comparisons (the counters stay zero otherwise)
+void enableTypeCmpStats();
+
+/// statistics of type comparisons performed so far
+const TypeCmpStats& typeCmpStats();
+
 /// compare given two pieces of static type-info semantically
 inline bool operator!=(const struct cl_type &cltA, const struct cl_type &cltB)
 {
@@ -0,0 +1,188 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_DATAFLOW_H
+#define H_GUARD_DATAFLOW_H
+
+/**
+ * @file dataflow.hh
+ * a generic engine for monotone data-flow problems over CodeStorage CFGs
+ */
+
+#include <functional>
+#include <map>
+#include <queue>
+#include <vector>
+
+namespace CodeStorage {
+    struct Block;
+    class ControlFlow;
+
+namespace DataFlow {
+
+/// a set of densely numbered items (e.g. variables) represented as bit-vector
+class BitVector {
+    public:
+        BitVector() { }
+
+        explicit BitVector(unsigned size):
+            words_((size + cntWordBits - 1) / cntWordBits, 0UL)
+        {
+        }
+
+        bool get(unsigned idx) const {
+            const unsigned pos = idx / cntWordBits;
+            if (words_.size() <= pos)
+                return false;
+
+            return !!(words_[pos] & bitOf(idx));
+        }
+
+        void set(unsigned idx) {
+            const unsigned pos = idx / cntWordBits;
+            if (words_.size() <= pos)
+                words_.resize(pos + 1, 0UL);
+
+            words_[pos] |= bitOf(idx);
+        }
+
+        void reset(unsigned idx) {
+            const unsigned pos = idx / cntWordBits;
+            if (pos < words_.size())
+                words_[pos] &= ~bitOf(idx);
+        }
+
+        /// this |= other, return true if anything has changed
+        bool unite(const BitVector &other);
+
+        /// this |= (other & ~mask), return true if anything has changed
+        bool uniteMinus(const BitVector &other, const BitVector &mask);
+
+        /// call visitor(idx) for each item of the set in ascending order
+        template <class TVisitor>
+        void forEach(TVisitor visitor) const {
+            const unsigned cntWords = words_.size();
+            for (unsigned pos = 0; pos < cntWords; ++pos)
+                for (unsigned long w = words_[pos]; w; w &= w - 1UL)
+                    visitor(pos * cntWordBits + __builtin_ctzl(w));
+        }
+
+    private:
+        static const unsigned cntWordBits = 8U * sizeof(unsigned long);
+
+        static unsigned long bitOf(unsigned idx) {
+            return 1UL << (idx % cntWordBits);
+        }
+
+        std::vector<unsigned long> words_;
+};
+
+/// blocks of a CFG in reverse post-order, with edges addressed by the order
+class BlockOrder {
+    public:
+        typedef const Block                        *TBlock;
+        typedef std::vector<unsigned>               TIdxList;
+
+        /// compute reverse post-order from the entry, unreachable blocks last
+        explicit BlockOrder(const ControlFlow &cfg);
+
+        unsigned size() const {
+            return blocks_.size();
+        }
+
+        TBlock operator[](unsigned idx) const {
+            return blocks_[idx];
+        }
+
+        /// position of the given block in the order
+        unsigned indexOf(TBlock bb) const;
+
+        /// successors of the block at the given position
+        const TIdxList& succs(unsigned idx) const {
+            return succs_[idx];
+        }
+
+        /// predecessors of the block at the given position
+        const TIdxList& preds(unsigned idx) const {
+            return preds_[idx];
+        }
+
+    private:
+        std::vector<TBlock>                         blocks_;
+        std::map<TBlock, unsigned>                  idxByBlock_;
+        std::vector<TIdxList>                       succs_;
+        std::vector<TIdxList>                       preds_;
+};
+
+enum EDirection {
+    DF_FORWARD,             ///< states flow from predecessors to successors
+    DF_BACKWARD             ///< states flow from successors to predecessors
+};
+
+/**
+ * compute a fixed-point of a monotone problem using a worklist that always
+ * picks the block first in reverse post-order (or last for DF_BACKWARD)
+ * @param prob has to provide bool update(unsigned idx), which recomputes the
+ * state of the block at position idx in order from the states of its
+ * neighbours and returns true if the state of the block has changed
+ * @return count of update() calls
+ */
+template <class TProblem>
+unsigned solve(TProblem &prob, const BlockOrder &order, const EDirection dir)
+{
+    const unsigned cnt = order.size();
+    const bool fwd = (DF_FORWARD == dir);
+
+    // priority of a block in the worklist (lower goes first)
+    std::priority_queue<unsigned, std::vector<unsigned>,
+        std::greater<unsigned> > todo;
+    std::vector<bool> queued(cnt, true);
+    for (unsigned idx = 0; idx < cnt; ++idx)
+        todo.push(idx);
+
+    unsigned cntSteps = 0;
+    while (!todo.empty()) {
+        const unsigned prio = todo.top();
+        todo.pop();
+        const unsigned idx = (fwd) ? prio : (cnt - 1U - prio);
+        queued[idx] = false;
+
+        ++cntSteps;
+        if (!prob.update(idx))
+            continue;
+
+        // schedule the blocks that depend on this one
+        const BlockOrder::TIdxList &deps = (fwd)
+            ? order.succs(idx)
+            : order.preds(idx);
+
+        for (const unsigned dep : deps) {
+            if (queued[dep])
+                continue;
+
+            queued[dep] = true;
+            todo.push((fwd) ? dep : (cnt - 1U - dep));
+        }
+    }
+
+    return cntSteps;
+}
+
+} // namespace DataFlow
+} // namespace CodeStorage
+
+#endif /* H_GUARD_DATAFLOW_H */
@@ -0,0 +1,64 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_JSON_H
+#define H_GUARD_JSON_H
+
+/**
+ * @file json.hh
+ * minimalistic helpers for writing machine-readable statistics as JSON
+ */
+
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+/// a string literal to be printed quoted and escaped as JSON string
+struct JsonStr {
+    const std::string   str;
+
+    JsonStr(const std::string &str_):
+        str(str_)
+    {
+    }
+};
+
+inline std::ostream& operator<<(std::ostream &out, const JsonStr &js)
+{
+    out << '"';
+    for (const char c : js.str) {
+        switch (c) {
+            case '"':   out << "\\\""; break;
+            case '\\':  out << "\\\\"; break;
+            case '\n':  out << "\\n";  break;
+            case '\t':  out << "\\t";  break;
+
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[sizeof "\\u0000"];
+                    sprintf(buf, "\\u%04x", c);
+                    out << buf;
+                }
+                else
+                    out << c;
+        }
+    }
+
+    return out << '"';
+}
+
+#endif /* H_GUARD_JSON_H */
@@ -20,12 +20,15 @@
 #ifndef H_GUARD_MEM_DEBUG_H
 #define H_GUARD_MEM_DEBUG_H
 
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <string>
 #include <sys/types.h>
 
 /**
  * @file memdebug.hh
- * @todo some dox
+ * memory usage as reported by glibc, and accounting of memory by categories
  */
 
 /// provide the raw amount of currently allocated memory (as glibc reports it)
@@ -43,4 +46,92 @@ bool printMemUsage(const char *justCompletedFncName);
 /// print the peak over all calls of rawMemUsage(), but relative to the drift
 bool printPeakMemUsage();
 
+/// categories of memory accounted by MemAccounted and MemAccountingAllocator
+enum EMemCategory {
+    MC_CODE_STORAGE = 0,    ///< functions, blocks, and insns of CodeStorage
+    MC_SYM_HEAPS,           ///< symbolic heaps including their entities
+    MC_STATES,              ///< lists of heaps (states of blocks, cached calls)
+    MC_TRACE,               ///< nodes of the trace graph
+    MC_CALL_CACHE,          ///< call contexts of per-function call caches
+    MC_FIXED_POINT,         ///< states of the exported fixed-point
+    MC_TOTAL
+};
+
+/// live and peak amount of memory accounted to a single category
+struct MemCategoryStats {
+    ssize_t                     live;
+    ssize_t                     peak;
+};
+
+extern MemCategoryStats memCategoryStats[MC_TOTAL];
+
+/// account allocation (positive size) or release (negative size) of memory
+inline void memAccount(const EMemCategory cat, const ssize_t size)
+{
+    MemCategoryStats &st = memCategoryStats[cat];
+    st.live += size;
+    if (st.peak < st.live)
+        st.peak = st.live;
+}
+
+/// print live and peak amount of memory of each category
+bool printMemAccounting();
+
+/// allocate size bytes and account them to the given category
+void* memAccountedNew(EMemCategory cat, std::size_t size);
+
+/// release size bytes allocated by memAccountedNew() from the given category
+void memAccountedDelete(EMemCategory cat, void *ptr, std::size_t size);
+
+/**
+ * inherit from this class to account each instance allocated on heap
+ * @note classes deleted through a pointer to their base need virtual dtor
+ * @note the global operators are called out of line so that the compiler
+ * never sees ::operator new() paired with the class-level operator delete
+ */
+template <EMemCategory TCat>
+struct MemAccounted {
+    static void* operator new(std::size_t size) {
+        return memAccountedNew(TCat, size);
+    }
+
+    static void operator delete(void *ptr, std::size_t size) {
+        memAccountedDelete(TCat, ptr, size);
+    }
+};
+
+/// allocator for standard containers accounting the memory they allocate
+template <class T, EMemCategory TCat>
+class MemAccountingAllocator: public std::allocator<T> {
+    public:
+        typedef std::allocator<T>                       TBase;
+
+        template <class U> struct rebind {
+            typedef MemAccountingAllocator<U, TCat>     other;
+        };
+
+        MemAccountingAllocator() { }
+
+        MemAccountingAllocator(const MemAccountingAllocator &tpl):
+            TBase(tpl)
+        {
+        }
+
+        template <class U>
+        MemAccountingAllocator(const MemAccountingAllocator<U, TCat> &tpl):
+            TBase(tpl)
+        {
+        }
+
+        T* allocate(std::size_t n) {
+            memAccount(TCat, n * sizeof(T));
+            return TBase::allocate(n);
+        }
+
+        void deallocate(T *ptr, std::size_t n) {
+            memAccount(TCat, -static_cast<ssize_t>(n * sizeof(T)));
+            TBase::deallocate(ptr, n);
+        }
+};
+
 #endif /* H_GUARD_MEM_DEBUG_H */
@@ -0,0 +1,157 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_METRICS_H
+#define H_GUARD_METRICS_H
+
+/**
+ * @file metrics.hh
+ * a registry of named counters, gauges and histograms shared by all analysis
+ * modules, which can be dumped as JSON at exit, on SIGUSR1, or periodically
+ */
+
+#include <ostream>
+#include <string>
+
+namespace Metrics {
+
+/// a metric registers itself on construction, so use static objects only
+class Metric {
+    public:
+        const char* name() const { return name_; }
+
+        /// print the value of the metric as a JSON value
+        virtual void printJson(std::ostream &) const = 0;
+
+    protected:
+        /// @param name has to be a string literal
+        explicit Metric(const char *name);
+        virtual ~Metric() { }
+
+    private:
+        Metric(const Metric &);
+        Metric& operator=(const Metric &);
+
+        const char             *name_;
+};
+
+/// a monotonically increasing count of events
+class Counter: public Metric {
+    public:
+        explicit Counter(const char *name):
+            Metric(name),
+            value_(0UL)
+        {
+        }
+
+        void inc(const unsigned long n = 1UL) {
+            value_ += n;
+        }
+
+        unsigned long value() const {
+            return value_;
+        }
+
+        virtual void printJson(std::ostream &) const;
+
+    private:
+        unsigned long           value_;
+};
+
+/// the current value of a quantity that may go up and down, with its maximum
+class Gauge: public Metric {
+    public:
+        explicit Gauge(const char *name):
+            Metric(name),
+            value_(0L),
+            max_(0L)
+        {
+        }
+
+        void set(const long value) {
+            value_ = value;
+            if (max_ < value)
+                max_ = value;
+        }
+
+        long value() const {
+            return value_;
+        }
+
+        virtual void printJson(std::ostream &) const;
+
+    private:
+        long                    value_;
+        long                    max_;
+};
+
+/// distribution of non-negative samples in power-of-two buckets
+class Histogram: public Metric {
+    public:
+        explicit Histogram(const char *name);
+
+        void add(const unsigned long value) {
+            ++buckets_[bucketOf(value)];
+            ++cnt_;
+            sum_ += value;
+            if (value < min_)
+                min_ = value;
+            if (max_ < value)
+                max_ = value;
+        }
+
+        virtual void printJson(std::ostream &) const;
+
+    private:
+        /// 0 goes to the bucket 0, [2^(n-1), 2^n) goes to the bucket n
+        static unsigned bucketOf(const unsigned long value) {
+            return (value)
+                ? (8U * sizeof(unsigned long) - __builtin_clzl(value))
+                : 0U;
+        }
+
+        static const unsigned   cntBuckets = 8U * sizeof(unsigned long) + 1U;
+
+        unsigned long           buckets_[cntBuckets];
+        unsigned long           cnt_;
+        unsigned long           sum_;
+        unsigned long           min_;
+        unsigned long           max_;
+};
+
+/// true if the metrics are going to be written to a file
+bool enabled();
+
+/**
+ * enable the output if the comma-separated config string contains the option
+ * metrics[:<file>] (metrics.json is used if no file name is given), the file
+ * is also rewritten every <sec> seconds if metrics_period:<sec> is given
+ */
+void enableByConfig(const std::string &configString);
+
+/// print all registered metrics as a single JSON object
+void printJson(std::ostream &);
+
+/// write the metrics to the file if the period given by the config has elapsed
+void tick();
+
+/// write the metrics to the file given by enableByConfig()
+void dump();
+
+} // namespace Metrics
+
+#endif /* H_GUARD_METRICS_H */
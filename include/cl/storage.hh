@@ -21,6 +21,7 @@
 #define H_GUARD_STORAGE_H
 
 #include "code_listener.h"
+#include "memdebug.hh"
 
 #include <map>
 #include <set>
@@ -106,6 +107,18 @@ struct Var {
      */
     bool                        mayBePointed = false;
 
+    /**
+     * dense index of the variable among global variables, or among variables
+     * on stack of the function given by fncIdx, -1 if not assigned
+     */
+    int                         denseIdx = -1;
+
+    /**
+     * position of the function owning the variable in FncDb, -1 for global
+     * variables (valid only if denseIdx is assigned)
+     */
+    int                         fncIdx = -1;
+
     Var() = default;
 
     /**
@@ -240,6 +253,19 @@ class TypeDb {
         /// a (void *) type if available; if not, any data pointer; 0 otherwise
         const struct cl_type* genericDataPtr() const;
 
+        /**
+         * hash-cons structurally equal types to a single canonical ID, such
+         * that operator==() on cl_type can decide whether two types are equal
+         * by comparing two integers instead of walking the type trees
+         * @note Names of fields are compared strictly, an unnamed field does
+         * not match a named one.
+         * @note useful only for builder, once all types have been inserted
+         */
+        void canonicalize();
+
+        /// canonical ID of the given type, -1 if canonicalize() has not seen it
+        int canonId(cl_uid_t) const;
+
     private:
         /// @b not allowed to be copied
         TypeDb(const TypeDb &);
@@ -321,7 +347,7 @@ typedef std::vector<TKillVarList>                   TKillPerTarget;
 /**
  * high-level representation of an intermediate code instruction
  */
-struct Insn {
+struct Insn: public MemAccounted<MC_CODE_STORAGE> {
     /**
      * instance of Storage which owns the Insn object
      */
@@ -431,7 +457,7 @@ struct Insn {
  * ready, it contains (possibly empty) sequence of non-terminating instructions
  * and exactly one terminating instruction.
  */
-class Block {
+class Block: public MemAccounted<MC_CODE_STORAGE> {
     private:
         typedef STD_VECTOR(const Insn *) TList;
 
@@ -718,7 +744,7 @@ bool isDead(const GlobalData &);
 /**
  * function definition
  */
-struct Fnc {
+struct Fnc: public MemAccounted<MC_CODE_STORAGE> {
     struct cl_operand           def;    ///< definition as low-level operand
     Storage                    *stor;   ///< owning Storage object
     TVarSet                     vars;   ///< uids of variables used by the fnc
@@ -0,0 +1,79 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_TIMELINE_H
+#define H_GUARD_TIMELINE_H
+
+/**
+ * @file timeline.hh
+ * lightweight scoped timers of analysis phases, exported as a timeline in the
+ * trace-event JSON format (loadable by chrome://tracing or ui.perfetto.dev)
+ */
+
+#include <string>
+
+namespace Timeline {
+
+/// true if the timeline is being recorded (cheap enough to call anywhere)
+bool enabled();
+
+/**
+ * start recording if the comma-separated config string contains the option
+ * timeline[:<file>] (timeline.json is used if no file name is given)
+ */
+void enableByConfig(const std::string &configString);
+
+/// monotonic wall-clock time in seconds (shared by all timers of the analysis)
+double wallClock();
+
+/// monotonic wall-clock time in microseconds since recording has started
+double now();
+
+/// record a phase that has started at the given time and has just ended
+void record(const char *name, double start);
+
+/// record a phase with a dynamically created name (e.g. a call frame)
+void record(const std::string &name, double start);
+
+/// write the recorded timeline to the file given by enableByConfig()
+void dump();
+
+/// record the lifetime of a scope as a phase of the given name
+class Scope {
+    public:
+        explicit Scope(const char *name):
+            name_(name),
+            start_((enabled()) ? now() : -1.0)
+        {
+        }
+
+        ~Scope() {
+            if (0.0 <= start_)
+                record(name_, start_);
+        }
+
+    private:
+        Scope(const Scope &);
+        Scope& operator=(const Scope &);
+
+        const char             *name_;
+        const double            start_;
+};
+
+} // namespace Timeline
+
+#endif /* H_GUARD_TIMELINE_H */
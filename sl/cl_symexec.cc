@@ -27,7 +27,13 @@
 
 #include "fixed_point_proxy.hh"
 #include "glconf.hh"
+#include "governor.hh"
+#include "heaplog.hh"
+#include "partition.hh"
+#include "profiler.hh"
+#include "symbin.hh"
 #include "symbt.hh"
+#include "symcall.hh"
 #include "symdump.hh"
 #include "symexec.hh"
 #include "symproc.hh"
@@ -35,6 +41,7 @@
 #include "symtrace.hh"
 #include "symutil.hh"
 #include "util.hh"
+#include "vra_ranges.hh"
 
 #include <stdexcept>
 #include <string>
@@ -117,6 +124,10 @@ void execVirtualRoots(const CodeStorage::Storage &stor)
     // go through all root nodes
     const CG::Graph &cg = stor.callGraph;
     for (const CG::Node *node : cg.roots) {
+        if (!Partition::isPrimary())
+            // the remaining roots are analyzed by another process
+            break;
+
         const CodeStorage::Fnc &fnc = *node->fnc;
         if (!isDefined(fnc))
             continue;
@@ -167,13 +178,49 @@ void clEasyRun(const CodeStorage::Storage &stor, const char *configString)
 
     // read parameters of symbolic execution
     GlConf::loadConfigString(configString);
+    Governor::init();
+    Partition::init();
+
+    // bind models of built-ins to the functions they are used for
+    for (const std::string &fileName : GlConf::data.builtInModels)
+        loadBuiltInModels(fileName);
+    resolveBuiltIns(stor);
+
+    // compute value ranges to prune infeasible paths if asked to do so
+    if (GlConf::data.vraPrepass)
+        vraComputeRanges(stor);
 
     // run symbolic execution
+    bool complete = true;
     try {
         launchSymExec(stor);
     }
+    catch (const Partition::Delegated &) {
+        // the messages of the forked processes have been already emitted
+    }
     catch (const std::runtime_error &e) {
         CL_DEBUG("clEasyRun() caught a run-time exception: " << e.what());
+        complete = false;
+    }
+
+    // forked processes have nothing more to do here
+    Partition::leaveIfWorker(complete);
+
+    // dump call cache statistics if asked to do so
+    dumpCallCacheStats();
+
+    // print hot spots of the analysis if asked to do so
+    Profiler::dump();
+
+    // close the log of heap operations if asked to record them
+    HeapLog::dump();
+
+    if (GlConf::data.typeCmpStats) {
+        const TypeCmpStats &st = typeCmpStats();
+        CL_NOTE("[TypeDb] " << st.cntTotal << " type comparisons, "
+                << st.cntByUid << " decided by UID, "
+                << st.cntByCanonId << " by canonical ID, "
+                << st.cntByWalk << " by walking the type trees");
     }
 
     FixedPoint::StateByInsn *const fixedPoint = GlConf::data.fixedPoint;
@@ -98,6 +98,12 @@
  */
 #define SE_ABSTRACT_ON_LOOP_EDGES_ONLY      1
 
+/**
+ * maximal count of (entry, props) pairs evaluated by segment discovery per
+ * each call of abstractIfNeeded() (0 means unlimited)
+ */
+#define SE_ABSTRACTION_WORK_BUDGET          0
+
 /**
  * if 1, allow to replace already referenced trace graph nodes (creates cycles)
  */
@@ -151,6 +157,18 @@
  */
 #define SE_CALL_CACHE_MISS_THR              0x10
 
+/**
+ * call cache miss count of a fnc that enables widening of its entry heaps by
+ * joining them with the cached ones (0 means disabled)
+ * @note This can be overridden by the call_cache_widening run-time option
+ */
+#define SE_CALL_CACHE_WIDEN_THR             0
+
+/**
+ * if 1, memoise apparent container shapes of heaps with the same fingerprint
+ */
+#define SE_CONT_SHAPE_CACHE                 1
+
 /**
  * increase the cost of abstraction path consisting of concrete objects only by
  */
@@ -231,6 +249,12 @@
  */
 #define SE_FORBID_HEAP_REPLACE              0
 
+/**
+ * if 1, reuse results of segment discovery for entry candidates that cannot
+ * reach any object affected by the previous abstraction step
+ */
+#define SE_INCREMENTAL_DISCOVERY            1
+
 /**
  * the highest integral number we can count to (only partial implementation atm)
  */
@@ -277,6 +301,20 @@
  */
 #define SE_STATE_ON_THE_FLY_ORDERING        1
 
+/**
+ * count of worker processes used to evaluate segment discovery candidates in
+ * parallel (0 or 1 means sequential evaluation)
+ * @note This can be overridden by the parallel_discovery run-time option
+ */
+#define SE_PARALLEL_DISCOVERY               0
+
+/**
+ * minimal count of (entry, props) pairs worth evaluating in parallel
+ * @note Above the threshold, the workers are forked only if the sequential
+ * evaluation is estimated to take longer than forking them (both are measured)
+ */
+#define SE_PARALLEL_DISCOVERY_THR           0x20
+
 /**
  * - 0 ... keep state info for all basic blocks of a function
  * - 1 ... keep state info for all basic blocks except trivial basic blocks
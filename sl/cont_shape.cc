@@ -128,14 +128,15 @@ bool ApparentShapeDetector::probeEntry(const TObjId obj, const ShapeProps &props
     return true;
 }
 
-void detectApparentShapes(TShapeList &dst, SymHeap &sh)
+void detectApparentShapesCore(
+        TShapeList                 &dst,
+        SymHeap                    &sh,
+        const TObjList             &heapObjs)
 {
     CL_BREAK_IF(!dst.empty());
     ApparentShapeDetector shapeDetector(sh, dst);
 
     // go through all potential shape container entries
-    TObjList heapObjs;
-    sh.gatherObjects(heapObjs, isOnHeap);
     for (const TObjId obj : heapObjs) {
         if (sh.objProtoLevel(obj))
             // FIXME: we support only L0 data structures for now
@@ -170,6 +171,153 @@ void detectApparentShapes(TShapeList &dst, SymHeap &sh)
     }
 }
 
+void detectApparentShapes(TShapeList &dst, SymHeap &sh)
+{
+    TObjList heapObjs;
+    sh.gatherObjects(heapObjs, isOnHeap);
+    detectApparentShapesCore(dst, sh, heapObjs);
+}
+
+/// serialized description of heap objects, invariant to renaming of IDs
+typedef std::vector<long>                   THeapFingerprint;
+
+class FingerprintBuilder {
+    public:
+        FingerprintBuilder(SymHeap &sh, const TObjList &heapObjs);
+
+        /// return false if the heap cannot be described by a fingerprint
+        bool build(THeapFingerprint *pDst);
+
+    private:
+        typedef std::map<TObjId, long>      TObjIndex;
+        typedef std::map<TValId, long>      TValIndex;
+
+        SymHeap                    &sh_;
+        const TObjList             &heapObjs_;
+        TObjIndex                   objIndex_;
+        TObjIndex                   deadIndex_;
+        TValIndex                   valIndex_;
+        THeapFingerprint           *pDst_;
+
+        long valIdx(const TValId val);
+        bool appendVal(const TValId val);
+};
+
+FingerprintBuilder::FingerprintBuilder(SymHeap &sh, const TObjList &heapObjs):
+    sh_(sh),
+    heapObjs_(heapObjs),
+    pDst_(0)
+{
+    // heap objects are identified by their position in the list
+    const long cnt = heapObjs.size();
+    for (long idx = 0; idx < cnt; ++idx)
+        objIndex_[heapObjs[idx]] = idx;
+}
+
+long FingerprintBuilder::valIdx(const TValId val)
+{
+    TValIndex::const_iterator it = valIndex_.find(val);
+    if (it == valIndex_.end()) {
+        const long idx = valIndex_.size();
+        it = valIndex_.insert(std::make_pair(val, idx)).first;
+    }
+
+    return it->second;
+}
+
+bool FingerprintBuilder::appendVal(const TValId val)
+{
+    THeapFingerprint &dst = *pDst_;
+    if (val <= VAL_NULL) {
+        // special values are the same in all heaps
+        dst.push_back(val);
+        return true;
+    }
+
+    const EValueTarget code = sh_.valTarget(val);
+    dst.push_back(/* avoid collisions with special values */ 0x100 + code);
+
+    if (!isAnyDataArea(code)) {
+        // only the equality of non-pointer values matters for shape detection
+        dst.push_back(this->valIdx(val));
+        return true;
+    }
+
+    const TObjId obj = sh_.objByAddr(val);
+    if (sh_.isValid(obj)) {
+        const TObjIndex::const_iterator it = objIndex_.find(obj);
+        if (it == objIndex_.end())
+            // a heap object pointing outside of heap is not supported for now
+            return false;
+
+        dst.push_back(it->second);
+    }
+    else {
+        // pointer to an invalid object, identified by the order of appearance
+        // (the terminators of a segment are compared by value in probeEntry())
+        TObjIndex::const_iterator it = deadIndex_.find(obj);
+        if (it == deadIndex_.end()) {
+            const long idx = deadIndex_.size();
+            it = deadIndex_.insert(std::make_pair(obj, idx)).first;
+        }
+
+        dst.push_back(/* never a position in heapObjs_ */ -1L - it->second);
+        dst.push_back(this->valIdx(val));
+    }
+
+    dst.push_back(sh_.valOffset(val));
+    dst.push_back(sh_.targetSpec(val));
+    return true;
+}
+
+bool FingerprintBuilder::build(THeapFingerprint *pDst)
+{
+    CL_BREAK_IF(!pDst->empty());
+    pDst_ = pDst;
+
+    for (const TObjId obj : heapObjs_) {
+        const EObjKind kind = sh_.objKind(obj);
+        pDst->push_back(kind);
+        pDst->push_back(sh_.objProtoLevel(obj));
+
+        const TSizeRange size = sh_.objSize(obj);
+        pDst->push_back(size.lo);
+        pDst->push_back(size.hi);
+
+        const TObjType clt = sh_.objEstimatedType(obj);
+        pDst->push_back((clt) ? clt->uid : -1L);
+
+        if (OK_REGION != kind && OK_OBJ_OR_NULL != kind) {
+            const BindingOff &off = sh_.segBinding(obj);
+            pDst->push_back(off.head);
+            pDst->push_back(off.next);
+            pDst->push_back(off.prev);
+        }
+
+        FldList fields;
+        sh_.gatherLiveFields(fields, obj);
+        pDst->push_back(fields.size());
+        for (const FldHandle &fld : fields) {
+            pDst->push_back(fld.offset());
+            if (!this->appendVal(fld.value()))
+                return false;
+        }
+
+        TUniBlockMap uniBlocks;
+        sh_.gatherUniformBlocks(uniBlocks, obj);
+        pDst->push_back(uniBlocks.size());
+        for (TUniBlockMap::const_reference item : uniBlocks) {
+            const UniformBlock &ub = item.second;
+            pDst->push_back(ub.off);
+            pDst->push_back(ub.size);
+            if (!this->appendVal(ub.tplValue))
+                return false;
+        }
+    }
+
+    return true;
+}
+
 typedef std::pair<CVar, TOffset>            TPointer;
 typedef std::set<TPointer>                  TPointerSet;
 typedef std::set<TPointerSet>               TPointerSetLookup;
@@ -469,7 +617,99 @@ void detectImpliedShapes(DetectionCtx &ctx)
 
 } // namespace ContShape
 
-void detectLocalContShapes(TShapeListByHeapIdx *pDst, const SymState &state)
+// /////////////////////////////////////////////////////////////////////////////
+// ContShapeCache implementation
+struct ContShapeCache::Private {
+    typedef ContShape::THeapFingerprint                     TKey;
+
+    /// shapes with entries given by indices into the list of heap objects
+    typedef std::map<TKey, TShapeList>                      TCache;
+
+    TCache                      cache;
+    unsigned                    cntLookups;
+    unsigned                    cntHits;
+    unsigned                    cntBypassed;
+
+    Private():
+        cntLookups(0U),
+        cntHits(0U),
+        cntBypassed(0U)
+    {
+    }
+};
+
+ContShapeCache::ContShapeCache():
+    d(new Private)
+{
+}
+
+ContShapeCache::~ContShapeCache()
+{
+    delete d;
+}
+
+void ContShapeCache::detectApparentShapes(TShapeList *pDst, SymHeap &sh)
+{
+    using namespace ContShape;
+
+    TObjList heapObjs;
+    sh.gatherObjects(heapObjs, isOnHeap);
+
+    Private::TKey key;
+    FingerprintBuilder fpBuilder(sh, heapObjs);
+    if (!fpBuilder.build(&key)) {
+        // the heap cannot be fingerprinted, detect the shapes from scratch
+        ++d->cntBypassed;
+        detectApparentShapesCore(*pDst, sh, heapObjs);
+        return;
+    }
+
+    ++d->cntLookups;
+    const Private::TCache::const_iterator it = d->cache.find(key);
+    if (it != d->cache.end()) {
+        // cache hit, translate the indices back to object IDs of this heap
+        ++d->cntHits;
+        for (Shape shape : /* TShapeList */ it->second) {
+            shape.entry = heapObjs.at(/* idx */ shape.entry);
+            pDst->push_back(shape);
+        }
+
+        return;
+    }
+
+    detectApparentShapesCore(*pDst, sh, heapObjs);
+
+    // translate object IDs to indices into the list of heap objects
+    TObjMap idMap;
+    const unsigned cnt = heapObjs.size();
+    for (unsigned idx = 0U; idx < cnt; ++idx)
+        idMap[heapObjs[idx]] = static_cast<TObjId>(idx);
+
+    TShapeList &cached = d->cache[key];
+    for (Shape shape : *pDst) {
+        CL_BREAK_IF(!hasKey(idMap, shape.entry));
+        shape.entry = idMap[shape.entry];
+        cached.push_back(shape);
+    }
+}
+
+void ContShapeCache::printStats() const
+{
+    const unsigned cntAll = d->cntLookups + d->cntBypassed;
+    if (!cntAll)
+        return;
+
+    const unsigned hitRate = (100U * d->cntHits) / cntAll;
+    CL_DEBUG("ContShapeCache: " << cntAll << " heaps examined, "
+            << d->cntHits << " cache hits (" << hitRate << "%), "
+            << d->cntBypassed << " heaps bypassed the cache, "
+            << d->cache.size() << " distinct fingerprints cached");
+}
+
+void detectLocalContShapes(
+        TShapeListByHeapIdx        *pDst,
+        const SymState             &state,
+        ContShapeCache             *pCache)
 {
     CL_BREAK_IF(!pDst->empty());
 
@@ -486,7 +726,11 @@ void detectLocalContShapes(TShapeListByHeapIdx *pDst, const SymState &state)
         TShapeList &dst = ctx.dstArray[i];
         SymHeap &src = const_cast<SymHeap &>(state[i]);
 
-        detectApparentShapes(dst, src);
+        if (pCache)
+            pCache->detectApparentShapes(&dst, src);
+        else
+            detectApparentShapes(dst, src);
+
         if (dst.empty())
             continue;
 
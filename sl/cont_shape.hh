@@ -30,12 +30,41 @@ namespace ContShape {
     extern bool debuggingEnabled;
 }
 
+/**
+ * memoises apparent container shapes of heaps, keyed by a fingerprint of their
+ * heap objects, such that heaps which differ only in program variables (or in
+ * IDs of their heap objects) do not need to be analysed over and over again
+ */
+class ContShapeCache {
+    public:
+        ContShapeCache();
+        ~ContShapeCache();
+
+        /// detect apparent shapes in sh, reuse a cached result if available
+        void detectApparentShapes(TShapeList *pDst, SymHeap &sh);
+
+        /// print the count of lookups, hits, and bypassed heaps (CL_DEBUG)
+        void printStats() const;
+
+    private:
+        // not implemented
+        ContShapeCache(const ContShapeCache &);
+        ContShapeCache& operator=(const ContShapeCache &);
+
+        struct Private;
+        Private *d;
+};
+
 #define CS_DEBUG(msg) do {              \
     if (!ContShape::debuggingEnabled)   \
         break;                          \
     CL_DEBUG(msg);                      \
 } while (0)
 
-void detectLocalContShapes(TShapeListByHeapIdx *pDst, const SymState &);
+/// if pCache is not NULL, use it to memoise the apparent shapes of each heap
+void detectLocalContShapes(
+        TShapeListByHeapIdx        *pDst,
+        const SymState             &state,
+        ContShapeCache             *pCache = 0);
 
 #endif /* H_GUARD_CONT_SHAPE_H */
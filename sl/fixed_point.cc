@@ -305,12 +305,24 @@ void createTraceEdges(GlobalState &glState, TTraceList &traceList)
 
 void detectContShapes(GlobalState &glState)
 {
+#if SE_CONT_SHAPE_CACHE
+    // neighbouring locations often share heaps that differ only in variables
+    ContShapeCache cache;
+    ContShapeCache *pCache = &cache;
+#else
+    ContShapeCache *pCache = 0;
+#endif
+
     const TLocIdx locCnt = glState.size();
     for (TLocIdx locIdx = 0; locIdx < locCnt; ++locIdx) {
         LocalState &locState = glState[locIdx];
         const SymState &state = locState.heapList;
-        detectLocalContShapes(&locState.shapeListByHeapIdx, state);
+        detectLocalContShapes(&locState.shapeListByHeapIdx, state, pCache);
     }
+
+#if SE_CONT_SHAPE_CACHE
+    cache.printStats();
+#endif
 }
 
 bool checkShapeMapping(
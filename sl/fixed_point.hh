@@ -79,7 +79,7 @@ inline std::ostream& operator<<(std::ostream &str, const GenericInsn &insn)
 }
 
 /// single heap-level trace edge holding inner ID mappings inside
-struct TraceEdge {
+struct TraceEdge: public MemAccounted<MC_FIXED_POINT> {
     THeapIdent              src;            /// source heap
     THeapIdent              dst;            /// destination heap
     TShapeMapper            csMap;          /// container shapes mapping
@@ -110,7 +110,7 @@ struct CfgEdge {
 typedef std::vector<CfgEdge>                        TCfgEdgeList;
 
 /// state summary for a single location (preceding a single instruction)
-struct LocalState {
+struct LocalState: public MemAccounted<MC_FIXED_POINT> {
     GenericInsn            *insn;           /// insn using the state as input
     SymHeapList             heapList;       /// union of heaps giving the state
     TShapeListByHeapIdx     shapeListByHeapIdx; /// container shapes per heap
@@ -126,7 +126,7 @@ struct LocalState {
 };
 
 /// annotated fixed-point of a program (or its part, e.g. a function)
-class GlobalState {
+class GlobalState: public MemAccounted<MC_FIXED_POINT> {
     public:
         GlobalState() { }
 
@@ -23,6 +23,7 @@
 #include "fixed_point_proxy.hh"
 
 #include <cl/cl_msg.hh>
+#include <cl/clutil.hh>
 
 #include <algorithm>
 #include <map>
@@ -32,6 +33,8 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <unistd.h>                 // for sysconf()
+
 namespace GlConf {
 
 Options data;
@@ -49,10 +52,21 @@ Options::Options():
     intArithmeticLimit(SE_INT_ARITHMETIC_LIMIT),
     joinOnLoopEdgesOnly(SE_JOIN_ON_LOOP_EDGES_ONLY),
     stateLiveOrdering(SE_STATE_ON_THE_FLY_ORDERING),
+    statePruningMode(SE_STATE_PRUNING_MODE),
     exitLeaks(SE_EXIT_LEAKS),
     detectContainers(false),
+    parallelDiscovery(SE_PARALLEL_DISCOVERY),
+    partition(0),
+    callCacheWidenThr(SE_CALL_CACHE_WIDEN_THR),
+    typeCmpStats(false),
+    vraPrepass(false),
+    timeBudget(0.0),
+    memBudget(0U),
     fixedPoint(0)
 {
+    absLenThr.push_back(SE_COST0_LEN_THR);
+    absLenThr.push_back(SE_COST1_LEN_THR);
+    absLenThr.push_back(SE_COST2_LEN_THR);
 }
 
 class ConfigStringParser {
@@ -101,6 +115,37 @@ void handleErrorLabel(const string &name, const string &value)
     data.errLabel = value;
 }
 
+void handleAbstractionLenThr(const string &name, const string &value)
+{
+    // thresholds for costs 0, 1, 2 separated by ':', the rest is kept as is
+    std::vector<string> thrList;
+    boost::split(thrList, value, boost::algorithm::is_any_of(":"));
+    if (data.absLenThr.size() < thrList.size()) {
+        CL_WARN("ignoring option \"" << name << "\" with too many values");
+        return;
+    }
+
+    std::vector<int> absLenThr(data.absLenThr);
+    for (unsigned cost = 0U; cost < thrList.size(); ++cost) {
+        int thr = 0;
+        try {
+            thr = boost::lexical_cast<int>(thrList[cost]);
+        }
+        catch (...) {
+        }
+
+        if (thr < 2) {
+            // Predator needs at least one elementary merge to abstract
+            CL_WARN("ignoring option \"" << name << "\" with invalid value");
+            return;
+        }
+
+        absLenThr[cost] = thr;
+    }
+
+    data.absLenThr.swap(absLenThr);
+}
+
 void handleAllowThreeWayJoin(const string &name, const string &value)
 {
     if (value.empty()) {
@@ -141,6 +186,20 @@ void handleJoinOnLoopEdgesOnly(const string &name, const string &value)
     }
 }
 
+void handleStatePruningMode(const string &name, const string &value)
+{
+    try {
+        data.statePruningMode = boost::lexical_cast<int>(value);
+        if (data.statePruningMode < 0)
+            data.statePruningMode = 0;
+        if (data.statePruningMode > 3)
+            data.statePruningMode = 3;
+    }
+    catch (...) {
+        CL_WARN("ignoring option \"" << name << "\" with invalid value");
+    }
+}
+
 void handleStateLiveOrdering(const string &name, const string &value)
 {
     if (value.empty()) {
@@ -171,6 +230,93 @@ void handleIntArithmeticLimit(const string &name, const string &value)
     }
 }
 
+void handleParallelDiscovery(const string &name, const string &value)
+{
+    if (value.empty()) {
+        const long cntCpus = sysconf(_SC_NPROCESSORS_ONLN);
+        data.parallelDiscovery = (0 < cntCpus) ? cntCpus : 1;
+        return;
+    }
+
+    try {
+        data.parallelDiscovery = boost::lexical_cast<int>(value);
+        if (data.parallelDiscovery < 0)
+            data.parallelDiscovery = 0;
+    }
+    catch (...) {
+        CL_WARN("ignoring option \"" << name << "\" with invalid value");
+    }
+}
+
+void handlePartition(const string &name, const string &value)
+{
+    if (value.empty()) {
+        const long cntCpus = sysconf(_SC_NPROCESSORS_ONLN);
+        data.partition = (0 < cntCpus) ? cntCpus : 1;
+        return;
+    }
+
+    try {
+        data.partition = boost::lexical_cast<int>(value);
+        if (data.partition < 0)
+            data.partition = 0;
+    }
+    catch (...) {
+        CL_WARN("ignoring option \"" << name << "\" with invalid value");
+    }
+}
+
+void handleBuiltInModels(const string &name, const string &value)
+{
+    if (value.empty()) {
+        CL_WARN("ignoring option \"" << name << "\" without a file name");
+        return;
+    }
+
+    data.builtInModels.push_back(value);
+}
+
+void handleCallCacheStats(const string &, const string &value)
+{
+    data.callCacheStatsFile = (value.empty())
+        ? "call-cache-stats.json"
+        : value;
+}
+
+void handleHotSpots(const string &, const string &value)
+{
+    data.hotSpotsFile = (value.empty())
+        ? "hot-spots.folded"
+        : value;
+}
+
+void handleRecordHeapOps(const string &, const string &value)
+{
+    data.heapLogFile = (value.empty())
+        ? "heap-ops.log"
+        : value;
+}
+
+void handleCallCacheWidening(const string &name, const string &value)
+{
+    // joining of cache entries does not keep the heaps ordered
+    data.stateLiveOrdering = /* disabled */ 0;
+
+    if (value.empty()) {
+        data.callCacheWidenThr = /* widen on the first miss */ 1;
+        return;
+    }
+
+    try {
+        data.callCacheWidenThr = boost::lexical_cast<int>(value);
+        if (data.callCacheWidenThr < 0)
+            data.callCacheWidenThr = 0;
+    }
+    catch (...) {
+        CL_WARN("ignoring option \"" << name << "\" with invalid value");
+    }
+}
+
 void handleAllowCyclicTraceGraph(const string &name, const string &value)
 {
     assumeNoValue(name, value);
@@ -219,6 +365,62 @@ void handleTrackUninit(const string &name, const string &value)
     data.trackUninit = true;
 }
 
+void handleTimeBudget(const string &name, const string &value)
+{
+    try {
+        data.timeBudget = boost::lexical_cast<double>(value);
+        if (data.timeBudget < 0.0)
+            data.timeBudget = 0.0;
+    }
+    catch (...) {
+        CL_WARN("ignoring option \"" << name << "\" with invalid value");
+    }
+}
+
+void handleTypeCmpStats(const string &name, const string &value)
+{
+    assumeNoValue(name, value);
+    data.typeCmpStats = true;
+    enableTypeCmpStats();
+}
+
+void handleVraPrepass(const string &name, const string &value)
+{
+    assumeNoValue(name, value);
+#ifndef SL_USE_VRA
+    CL_ERROR("option \"" << name << "\" requires SL_USE_VRA");
+    return;
+#endif
+    data.vraPrepass = true;
+}
+
+// consumed by pointsToAnalyse() in cl, just validated here
+void handlePointsTo(const string &name, const string &value)
+{
+    if (value != "fics" && value != "steensgaard")
+        CL_WARN("ignoring option \"" << name << "\" with invalid value");
+}
+
+// consumed by ClEasy in cl, nothing to do here
+void handleTimeline(const string &, const string &)
+{
+}
+
+void handleMemBudget(const string &name, const string &value)
+{
+    try {
+        data.memBudget = boost::lexical_cast<unsigned>(value);
+    }
+    catch (...) {
+        CL_WARN("ignoring option \"" << name << "\" with invalid value");
+    }
+}
+
+// consumed by ClEasy in cl, nothing to do here
+void handleMetrics(const string &, const string &)
+{
+}
+
 void handleDetectContainers(const string &name, const string &value)
 {
 #if !SH_PREVENT_AMBIGUOUS_ENT_ID
@@ -237,22 +439,39 @@ void handleDetectContainers(const string &name, const string &value)
 
 ConfigStringParser::ConfigStringParser()
 {
+    tbl_["abstraction_len_thr"]     = handleAbstractionLenThr;
     tbl_["allow_cyclic_trace_graph"]= handleAllowCyclicTraceGraph;
     tbl_["allow_three_way_join"]    = handleAllowThreeWayJoin;
+    tbl_["builtin_models"]          = handleBuiltInModels;
+    tbl_["call_cache_stats"]        = handleCallCacheStats;
+    tbl_["call_cache_widening"]     = handleCallCacheWidening;
     tbl_["dump_fixed_point"]        = handleDumpFixedPoint;
     tbl_["detect_containers"]       = handleDetectContainers;
     tbl_["error_label"]             = handleErrorLabel;
     tbl_["exit_leaks"]              = handleExitLeaks;
     tbl_["forbid_heap_replace"]     = handleForbidHeapReplace;
+    tbl_["hot_spots"]               = handleHotSpots;
     tbl_["int_arithmetic_limit"]    = handleIntArithmeticLimit;
     tbl_["join_on_loop_edges_only"] = handleJoinOnLoopEdgesOnly;
+    tbl_["mem_budget"]              = handleMemBudget;
     tbl_["memleak_is_error"]        = handleMemLeakIsError;
+    tbl_["metrics"]                 = handleMetrics;
+    tbl_["metrics_period"]          = handleMetrics;
     tbl_["no_error_recovery"]       = handleNoErrorRecovery;
     tbl_["no_plot"]                 = handleNoPlot;
     tbl_["oom"]                     = handleOOM;
+    tbl_["parallel_discovery"]      = handleParallelDiscovery;
+    tbl_["partition"]               = handlePartition;
+    tbl_["points_to"]               = handlePointsTo;
+    tbl_["record_heap_ops"]         = handleRecordHeapOps;
     tbl_["state_live_ordering"]     = handleStateLiveOrdering;
+    tbl_["state_pruning_mode"]      = handleStatePruningMode;
+    tbl_["time_budget"]             = handleTimeBudget;
+    tbl_["timeline"]                = handleTimeline;
     tbl_["track_uninit"]            = handleTrackUninit;
+    tbl_["type_cmp_stats"]          = handleTypeCmpStats;
     tbl_["verifier_error_is_error"] = handleVerifierErrorIsError;
+    tbl_["vra_prepass"]             = handleVraPrepass;
 }
 
 void ConfigStringParser::handleRawOption(const string &raw) const
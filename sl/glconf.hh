@@ -23,6 +23,7 @@
 #include "config.h"
 
 #include <string>
+#include <vector>
 
 namespace FixedPoint {
     class StateByInsn;
@@ -44,8 +45,21 @@ struct Options {
     int intArithmeticLimit; ///< @copydoc config.h::SE_INT_ARITHMETIC_LIMIT
     int joinOnLoopEdgesOnly;///< @copydoc config.h::SE_JOIN_ON_LOOP_EDGES_ONLY
     int stateLiveOrdering;  ///< @copydoc config.h::SE_STATE_ON_THE_FLY_ORDERING
+    int statePruningMode;   ///< @copydoc config.h::SE_STATE_PRUNING_MODE
+    std::vector<int> absLenThr; ///< SE_COST<n>_LEN_THR indexed by the cost
     bool exitLeaks;         ///< @copydoc config.h::SE_EXIT_LEAKS
     bool detectContainers;  ///< detect containers and operations over them
+    int parallelDiscovery;  ///< @copydoc config.h::SE_PARALLEL_DISCOVERY
+    int partition;          ///< split the state space among forked processes
+    int callCacheWidenThr;  ///< @copydoc config.h::SE_CALL_CACHE_WIDEN_THR
+    std::string callCacheStatsFile; ///< dump call cache stats (JSON) there
+    bool typeCmpStats;      ///< print statistics of type comparisons at exit
+    std::string hotSpotsFile;   ///< profile hot spots, write collapsed stacks
+    std::string heapLogFile;    ///< record heap operations, write the log there
+    bool vraPrepass;        ///< prune paths by value ranges computed by vra
+    double timeBudget;      ///< degrade precision as the time runs out (sec)
+    unsigned memBudget;     ///< degrade precision as the memory runs out (MiB)
+    std::vector<std::string> builtInModels; ///< extra models of built-ins
     FixedPoint::StateByInsn *fixedPoint;  ///< fixed-point plotter (0 if unused)
 
     Options();
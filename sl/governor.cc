@@ -0,0 +1,186 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "governor.hh"
+
+#include <cl/cl_msg.hh>
+#include <cl/metrics.hh>
+#include <cl/timeline.hh>
+
+#include "glconf.hh"
+
+#include <cstdio>
+#include <sstream>
+
+#include <sys/resource.h>           // for getrusage()
+#include <unistd.h>                 // for sysconf()
+
+namespace Governor {
+
+/// tick() looks at the clock only once per this count of calls
+static const unsigned ticksPerCheck = 0x100;
+
+/// share of the budget that has to be used up to take the step of that level
+static const double thrByLevel[GL_TOTAL] = {
+    /* GL_NONE              */ 0.0,
+    /* GL_ABSTRACT          */ 0.5,
+    /* GL_JOIN_ALL_EDGES    */ 0.6,
+    /* GL_FORCE_PRUNING     */ 0.7,
+    /* GL_NO_UNINIT         */ 0.8,
+    /* GL_GIVE_UP           */ 1.0
+};
+
+static Metrics::Gauge       levelGauge("governor.level");
+
+static ELevel               curLevel;
+static double               epoch;
+static unsigned             cntTicks;
+
+bool enabled()
+{
+    return (0.0 < GlConf::data.timeBudget)
+        || (0U < GlConf::data.memBudget);
+}
+
+ELevel level()
+{
+    return curLevel;
+}
+
+void init()
+{
+    epoch = Timeline::wallClock();
+}
+
+/// resident set size of the process in MiB (peak RSS if current is N/A)
+static double residentMiB()
+{
+    FILE *fp = std::fopen("/proc/self/statm", "r");
+    if (fp) {
+        unsigned long cntPagesTotal, cntPagesResident;
+        const int rv = std::fscanf(fp, "%lu %lu",
+                &cntPagesTotal, &cntPagesResident);
+        std::fclose(fp);
+        if (2 == rv)
+            return cntPagesResident * (sysconf(_SC_PAGESIZE) / 1024.0) / 1024.0;
+    }
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0.0;
+
+    // ru_maxrss is given in KiB on Linux
+    return usage.ru_maxrss / 1024.0;
+}
+
+static const char* describeStep(const ELevel lv)
+{
+    switch (lv) {
+        case GL_ABSTRACT:
+            return "abstracting list segments regardless of their cost";
+
+        case GL_JOIN_ALL_EDGES:
+            return "joining heaps on all edges, not only on loop edges";
+
+        case GL_FORCE_PRUNING:
+            return "pruning states of all blocks but loop entries";
+
+        case GL_NO_UNINIT:
+            return "no longer tracking uninitialized values";
+
+        case GL_GIVE_UP:
+            return "giving up, the verdict is unknown";
+
+        case GL_NONE:
+        case GL_TOTAL:
+            break;
+    }
+
+    CL_BREAK_IF("invalid call of Governor::describeStep()");
+    return "?";
+}
+
+/// apply the global side effects of the step of the given level
+static void takeStep(const ELevel lv)
+{
+    GlConf::Options &data = GlConf::data;
+    switch (lv) {
+        case GL_JOIN_ALL_EDGES:
+            // see SE_JOIN_ON_LOOP_EDGES_ONLY in config.h
+            data.joinOnLoopEdgesOnly = 0;
+            break;
+
+        case GL_NO_UNINIT:
+            // SymExecCoreParams are initialized from GlConf per instruction
+            data.trackUninit = false;
+            break;
+
+        default:
+            // the others are queried by level() where they take effect
+            break;
+    }
+}
+
+ELevel tick()
+{
+    if (GL_GIVE_UP == curLevel || !enabled())
+        return curLevel;
+
+    if (++cntTicks < ticksPerCheck)
+        return curLevel;
+
+    cntTicks = 0U;
+
+    // share of the budgets used up so far (the higher one of the two wins)
+    const GlConf::Options &data = GlConf::data;
+    const double time = Timeline::wallClock() - epoch;
+    const double mem = residentMiB();
+    double used = 0.0;
+    if (0.0 < data.timeBudget)
+        used = time / data.timeBudget;
+    if (data.memBudget && used < mem / data.memBudget)
+        used = mem / data.memBudget;
+
+    while (curLevel < GL_GIVE_UP) {
+        const ELevel next = static_cast<ELevel>(curLevel + 1);
+        if (used < thrByLevel[next])
+            break;
+
+        std::ostringstream msg;
+        msg << "[governor] " << static_cast<int>(100.0 * used)
+            << "% of the budget used ("
+            << static_cast<unsigned>(time) << " s, "
+            << static_cast<unsigned>(mem) << " MiB), "
+            << describeStep(next);
+
+        if (GL_NO_UNINIT == next && data.trackUninit)
+            // uses of uninitialized values are no longer reported from now on,
+            // so the verdict is unknown even if the analysis completes
+            CL_WARN(msg.str() << ", the verdict is unknown");
+        else
+            CL_NOTE(msg.str());
+
+        takeStep(next);
+        curLevel = next;
+        levelGauge.set(curLevel);
+    }
+
+    return curLevel;
+}
+
+} // namespace Governor
@@ -0,0 +1,60 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_GOVERNOR_H
+#define H_GUARD_GOVERNOR_H
+
+/**
+ * @file governor.hh
+ * resource governor that trades precision of the analysis for time and memory
+ * once the budgets given by the time_budget and mem_budget options run short
+ */
+
+namespace Governor {
+
+/// degradation steps taken in this order as the budgets run out
+enum ELevel {
+    GL_NONE = 0,            ///< full precision
+    GL_ABSTRACT,            ///< abstract list segments regardless of their cost
+    GL_JOIN_ALL_EDGES,      ///< join heaps on all CFG edges, not only on loops
+    GL_FORCE_PRUNING,       ///< prune states of all blocks but loop entries
+    GL_NO_UNINIT,           ///< stop tracking uninitialized values (unsound)
+    GL_GIVE_UP,             ///< stop the analysis, its verdict is unknown
+    GL_TOTAL
+};
+
+/// true if any budget has been given by the run-time options
+bool enabled();
+
+/// the degradation level reached so far (it never goes down)
+ELevel level();
+
+/// start measuring the time budget, called once the options are loaded
+void init();
+
+/**
+ * compare the resources used so far with the budgets and take the degradation
+ * steps whose thresholds have been crossed (each step is reported as a note,
+ * or as a warning saying that the verdict is unknown if the step is unsound),
+ * the clock is looked at only once per a fixed count of calls
+ * @return the degradation level reached so far
+ */
+ELevel tick();
+
+} // namespace Governor
+
+#endif /* H_GUARD_GOVERNOR_H */
@@ -0,0 +1,481 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "heaplog.hh"
+
+#include <cl/cl_msg.hh>
+#include <cl/storage.hh>
+#include <cl/timeline.hh>
+
+#include "glconf.hh"
+#include "symbt.hh"
+#include "symheap.hh"
+#include "symseg.hh"
+#include "symutil.hh"
+#include "util.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <set>
+
+namespace HeapLog {
+
+const char* opName(const EHeapOp op)
+{
+    switch (op) {
+        case HO_JOIN:       return "joinSymHeaps";
+        case HO_COMPARE:    return "areEqual";
+        case HO_ABSTRACT:   return "abstractIfNeeded";
+        case HO_TOTAL:      break;
+    }
+
+    return "?";
+}
+
+int opArity(const EHeapOp op)
+{
+    return (HO_ABSTRACT == op) ? 1 : 2;
+}
+
+bool enabled()
+{
+    return !GlConf::data.heapLogFile.empty();
+}
+
+int countObjects(const SymHeap &sh)
+{
+    TObjList objs;
+    sh.gatherObjects(objs);
+    return objs.size();
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// the log file shared by all recorded calls
+static FILE                    *logFile;
+static bool                     logFailed;
+static unsigned long            cntCalls;
+static unsigned long            cntBytes;
+static std::set<cl_uid_t>       typesWritten;
+static std::set<cl_uid_t>       varsWritten;
+
+/// depth of recorded calls in progress (we record only the outermost ones)
+static int                      callDepth;
+
+static bool openLog()
+{
+    if (logFile)
+        return true;
+
+    if (logFailed)
+        return false;
+
+    const std::string &fileName = GlConf::data.heapLogFile;
+    logFile = fopen(fileName.c_str(), "wb");
+    if (!logFile) {
+        CL_ERROR("unable to create file '" << fileName << "'");
+        logFailed = true;
+        return false;
+    }
+
+    static const char magic[] = HEAP_LOG_MAGIC;
+    fwrite(magic, 1U, sizeof magic - 1U, logFile);
+    cntBytes = sizeof magic - 1U;
+    return true;
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// encoding of records
+static void putU(std::string &buf, unsigned long long num)
+{
+    // LEB128
+    while (0x80 <= num) {
+        buf.push_back(static_cast<char>(0x80 | (num & 0x7f)));
+        num >>= 7;
+    }
+
+    buf.push_back(static_cast<char>(num));
+}
+
+static void putS(std::string &buf, const long long num)
+{
+    // zigzag, so that small negative numbers are encoded by a single byte
+    const unsigned long long un = num;
+    putU(buf, (un << 1) ^ ((num < 0) ? ~0ULL : 0ULL));
+}
+
+static void putStr(std::string &buf, const char *str)
+{
+    const size_t len = (str) ? strlen(str) : 0U;
+    putU(buf, len);
+    buf.append(str, len);
+}
+
+static void putTag(std::string &buf, const EHeapLogTag tag)
+{
+    buf.push_back(static_cast<char>(tag));
+}
+
+static void putTypeRef(std::string &buf, const TObjType clt)
+{
+    putS(buf, (clt) ? clt->uid : -1);
+}
+
+static void putRange(std::string &buf, const IR::Range &rng)
+{
+    putS(buf, rng.lo);
+    putS(buf, rng.hi);
+    putS(buf, rng.alignment);
+}
+
+/// write the type (and the types it consists of) unless written already
+static void writeType(std::string &buf, const TObjType clt)
+{
+    if (!clt || !insertOnce(typesWritten, clt->uid))
+        return;
+
+    // the nested types go first unless they refer back to this one
+    for (int i = 0; i < clt->item_cnt; ++i)
+        writeType(buf, clt->items[i].type);
+
+    putTag(buf, HL_TYPE);
+    putS(buf, clt->uid);
+    putU(buf, clt->code);
+    putS(buf, clt->size);
+    putStr(buf, clt->name);
+    putU(buf, clt->is_unsigned | (clt->is_const << 1));
+    putU(buf, clt->ptr_type);
+    putS(buf, clt->array_size);
+    putU(buf, clt->item_cnt);
+    for (int i = 0; i < clt->item_cnt; ++i) {
+        const struct cl_type_item &item = clt->items[i];
+        putTypeRef(buf, item.type);
+        putStr(buf, item.name);
+        putS(buf, item.offset);
+    }
+}
+
+static void writeVar(std::string &buf, const CodeStorage::Var &var)
+{
+    if (!insertOnce(varsWritten, var.uid))
+        return;
+
+    writeType(buf, var.type);
+
+    putTag(buf, HL_VAR);
+    putS(buf, var.uid);
+    putU(buf, var.code);
+    putTypeRef(buf, var.type);
+    putStr(buf, var.name.c_str());
+    putS(buf, var.denseIdx);
+    putS(buf, var.fncIdx);
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// serialization of a heap as the sequence of mutations that rebuilds it
+class HeapWriter {
+    public:
+        HeapWriter(std::string &buf, const SymHeap &sh):
+            buf_(buf),
+            sh_(const_cast<SymHeap &>(sh))
+        {
+        }
+
+        void write();
+
+    private:
+        void writeObject(TObjId obj);
+        void writeValue(TValId val);
+        void writeFields(TObjId obj);
+        void writePreds();
+
+        std::string                &buf_;
+        SymHeap                    &sh_;
+        std::set<TObjId>            objs_;
+        std::set<TValId>            vals_;
+};
+
+void HeapWriter::writeObject(const TObjId obj)
+{
+    if (obj <= OBJ_RETURN || !insertOnce(objs_, obj))
+        // special object IDs always match
+        return;
+
+    const bool valid = sh_.isValid(obj);
+    CallInst from(-1, -1);
+    if (sh_.isAnonStackObj(obj, &from)) {
+        putTag(buf_, HL_OBJ_STACK);
+        putS(buf_, obj);
+        putRange(buf_, sh_.objSize(obj));
+        putS(buf_, from.uid);
+        putS(buf_, from.inst);
+    }
+    else if (isProgramVar(sh_.objStorClass(obj))) {
+        const CVar cv = sh_.cVarByObject(obj);
+        writeVar(buf_, sh_.stor().vars[cv.uid]);
+        putTag(buf_, HL_OBJ_VAR);
+        putS(buf_, obj);
+        putS(buf_, cv.uid);
+        putS(buf_, cv.inst);
+    }
+    else {
+        putTag(buf_, HL_OBJ_HEAP);
+        putS(buf_, obj);
+        putRange(buf_, sh_.objSize(obj));
+    }
+
+    if (!valid) {
+        putTag(buf_, HL_OBJ_INVALIDATE);
+        putS(buf_, obj);
+    }
+
+    const TObjType clt = sh_.objEstimatedType(obj);
+    writeType(buf_, clt);
+
+    putTag(buf_, HL_OBJ_META);
+    putS(buf_, obj);
+    putTypeRef(buf_, clt);
+    putS(buf_, sh_.objProtoLevel(obj));
+
+    const EObjKind kind = sh_.objKind(obj);
+    putU(buf_, kind);
+    if (OK_REGION == kind)
+        return;
+
+    const BindingOff off = (OK_OBJ_OR_NULL == kind)
+        ? BindingOff(OK_OBJ_OR_NULL)
+        : sh_.segBinding(obj);
+
+    putS(buf_, off.head);
+    putS(buf_, off.next);
+    putS(buf_, off.prev);
+    putS(buf_, objMinLength(sh_, obj));
+}
+
+void HeapWriter::writeValue(const TValId val)
+{
+    if (val <= 0 || hasKey(vals_, val))
+        // special value IDs always match
+        return;
+
+    const EValueTarget code = sh_.valTarget(val);
+    if (VT_CUSTOM == code) {
+        const CustomValue &cv = sh_.valUnwrapCustom(val);
+        putTag(buf_, HL_VAL_CUSTOM);
+        putS(buf_, val);
+        putU(buf_, cv.code());
+        switch (cv.code()) {
+            case CV_FNC:
+                putS(buf_, cv.uid());
+                break;
+
+            case CV_INT_RANGE:
+                putRange(buf_, cv.rng());
+                break;
+
+            case CV_REAL: {
+                const double fpn = cv.fpn();
+                unsigned long long bits;
+                memcpy(&bits, &fpn, sizeof bits);
+                putU(buf_, bits);
+                break;
+            }
+
+            case CV_STRING:
+                putStr(buf_, cv.str().c_str());
+                break;
+
+            case CV_INVALID:
+                CL_BREAK_IF("invalid custom value in HeapWriter::writeValue()");
+        }
+    }
+    else if (isAnyDataArea(code)) {
+        const TObjId obj = sh_.objByAddr(val);
+        this->writeObject(obj);
+
+        const ETargetSpecifier ts = sh_.targetSpec(val);
+        if (VT_RANGE == code) {
+            putTag(buf_, HL_VAL_RANGE);
+            putS(buf_, val);
+            putS(buf_, obj);
+            putU(buf_, ts);
+            putRange(buf_, sh_.valOffsetRange(val));
+        }
+        else {
+            putTag(buf_, HL_VAL_ADDR);
+            putS(buf_, val);
+            putS(buf_, obj);
+            putU(buf_, ts);
+            putS(buf_, sh_.valOffset(val));
+        }
+    }
+    else {
+        putTag(buf_, HL_VAL_UNKNOWN);
+        putS(buf_, val);
+        putU(buf_, code);
+        putU(buf_, sh_.valOrigin(val));
+    }
+
+    vals_.insert(val);
+}
+
+void HeapWriter::writeFields(const TObjId obj)
+{
+    TUniBlockMap blocks;
+    sh_.gatherUniformBlocks(blocks, obj);
+    for (TUniBlockMap::const_reference item : blocks) {
+        const UniformBlock &bl = item.second;
+        this->writeValue(bl.tplValue);
+        putTag(buf_, HL_UNI_BLOCK);
+        putS(buf_, obj);
+        putS(buf_, bl.off);
+        putS(buf_, bl.size);
+        putS(buf_, bl.tplValue);
+    }
+
+    FldList fields;
+    sh_.gatherLiveFields(fields, obj);
+    for (const FldHandle &fld : fields) {
+        const TObjType clt = fld.type();
+        if (isComposite(clt, /* includingArray */ false))
+            continue;
+
+        const TValId val = fld.value();
+        this->writeValue(val);
+        writeType(buf_, clt);
+        putTag(buf_, HL_FIELD);
+        putS(buf_, obj);
+        putS(buf_, fld.offset());
+        putTypeRef(buf_, clt);
+        putS(buf_, val);
+    }
+}
+
+void HeapWriter::writePreds()
+{
+    for (const TValId val : vals_) {
+        TValList related;
+        sh_.gatherRelatedValues(related, val);
+        for (const TValId other : related) {
+            if (0 < other && (other < val || !hasKey(vals_, other)))
+                // written already, or not reachable in the heap
+                continue;
+
+            if (!sh_.chkNeq(val, other))
+                continue;
+
+            putTag(buf_, HL_NEQ);
+            putS(buf_, val);
+            putS(buf_, other);
+        }
+    }
+}
+
+void HeapWriter::write()
+{
+    putTag(buf_, HL_HEAP);
+
+    // objects first, in the order of their IDs
+    TObjList live;
+    sh_.gatherObjects(live);
+    for (const TObjId obj : live)
+        this->writeObject(obj);
+
+    const TObjType cltRet = sh_.objEstimatedType(OBJ_RETURN);
+    if (cltRet) {
+        writeType(buf_, cltRet);
+        putTag(buf_, HL_OBJ_META);
+        putS(buf_, OBJ_RETURN);
+        putTypeRef(buf_, cltRet);
+        putS(buf_, /* proto level */ 0);
+        putU(buf_, OK_REGION);
+        this->writeFields(OBJ_RETURN);
+    }
+
+    // then their contents
+    for (const TObjId obj : live)
+        this->writeFields(obj);
+
+    this->writePreds();
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// implementation of CallRecorder
+CallRecorder::CallRecorder(
+        const EHeapOp               op,
+        const SymHeap              &sh1,
+        const SymHeap              *sh2,
+        const int                   flags):
+    op_(op),
+    flags_(flags),
+    result_(-1),
+    active_(false),
+    start_(0.0)
+{
+    if (!enabled() || 1 < ++callDepth)
+        return;
+
+    if (sh2 && !areEqual(sh1.exitPoint(), sh2->exitPoint()))
+        // the exit points are not recorded, such calls are trivial anyway
+        return;
+
+    if (!openLog())
+        return;
+
+    HeapWriter(buf_, sh1).write();
+    if (sh2)
+        HeapWriter(buf_, *sh2).write();
+
+    active_ = true;
+    start_ = Timeline::wallClock();
+}
+
+CallRecorder::~CallRecorder()
+{
+    if (enabled())
+        --callDepth;
+
+    if (!active_)
+        return;
+
+    const double time = Timeline::wallClock() - start_;
+    putTag(buf_, HL_CALL);
+    putU(buf_, op_);
+    putS(buf_, flags_);
+    putS(buf_, result_);
+    putU(buf_, static_cast<unsigned long long>(1e9 * time));
+
+    // write the whole call at once, so that the log stays usable on crash
+    fwrite(buf_.data(), 1U, buf_.size(), logFile);
+    fflush(logFile);
+    cntBytes += buf_.size();
+    ++cntCalls;
+}
+
+void dump()
+{
+    if (!logFile)
+        return;
+
+    fclose(logFile);
+    logFile = 0;
+
+    CL_NOTE("[HeapLog] " << cntCalls << " calls (" << cntBytes
+            << " bytes) recorded to '" << GlConf::data.heapLogFile << "'");
+}
+
+} // namespace HeapLog
@@ -0,0 +1,126 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_HEAPLOG_H
+#define H_GUARD_HEAPLOG_H
+
+/**
+ * @file heaplog.hh
+ * opt-in recorder of joins, comparisons, and abstractions of symbolic heaps
+ * (see record_heap_ops option), and the binary format shared with the
+ * standalone replayer (symheap-replay)
+ */
+
+#include <string>
+
+class SymHeap;
+
+namespace HeapLog {
+
+/// magic bytes at the beginning of each log, the last one is format version
+#define HEAP_LOG_MAGIC "PRDHLOG\x01"
+
+/**
+ * The log is a sequence of records, each of them starts with a tag byte
+ * (EHeapLogTag) followed by its operands.  Integers are stored as LEB128,
+ * signed integers zigzag-encoded first, strings are prefixed by their length.
+ *
+ * Type-info and variables are written once per log, the first time they are
+ * referenced.  Each recorded call is preceded by the input heaps, each of them
+ * serialized as the sequence of SymHeap mutations that rebuilds it.  Objects
+ * and values are referred to by their IDs in the recorded heap.
+ */
+enum EHeapLogTag {
+    HL_INVALID = 0,
+    HL_TYPE,                ///< uid, code, size, name, flags, array size, items
+    HL_VAR,                 ///< uid, code, type, name, dense index, fnc index
+    HL_HEAP,                ///< start a new input heap of the next call
+    HL_OBJ_VAR,             ///< obj, regionByVar(uid, inst)
+    HL_OBJ_STACK,           ///< obj, stackAlloc(size, fnc uid, inst)
+    HL_OBJ_HEAP,            ///< obj, heapAlloc(size)
+    HL_OBJ_META,            ///< obj, estimated type, proto level, kind, ...
+    HL_OBJ_INVALIDATE,      ///< obj, objInvalidate()
+    HL_VAL_ADDR,            ///< val, addrOfTarget(obj, ts, off)
+    HL_VAL_RANGE,           ///< val, valByRange(addrOfTarget(obj, ts), rng)
+    HL_VAL_CUSTOM,          ///< val, valWrapCustom(code, payload)
+    HL_VAL_UNKNOWN,         ///< val, valCreate(code, origin)
+    HL_FIELD,               ///< obj, off, type, val
+    HL_UNI_BLOCK,           ///< obj, off, size, template val
+    HL_NEQ,                 ///< val, val
+    HL_CALL                 ///< op, flags, result, recorded time in ns
+};
+
+/// recorded operations
+enum EHeapOp {
+    HO_JOIN = 0,            ///< joinSymHeaps(sh1, sh2), result is the status
+    HO_COMPARE,             ///< areEqual(sh1, sh2), result is 0/1
+    HO_ABSTRACT,            ///< abstractIfNeeded(sh), result is count of objs
+    HO_TOTAL
+};
+
+/// name of the recorded operation
+const char* opName(EHeapOp);
+
+/// count of input heaps of the recorded operation
+int opArity(EHeapOp);
+
+/// true if the recorder has been enabled by the record_heap_ops option
+bool enabled();
+
+/**
+ * record a call of the given operation in scope (if the recorder is on)
+ *
+ * The input heaps are serialized by the constructor, the call itself is timed
+ * from the end of the constructor to the destructor.  Calls nested in another
+ * recorded call are not recorded.
+ */
+class CallRecorder {
+    public:
+        CallRecorder(
+                EHeapOp                 op,
+                const SymHeap          &sh1,
+                const SymHeap          *sh2 = 0,
+                int                     flags = 0);
+
+        ~CallRecorder();
+
+        /// the result to be checked by the replayer
+        void setResult(int result) {
+            result_ = result;
+        }
+
+    private:
+        CallRecorder(const CallRecorder &);
+        CallRecorder& operator=(const CallRecorder &);
+
+        const EHeapOp           op_;
+        const int               flags_;
+        int                     result_;
+        std::string             buf_;
+        bool                    active_;
+        double                  start_;
+};
+
+/// count of the objects in the given heap (the result of HO_ABSTRACT)
+int countObjects(const SymHeap &sh);
+
+/// close the log and report how many calls have been recorded (if enabled)
+void dump();
+
+} // namespace HeapLog
+
+#endif /* H_GUARD_HEAPLOG_H */
@@ -0,0 +1,458 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "partition.hh"
+
+#include <cl/cl_msg.hh>
+
+#include "glconf.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#   include <sys/prctl.h>
+#endif
+
+namespace Partition {
+
+/// exit codes of the worker processes
+enum EExitCode {
+    EC_COMPLETE = 0,        ///< the analysis of the slice has completed
+    EC_STOPPED,             ///< the analysis has been stopped by an exception
+    EC_DIED                 ///< the analysis has died on a fatal error
+};
+
+/// kinds of messages sent by the workers over the pipes
+enum EMsgKind {
+    MK_DEBUG = 0,
+    MK_WARN,
+    MK_ERROR,
+    MK_NOTE
+};
+
+static unsigned             budget = 1U;
+static bool                 primary = true;
+static bool                 worker = false;
+static int                  msgFd = -1;
+
+void init()
+{
+    const int cnt = GlConf::data.partition;
+    budget = (1 < cnt) ? cnt : 1;
+}
+
+bool enabled()
+{
+    return (1U < budget);
+}
+
+bool isPrimary()
+{
+    return primary;
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// worker side
+static bool sendAll(const int fd, const void *buf, size_t len)
+{
+    const char *ptr = static_cast<const char *>(buf);
+    while (len) {
+        const ssize_t written = write(fd, ptr, len);
+        if (written < 0 && EINTR == errno)
+            continue;
+        if (written <= 0)
+            return false;
+
+        ptr += written;
+        len -= written;
+    }
+
+    return true;
+}
+
+static void sendMsg(const EMsgKind kind, const char *msg)
+{
+    // serialize as (kind, len, text)
+    const int hdr[/* kind, len */ 2] = { kind, static_cast<int>(strlen(msg)) };
+    if (!sendAll(msgFd, hdr, sizeof hdr) || !sendAll(msgFd, msg, hdr[1]))
+        // the waiting process is gone, nobody is interested in our results
+        _exit(EC_DIED);
+}
+
+static void sendDebug(const char *msg)
+{
+    sendMsg(MK_DEBUG, msg);
+}
+
+static void sendWarn(const char *msg)
+{
+    sendMsg(MK_WARN, msg);
+}
+
+static void sendError(const char *msg)
+{
+    sendMsg(MK_ERROR, msg);
+}
+
+static void sendNote(const char *msg)
+{
+    sendMsg(MK_NOTE, msg);
+}
+
+static void sendDie(const char *msg)
+{
+    sendMsg(MK_ERROR, msg);
+    _exit(EC_DIED);
+}
+
+/// route all messages of this process to the given pipe
+static void becomeWorker(const int fd, const pid_t parent)
+{
+#ifdef __linux__
+    // do not outlive the waiting process, e.g. if it is killed on a timeout
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != parent)
+        // the waiting process has died before prctl() took effect
+        _exit(EC_DIED);
+#else
+    (void) parent;
+#endif
+
+    if (worker)
+        // we have been forked by a worker, do not hold the pipe of our parent
+        close(msgFd);
+
+    worker = true;
+    msgFd = fd;
+
+    struct cl_init_data init;
+    init.debug          = sendDebug;
+    init.warn           = sendWarn;
+    init.error          = sendError;
+    init.note           = sendNote;
+    init.die            = sendDie;
+    init.debug_level    = cl_debug_level();
+    cl_global_init(&init);
+
+    // profiles and logs cover only the work done before the first split
+    GlConf::data.hotSpotsFile.clear();
+    GlConf::data.heapLogFile.clear();
+}
+
+void leaveIfWorker(const bool complete)
+{
+    if (!worker)
+        return;
+
+    std::cout.flush();
+    std::cerr.flush();
+    _exit((complete) ? EC_COMPLETE : EC_STOPPED);
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// the waiting side
+typedef std::pair<EMsgKind, std::string>            TMsg;
+typedef std::vector<TMsg>                           TMsgList;
+
+struct Worker {
+    pid_t                   pid;
+    int                     fd;
+    std::string             buf;        ///< bytes of an incomplete message
+    TMsgList                group;      ///< a message and its notes so far
+
+    Worker(const pid_t pid_, const int fd_):
+        pid(pid_),
+        fd(fd_)
+    {
+    }
+};
+
+typedef std::vector<Worker>                         TWorkerList;
+
+/// deserialize the complete messages, return false on a protocol error
+static bool parseMsgs(TMsgList &dst, std::string &buf)
+{
+    const size_t size = buf.size();
+    size_t pos = 0;
+    while (pos < size) {
+        int hdr[/* kind, len */ 2];
+        if (size < pos + sizeof hdr)
+            break;
+
+        memcpy(hdr, buf.data() + pos, sizeof hdr);
+        const int kind = hdr[0];
+        const int len = hdr[1];
+        if (kind < MK_DEBUG || MK_NOTE < kind || len < 0)
+            return false;
+
+        if (size < pos + sizeof hdr + len)
+            // the rest of the message has not arrived yet
+            break;
+
+        pos += sizeof hdr;
+        dst.push_back(TMsg(static_cast<EMsgKind>(kind), buf.substr(pos, len)));
+        pos += len;
+    }
+
+    buf.erase(0, pos);
+    return true;
+}
+
+static void emitMsg(const TMsg &msg)
+{
+    const char *text = msg.second.c_str();
+    switch (msg.first) {
+        case MK_DEBUG:  cl_debug(text); break;
+        case MK_WARN:   cl_warn(text);  break;
+        case MK_ERROR:  cl_error(text); break;
+        case MK_NOTE:   cl_note(text);  break;
+    }
+}
+
+typedef std::set<std::string>                       TSeenSet;
+
+/// emit a message and the notes that follow it unless emitted already
+static void flushGroup(TMsgList &group, TSeenSet &seen)
+{
+    if (group.empty())
+        return;
+
+    std::string key;
+    for (const TMsg &msg : group) {
+        key += static_cast<char>('0' + msg.first);
+        key += msg.second;
+        key += '\n';
+    }
+
+    // debug messages are not deduplicated
+    if (MK_DEBUG == group.front().first || seen.insert(key).second)
+        for (const TMsg &msg : group)
+            emitMsg(msg);
+
+    group.clear();
+}
+
+/// emit the messages of a worker as soon as the notes that follow them are known
+static bool readOutput(Worker &w, TSeenSet &seen)
+{
+    char chunk[0x1000];
+    const ssize_t got = read(w.fd, chunk, sizeof chunk);
+    if (got < 0 && EINTR == errno)
+        return true;
+
+    if (got <= 0) {
+        // end of output (or a broken pipe)
+        flushGroup(w.group, seen);
+        return false;
+    }
+
+    w.buf.append(chunk, got);
+    TMsgList msgs;
+    if (!parseMsgs(msgs, w.buf)) {
+        CL_WARN("Partition::readOutput() got garbage from a worker");
+        w.buf.clear();
+    }
+
+    for (const TMsg &msg : msgs) {
+        if (MK_NOTE != msg.first)
+            flushGroup(w.group, seen);
+
+        w.group.push_back(msg);
+    }
+
+    return true;
+}
+
+/// wait for a worker that has closed its pipe, return its exit code
+static int reapWorker(Worker &w)
+{
+    close(w.fd);
+    w.fd = -1;
+
+    int status;
+    while (waitpid(w.pid, &status, 0) < 0)
+        if (EINTR != errno)
+            return EC_DIED;
+
+    return (WIFEXITED(status))
+        ? WEXITSTATUS(status)
+        : EC_DIED;
+}
+
+/**
+ * emit the messages of the workers as they arrive, and throw once the workers
+ * are done.  If any worker stops or dies, the others are killed right away
+ * because the verdict cannot be complete anyway.
+ */
+static void collectWorkers(TWorkerList &workers)
+{
+    TSeenSet seen;
+    bool stopped = false;
+    bool failed = false;
+
+    const unsigned cnt = workers.size();
+    unsigned cntRunning = cnt;
+    while (cntRunning && !stopped && !failed) {
+        std::vector<struct pollfd> pfds;
+        std::vector<unsigned> idxOf;
+        for (unsigned i = 0; i < cnt; ++i) {
+            if (workers[i].fd < 0)
+                continue;
+
+            struct pollfd pfd;
+            pfd.fd = workers[i].fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            pfds.push_back(pfd);
+            idxOf.push_back(i);
+        }
+
+        if (poll(&pfds[0], pfds.size(), /* no timeout */ -1) < 0) {
+            if (EINTR == errno)
+                continue;
+
+            CL_BREAK_IF("Partition::collectWorkers() failed to poll");
+            failed = true;
+            break;
+        }
+
+        for (unsigned j = 0; j < pfds.size(); ++j) {
+            if (!pfds[j].revents)
+                continue;
+
+            Worker &w = workers[idxOf[j]];
+            if (readOutput(w, seen))
+                continue;
+
+            --cntRunning;
+            switch (reapWorker(w)) {
+                case EC_COMPLETE:
+                    break;
+
+                case EC_STOPPED:
+                    stopped = true;
+                    break;
+
+                default:
+                    failed = true;
+            }
+        }
+    }
+
+    for (Worker &w : workers) {
+        if (w.fd < 0)
+            continue;
+
+        // the workers forked by this one die with it (see becomeWorker())
+        kill(w.pid, SIGKILL);
+        reapWorker(w);
+        flushGroup(w.group, seen);
+    }
+
+    if (failed)
+        CL_WARN("a worker process of the partitioned analysis has failed, "
+                "the verdict is unknown");
+
+    if (failed || stopped)
+        throw std::runtime_error("a worker process has not completed");
+
+    throw Delegated();
+}
+
+Slice split(const unsigned cntParts)
+{
+    Slice slice = { /* idx */ 0U, /* cnt */ 1U };
+    if (!enabled() || cntParts < 2U)
+        return slice;
+
+    const unsigned cnt = std::min(cntParts, budget);
+
+    // flush the output streams before they get duplicated by fork()
+    std::cout.flush();
+    std::cerr.flush();
+
+    const pid_t self = getpid();
+    TWorkerList workers;
+    for (unsigned i = 0; i < cnt; ++i) {
+        int pfd[2];
+        if (pipe(pfd))
+            break;
+
+        const pid_t pid = fork();
+        if (pid < 0) {
+            close(pfd[0]);
+            close(pfd[1]);
+            break;
+        }
+
+        if (!pid) {
+            // worker process
+            close(pfd[0]);
+            for (const Worker &w : workers)
+                close(w.fd);
+
+            becomeWorker(pfd[1], self);
+
+            // distribute the count of processes we are allowed to use
+            budget = budget / cnt + ((i < budget % cnt) ? 1U : 0U);
+            if (i)
+                // the pending work is kept by the first worker
+                primary = false;
+
+            slice.idx = i;
+            slice.cnt = cnt;
+            return slice;
+        }
+
+        close(pfd[1]);
+        workers.push_back(Worker(pid, pfd[0]));
+    }
+
+    if (workers.size() < cnt) {
+        // the parts of missing workers would not be explored by anyone
+        CL_DEBUG("Partition::split() failed to fork, not splitting any more");
+        for (const Worker &w : workers) {
+            kill(w.pid, SIGKILL);
+            close(w.fd);
+            waitpid(w.pid, 0, 0);
+        }
+
+        budget = 1U;
+        return slice;
+    }
+
+    CL_DEBUG("Partition::split() has forked " << cnt << " workers");
+    collectWorkers(workers);
+
+    // collectWorkers() always throws
+    abort();
+}
+
+} // namespace Partition
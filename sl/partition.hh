@@ -0,0 +1,85 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_PARTITION_H
+#define H_GUARD_PARTITION_H
+
+/**
+ * @file partition.hh
+ * partitioning of the state space of a single analysis among forked processes
+ * (see the partition option)
+ *
+ * At a nondeterministic branch point, the process that is about to split the
+ * work forks a worker per part and waits for them.  The workers inherit the
+ * whole state of the analysis.  Each of them explores its own part of the
+ * heaps at the branch point, and the first one also keeps all the other work
+ * that was pending at the time of the split.  The messages of the workers come
+ * back over pipes, and the waiting process emits each of them just once as
+ * soon as it arrives.  Once a worker stops or dies, the others are killed.
+ */
+
+#include <stdexcept>
+
+namespace Partition {
+
+/// parts of the work that the current process is supposed to explore
+struct Slice {
+    unsigned    idx;        ///< index of this process among the workers
+    unsigned    cnt;        ///< count of the workers the work is split among
+
+    /// true if the part of the given index belongs to this process
+    bool owns(const unsigned part) const {
+        return idx == part % cnt;
+    }
+};
+
+/// thrown by the process that has split its work once all workers are done
+class Delegated: public std::runtime_error {
+    public:
+        Delegated():
+            std::runtime_error("the work has been done by forked workers")
+        {
+        }
+};
+
+/// read the count of processes allowed by the partition option
+void init();
+
+/// true if this process is allowed to split its work among new processes
+bool enabled();
+
+/// false if this process explores only a part of the work since a split
+bool isPrimary();
+
+/**
+ * split the work consisting of the given count of parts among forked workers
+ * @return the slice to explore (all parts if nothing has been forked)
+ * @note in the process that has forked the workers, this function does not
+ * return.  It waits for the workers, emits their messages, and throws
+ * Delegated (or std::runtime_error if any of the workers has not completed).
+ */
+Slice split(unsigned cntParts);
+
+/**
+ * terminate the process if it is a forked worker
+ * @param complete false if the analysis has been stopped by an exception
+ */
+void leaveIfWorker(bool complete);
+
+} // namespace Partition
+
+#endif /* H_GUARD_PARTITION_H */
@@ -0,0 +1,298 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "profiler.hh"
+
+#include <cl/cl_msg.hh>
+#include <cl/storage.hh>
+
+#include "glconf.hh"
+#include "symbt.hh"
+#include "symutil.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace Profiler {
+
+/// count and total wall-clock time of events of a single kind
+struct Counter {
+    unsigned long               cnt;
+    double                      time;
+
+    Counter():
+        cnt(0UL),
+        time(0.0)
+    {
+    }
+
+    void add(const Counter &other) {
+        cnt  += other.cnt;
+        time += other.time;
+    }
+};
+
+/// events accounted to a single instruction, location, block, or function
+struct Stats {
+    Counter                     ev[PE_TOTAL];
+    unsigned                    peakState;
+
+    Stats():
+        peakState(0U)
+    {
+    }
+
+    double totalTime() const {
+        return ev[PE_EXEC].time + ev[PE_JOIN].time + ev[PE_ABSTRACT].time;
+    }
+
+    void add(const Stats &other) {
+        for (int i = 0; i < PE_TOTAL; ++i)
+            ev[i].add(other.ev[i]);
+
+        peakState = std::max(peakState, other.peakState);
+    }
+};
+
+typedef const CodeStorage::Insn                            *TInsn;
+typedef const CodeStorage::Block                           *TBlock;
+typedef std::pair<TInsn, EEvent>                            TLeaf;
+typedef std::map<TLeaf, Counter>                            TLeafMap;
+typedef std::map<std::string /* stack */, TLeafMap>         TStackMap;
+
+static std::map<TInsn, Stats>       statsByInsn;
+static std::map<TBlock, unsigned>   peakStateByBlock;
+static TStackMap                    statsByStack;
+static double                       accountedTotal;
+
+bool enabled()
+{
+    return !GlConf::data.hotSpotsFile.empty();
+}
+
+double accountedTime()
+{
+    return accountedTotal;
+}
+
+std::string stackOf(const SymBackTrace &bt)
+{
+    std::string stack;
+
+    for (unsigned depth = bt.size(); 0U < depth; --depth) {
+        if (!stack.empty())
+            stack += ';';
+
+        const CodeStorage::Fnc *fnc = bt.fncAt(depth - 1U);
+        stack += nameOf(*fnc);
+    }
+
+    return stack;
+}
+
+void account(
+        const EEvent                ev,
+        const std::string          &stack,
+        const CodeStorage::Insn    &insn,
+        const double                time)
+{
+    Counter &cnt = statsByInsn[&insn].ev[ev];
+    cnt.cnt  += 1UL;
+    cnt.time += time;
+
+    Counter &cntByStack = statsByStack[stack][TLeaf(&insn, ev)];
+    cntByStack.cnt  += 1UL;
+    cntByStack.time += time;
+
+    accountedTotal += time;
+}
+
+void updatePeakState(const CodeStorage::Block *bb, const unsigned cntHeaps)
+{
+    unsigned &peak = peakStateByBlock[bb];
+    peak = std::max(peak, cntHeaps);
+}
+
+/// name of the function on top of a collapsed stack
+static std::string topOfStack(const std::string &stack)
+{
+    const std::string::size_type pos = stack.rfind(';');
+    return (std::string::npos == pos)
+        ? stack
+        : stack.substr(pos + 1U);
+}
+
+/// "file:line" of the given location
+static std::string locToString(const struct cl_loc &loc)
+{
+    std::ostringstream str;
+    str << ((loc.file) ? loc.file : "?") << ":" << loc.line;
+    return str.str();
+}
+
+template <class TKey>
+struct StatsItem {
+    TKey                        key;
+    Stats                       stats;
+};
+
+template <class TKey>
+bool operator<(const StatsItem<TKey> &a, const StatsItem<TKey> &b)
+{
+    // the most expensive items go first
+    return b.stats.totalTime() < a.stats.totalTime();
+}
+
+template <class TKey>
+static void sortStats(
+        std::vector<StatsItem<TKey> >          &dst,
+        const std::map<TKey, Stats>            &src)
+{
+    for (typename std::map<TKey, Stats>::const_reference item : src) {
+        const StatsItem<TKey> si = { item.first, item.second };
+        dst.push_back(si);
+    }
+
+    std::stable_sort(dst.begin(), dst.end());
+}
+
+static std::string describe(const Stats &stats)
+{
+    std::ostringstream str;
+    str << std::fixed << std::setprecision(3)
+        << stats.totalTime() << " s total"
+        << ", " << stats.ev[PE_EXEC].cnt << " insn execs ("
+        << stats.ev[PE_EXEC].time << " s)"
+        << ", " << stats.ev[PE_JOIN].cnt << " joins ("
+        << stats.ev[PE_JOIN].time << " s)"
+        << ", " << stats.ev[PE_ABSTRACT].cnt << " abstractions ("
+        << stats.ev[PE_ABSTRACT].time << " s)";
+
+    if (stats.peakState)
+        str << ", peak state " << stats.peakState << " heaps";
+
+    return str.str();
+}
+
+/// count of items per category included in the report
+static const unsigned maxReportItems = 16U;
+
+static void printReport()
+{
+    typedef std::pair<std::string, int /* line */> TLoc;
+    std::map<TLoc, Stats> byLoc;
+    std::map<TLoc, TInsn> insnByLoc;
+    std::map<TBlock, Stats> byBlock;
+    for (std::map<TInsn, Stats>::const_reference item : statsByInsn) {
+        const TInsn insn = item.first;
+        const TLoc loc(locToString(insn->loc), insn->loc.line);
+        byLoc[loc].add(item.second);
+        insnByLoc.insert(std::make_pair(loc, insn));
+        byBlock[insn->bb].add(item.second);
+    }
+
+    for (std::map<TBlock, unsigned>::const_reference item : peakStateByBlock)
+        byBlock[item.first].peakState = item.second;
+
+    std::map<std::string, Stats> byFnc;
+    for (TStackMap::const_reference item : statsByStack) {
+        Stats &stats = byFnc[topOfStack(item.first)];
+        for (TLeafMap::const_reference leaf : item.second) {
+            const EEvent ev = leaf.first.second;
+            stats.ev[ev].add(leaf.second);
+        }
+    }
+
+    std::vector<StatsItem<std::string> > fncs;
+    sortStats(fncs, byFnc);
+    for (unsigned i = 0; i < fncs.size() && i < maxReportItems; ++i)
+        CL_NOTE("[hot spot] function " << fncs[i].key << "(): "
+                << describe(fncs[i].stats));
+
+    std::vector<StatsItem<TBlock> > blocks;
+    sortStats(blocks, byBlock);
+    for (unsigned i = 0; i < blocks.size() && i < maxReportItems; ++i) {
+        const TBlock bb = blocks[i].key;
+        CL_NOTE_MSG(&bb->front()->loc, "[hot spot] block " << bb->name()
+                << ": " << describe(blocks[i].stats));
+    }
+
+    std::vector<StatsItem<TLoc> > locs;
+    sortStats(locs, byLoc);
+    for (unsigned i = 0; i < locs.size() && i < maxReportItems; ++i) {
+        const TInsn insn = insnByLoc[locs[i].key];
+        CL_NOTE_MSG(&insn->loc, "[hot spot] " << describe(locs[i].stats));
+    }
+}
+
+static void writeCollapsedStacks(std::ostream &str)
+{
+    for (TStackMap::const_reference item : statsByStack) {
+        const std::string &stack = item.first;
+        for (TLeafMap::const_reference leaf : item.second) {
+            const TInsn insn = leaf.first.first;
+            const unsigned long usec = 1e6 * leaf.second.time;
+            if (!usec)
+                continue;
+
+            str << stack << ';';
+            switch (leaf.first.second) {
+                case PE_EXEC:
+                    str << locToString(insn->loc);
+                    break;
+
+                case PE_JOIN:
+                    str << "[join " << insn->bb->name() << "]";
+                    break;
+
+                case PE_ABSTRACT:
+                    str << "[abstraction " << insn->bb->name() << "]";
+                    break;
+
+                case PE_TOTAL:
+                    CL_BREAK_IF("invalid call of writeCollapsedStacks()");
+            }
+
+            str << ' ' << usec << '\n';
+        }
+    }
+}
+
+void dump()
+{
+    if (!enabled())
+        return;
+
+    printReport();
+
+    const std::string &fileName = GlConf::data.hotSpotsFile;
+    std::fstream str(fileName.c_str(), std::ios::out);
+    if (!str) {
+        CL_ERROR("unable to create file '" << fileName << "'");
+        return;
+    }
+
+    writeCollapsedStacks(str);
+    CL_NOTE("hot spots (collapsed stacks) written to '" << fileName << "'");
+}
+
+} // namespace Profiler
@@ -0,0 +1,114 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_PROFILER_H
+#define H_GUARD_PROFILER_H
+
+/**
+ * @file profiler.hh
+ * opt-in profiler attributing the work of symbolic execution to locations,
+ * basic blocks and functions of the analysed program (see hot_spots option)
+ */
+
+#include <cl/timeline.hh>
+
+#include <string>
+
+namespace CodeStorage {
+    struct Block;
+    struct Insn;
+}
+
+class SymBackTrace;
+
+namespace Profiler {
+
+enum EEvent {
+    PE_EXEC = 0,            ///< execution of an instruction on a single heap
+    PE_JOIN,                ///< insertion of a heap into the state of a block
+    PE_ABSTRACT,            ///< abstraction of a heap leaving a block
+    PE_TOTAL
+};
+
+/// true if the profiler has been enabled by the hot_spots run-time option
+bool enabled();
+
+/// collapsed call stack of the given backtrace (outermost function first)
+std::string stackOf(const SymBackTrace &bt);
+
+/// total time accounted so far (used to exclude the time of nested probes)
+double accountedTime();
+
+/**
+ * account an event that took the given wall-clock time
+ * @param stack collapsed call stack as returned by stackOf()
+ * @param insn the instruction being executed (PE_EXEC), the first instruction
+ * of the block being updated (PE_JOIN), or the terminal instruction of the
+ * block being left (PE_ABSTRACT)
+ */
+void account(
+        EEvent                      ev,
+        const std::string          &stack,
+        const CodeStorage::Insn    &insn,
+        double                      time);
+
+/// update the peak count of heaps in the state of the given block
+void updatePeakState(const CodeStorage::Block *bb, unsigned cntHeaps);
+
+/**
+ * measure the wall-clock time of an event in scope (if the profiler is on)
+ * @note time accounted by probes nested in the scope is not accounted twice
+ */
+class Probe {
+    public:
+        Probe(
+                const EEvent                ev,
+                const std::string          &stack,
+                const CodeStorage::Insn    &insn):
+            ev_(ev),
+            stack_(stack),
+            insn_(insn),
+            start_((enabled()) ? Timeline::wallClock() : -1.0),
+            nested_((0.0 <= start_) ? accountedTime() : 0.0)
+        {
+        }
+
+        ~Probe() {
+            if (0.0 <= start_) {
+                const double nested = accountedTime() - nested_;
+                account(ev_, stack_, insn_,
+                        Timeline::wallClock() - start_ - nested);
+            }
+        }
+
+    private:
+        Probe(const Probe &);
+        Probe& operator=(const Probe &);
+
+        const EEvent                ev_;
+        const std::string          &stack_;
+        const CodeStorage::Insn    &insn_;
+        const double                start_;
+        const double                nested_;
+};
+
+/// print the sorted report and write the collapsed stacks (if enabled)
+void dump();
+
+} // namespace Profiler
+
+#endif /* H_GUARD_PROFILER_H */
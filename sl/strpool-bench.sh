@@ -0,0 +1,29 @@
+#!/bin/bash
+export SELF="$0"
+
+export LC_ALL=C
+
+usage() {
+    printf "Usage: %s path/to/probe.sh [test-0001.c [...]]\n" "$SELF" >&2
+    printf "Measures time and memory Predator needs for the string-heavy \
+test-cases (or for the given ones).\n" >&2
+    exit 1
+}
+
+export PROBE="$1"
+test -x "$PROBE" || usage
+shift
+
+topdir="`dirname "$(readlink -f "$SELF")"`/.."
+if test -z "$1"; then
+    # test-cases exercising string literals and char-level writes to them
+    for i in 0209 0210 0211 0212 0213 0262 0471 0472 0474; do
+        set -- "$@" "$topdir/tests/predator-regre/test-$i.c"
+    done
+fi
+
+# probe.sh prints the time and peak memory usage of each run
+"$PROBE" "$@" | tee /dev/stderr \
+    | sed -nE 's|^.*[[:space:]]([0-9.]+) s[[:space:]]+([0-9.]+) MB$|\1 \2|p' \
+    | awk '{ t += $1; m = ($2 > m) ? $2 : m }
+        END { printf "total time:\t%10.3f s\npeak memory:\t%10.2f MB\n", t, m }'
@@ -0,0 +1,171 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "strpool.hh"
+
+#include <cl/cl_msg.hh>
+
+#include <unordered_map>
+#include <vector>
+
+namespace StrPool {
+
+/// a node of the trie, represents the string spelled on the path to the root
+struct StrNode {
+    TStrId                  parent;
+    char                    chr;
+    size_t                  len;
+
+    StrNode(TStrId parent_, char chr_, size_t len_):
+        parent(parent_),
+        chr(chr_),
+        len(len_)
+    {
+    }
+};
+
+class Pool {
+    public:
+        Pool() {
+            // the root of the trie represents the empty string
+            nodes_.push_back(StrNode(STR_EMPTY, '\0', 0));
+        }
+
+        size_t size() const {
+            return nodes_.size();
+        }
+
+        const StrNode& node(const TStrId id) const {
+            CL_BREAK_IF(id < 0 || nodes_.size() <= static_cast<size_t>(id));
+            return nodes_[id];
+        }
+
+        TStrId child(TStrId, char);
+        TStrId ancestor(TStrId, size_t len) const;
+        std::string materialise(TStrId) const;
+
+    private:
+        /// all edges of the trie in a single table, keyed by (parent, char)
+        typedef std::unordered_map<unsigned long long, TStrId>  TEdgeMap;
+
+        static unsigned long long edgeKey(const TStrId parent, const char c) {
+            return (static_cast<unsigned long long>(parent) << /* char */ 8)
+                | static_cast<unsigned char>(c);
+        }
+
+        std::vector<StrNode>    nodes_;
+        TEdgeMap                edges_;
+};
+
+TStrId Pool::child(const TStrId id, const char c)
+{
+    const unsigned long long key = edgeKey(id, c);
+    const TEdgeMap::const_iterator it = edges_.find(key);
+    if (edges_.end() != it)
+        return it->second;
+
+    // extend the trie
+    const TStrId idChild = nodes_.size();
+    nodes_.push_back(StrNode(id, c, nodes_[id].len + 1));
+    edges_[key] = idChild;
+    return idChild;
+}
+
+TStrId Pool::ancestor(TStrId id, const size_t len) const
+{
+    CL_BREAK_IF(this->node(id).len < len);
+    while (len < nodes_[id].len)
+        id = nodes_[id].parent;
+
+    return id;
+}
+
+std::string Pool::materialise(const TStrId id) const
+{
+    // the strings are not cached, which would cost O(n^2) for long paths
+    std::string text(nodes_[id].len, '\0');
+    for (TStrId i = id; STR_EMPTY != i; i = nodes_[i].parent)
+        text[nodes_[i].len - 1] = nodes_[i].chr;
+
+    return text;
+}
+
+static Pool pool;
+
+TStrId intern(const char *str)
+{
+    TStrId id = STR_EMPTY;
+    for (; *str; ++str)
+        id = pool.child(id, *str);
+
+    return id;
+}
+
+size_t length(const TStrId id)
+{
+    return pool.node(id).len;
+}
+
+std::string str(const TStrId id)
+{
+    pool.node(id);
+    return pool.materialise(id);
+}
+
+TStrId truncate(const TStrId id, const size_t len)
+{
+    return pool.ancestor(id, len);
+}
+
+TStrId writeChar(TStrId id, const size_t pos, const char c)
+{
+    CL_BREAK_IF(pool.node(id).len < pos);
+    if (!c)
+        // writing the trailing zero
+        return pool.ancestor(id, pos);
+
+    // collect the chars behind the position being written (in reverse order)
+    std::string suffix;
+    while (pos < pool.node(id).len) {
+        const StrNode &node = pool.node(id);
+        if (node.len == pos + 1)
+            break;
+
+        suffix.push_back(node.chr);
+        id = node.parent;
+    }
+
+    if (pos < pool.node(id).len)
+        // step before the char being overwritten
+        id = pool.node(id).parent;
+
+    // write the char and replay the suffix on top of it
+    id = pool.child(id, c);
+    for (std::string::reverse_iterator it = suffix.rbegin();
+            it != suffix.rend(); ++it)
+        id = pool.child(id, *it);
+
+    return id;
+}
+
+void printStats()
+{
+    CL_NOTE("[StrPool] " << pool.size() << " trie nodes");
+}
+
+} // namespace StrPool
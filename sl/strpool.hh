@@ -0,0 +1,63 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_STRPOOL_H
+#define H_GUARD_STRPOOL_H
+
+/**
+ * @file strpool.hh
+ * global pool of interned strings shared by all symbolic heaps
+ *
+ * The strings are kept in a trie, so that each string is identified by a
+ * single integer, strings sharing a prefix share its storage, and replacing a
+ * character (or truncating the string) touches only the suffix behind it.  A
+ * node of the trie takes a few bytes only, its edges are kept in a single hash
+ * table shared by all the nodes.
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace StrPool {
+
+/// ID of an interned string, equal IDs imply equal strings and vice versa
+typedef int TStrId;
+
+/// ID of the empty string
+const TStrId STR_EMPTY = 0;
+
+/// intern the given zero-terminated string
+TStrId intern(const char *str);
+
+/// length of the interned string
+size_t length(TStrId);
+
+/// the interned string itself (materialised on each call, no copy is kept)
+std::string str(TStrId);
+
+/// the string cut at the given position, which must be within the string
+TStrId truncate(TStrId, size_t len);
+
+/// the string with a char written at the given position (possibly appended)
+TStrId writeChar(TStrId, size_t pos, char c);
+
+/// print statistics about the pool
+void printStats();
+
+} // namespace StrPool
+
+#endif /* H_GUARD_STRPOOL_H */
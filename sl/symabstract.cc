@@ -23,8 +23,11 @@
 
 #include <cl/cl_msg.hh>
 #include <cl/clutil.hh>
+#include <cl/metrics.hh>
 #include <cl/storage.hh>
+#include <cl/timeline.hh>
 
+#include "heaplog.hh"
 #include "prototype.hh"
 #include "symcmp.hh"
 #include "symdebug.hh"
@@ -42,6 +45,9 @@
 
 LOCAL_DEBUG_PLOTTER(symabstract, DEBUG_SYMABSTRACT)
 
+/// count of objects merged into a list segment by a single abstraction
+static Metrics::Histogram segLengthHist("abstraction.segment_length");
+
 void debugSymAbstract(const bool enable)
 {
     if (enable == __ldp_enabled_symabstract)
@@ -468,22 +474,36 @@ TMinLen spliceOutSegmentIfNeeded(
     return 0;
 }
 
-void abstractIfNeeded(SymHeap &sh)
+static void abstractIfNeededCore(SymHeap &sh)
 {
+    const Timeline::Scope timelineScope("abstractIfNeeded");
 #if SE_DISABLE_SLS && SE_DISABLE_DLS
     return;
 #endif
+    SegDiscovery discovery(sh, static_cast<bool>(SE_INCREMENTAL_DISCOVERY));
     Shape shape;
-    while (discoverBestAbstraction(&shape, sh)) {
+    while (discovery.discoverBestAbstraction(&shape)) {
+        discovery.invalidate(shape);
         if (!applyAbstraction(sh, shape))
             // the best abstraction given is unfortunately not good enough
             break;
 
+        ++segDiscoveryStats().cntSegsIntroduced;
+        segLengthHist.add(shape.length);
+
         // some part of the symbolic heap has just been successfully abstracted,
         // let's look if there remains anything else suitable for abstraction
     }
 }
 
+void abstractIfNeeded(SymHeap &sh)
+{
+    HeapLog::CallRecorder rec(HeapLog::HO_ABSTRACT, sh);
+    abstractIfNeededCore(sh);
+    if (HeapLog::enabled())
+        rec.setResult(HeapLog::countObjects(sh));
+}
+
 void concretizeObj(
         SymHeap                     &sh,
         TSymHeapList                &todo,
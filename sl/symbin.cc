@@ -41,8 +41,12 @@
 #include "util.hh"
 
 #include <cstring>
+#include <dlfcn.h>
+#include <fstream>
 #include <libgen.h>
 #include <map>
+#include <sstream>
+#include <unordered_map>
 
 typedef const struct cl_loc     *TLoc;
 typedef const struct cl_operand &TOp;
@@ -1213,6 +1217,14 @@ bool handleError(
     return true;
 }
 
+/// a built-in model bound to a function of the analysed program
+struct BuiltInBinding {
+    TBuiltInHandler                                 hdl;
+    const char                                     *name;   ///< diagnostics
+    const char                                     *model;  ///< for hdl
+    const TOpIdxList                               *derefs;
+};
+
 // singleton
 class BuiltInTable {
     public:
@@ -1229,30 +1241,54 @@ class BuiltInTable {
                 SymState                            &dst,
                 SymExecCore                         &core,
                 TInsn                                insn,
-                const char                          *name)
+                const BuiltInBinding                &bin)
             const;
 
         const TOpIdxList& lookForDerefs(const char *name) const;
 
+        void registerModel(
+                const std::string                  &name,
+                TBuiltInHandler                     hdl,
+                const TOpIdxList                   &derefs);
+
+        bool registerAlias(
+                const std::string                  &name,
+                const std::string                  &model,
+                const TOpIdxList                   *derefs);
+
+        void resolve(TStorRef stor);
+
+        const BuiltInBinding* binding(cl_uid_t uid) const {
+            const TBindings::const_iterator it = bindings_.find(uid);
+            return (bindings_.end() == it)
+                ? 0
+                : &it->second;
+        }
+
         // TODO: rename and hide
         const TOpIdxList                            emp_;
 
     private:
         BuiltInTable();
 
-        static BuiltInTable* inst_;
+        TBuiltInHandler lookForHandler(const char *name) const;
 
-        typedef bool (*THandler)(
-                SymState                            &dst,
-                SymExecCore                         &core,
-                const CodeStorage::Insn             &insn,
-                const char                          *name);
+        const char* lookForModel(const char *name) const;
 
-        typedef std::map<std::string, THandler>     TMap;
+        static BuiltInTable* inst_;
+
+        typedef std::map<std::string, TBuiltInHandler> TMap;
         TMap                                        tbl_;
 
         typedef std::map<std::string, TOpIdxList>   TDerefMap;
         TDerefMap                                   der_;
+
+        // handlers may dispatch on the name, so aliases pass them the model
+        typedef std::map<std::string, std::string>  TAliasMap;
+        TAliasMap                                   aliases_;
+
+        typedef std::unordered_map<cl_uid_t, BuiltInBinding> TBindings;
+        TBindings                                   bindings_;
 };
 
 BuiltInTable *BuiltInTable::inst_;
@@ -1370,15 +1406,8 @@ BuiltInTable::BuiltInTable()
     der_["__strncpy_chk"]          .push_back(/* src  */ 3);
 }
 
-bool BuiltInTable::handleBuiltIn(
-        SymState                                    &dst,
-        SymExecCore                                 &core,
-        const CodeStorage::Insn                     &insn,
-        const char                                  *name)
-    const
+TBuiltInHandler BuiltInTable::lookForHandler(const char *name) const
 {
-    THandler hdl;
-
     TMap::const_iterator it = tbl_.find(name);
     if (tbl_.end() == it) {
         static const char namePrefixNondet[] = "__VERIFIER_nondet";
@@ -1393,20 +1422,43 @@ bool BuiltInTable::handleBuiltIn(
             namePrefix.resize(namePrefixLength);
 
         if (std::string(namePrefixNondet) == namePrefix)
-            hdl = handleNondetInt;
+            return handleNondetInt;
         else if (std::string(namePrefixObjSize) == namePrefix)
-            hdl = handleNoOp;
+            return handleNoOp;
         else
             // no fnc name matched as built-in
-            return false;
+            return 0;
     }
-    else
-        hdl = it->second;
 
+    return it->second;
+}
+
+/// return the name of the model to be passed to the handler of name()
+const char* BuiltInTable::lookForModel(const char *name) const
+{
+    TAliasMap::const_iterator it = aliases_.find(name);
+    if (aliases_.end() == it)
+        // not an alias
+        return name;
+
+    return it->second.c_str();
+}
+
+bool BuiltInTable::handleBuiltIn(
+        SymState                                    &dst,
+        SymExecCore                                 &core,
+        const CodeStorage::Insn                     &insn,
+        const BuiltInBinding                        &bin)
+    const
+{
     SymHeap &sh = core.sh();
     sh.traceUpdate(new Trace::InsnNode(sh.traceNode(), &insn, /* bin */ true));
 
-    return hdl(dst, core, insn, name);
+    if (bin.model != bin.name)
+        CL_DEBUG_MSG(&insn.loc, "executing " << bin.name
+                << "() as " << bin.model << "()");
+
+    return bin.hdl(dst, core, insn, bin.model);
 }
 
 const TOpIdxList& BuiltInTable::lookForDerefs(const char *name) const
@@ -1419,51 +1471,205 @@ const TOpIdxList& BuiltInTable::lookForDerefs(const char *name) const
     return it->second;
 }
 
-bool fncNameFromOp(
-        const char                                **pName,
-        SymExecCore                                 &core,
-        const struct cl_operand                     &op)
+void BuiltInTable::registerModel(
+        const std::string                          &name,
+        TBuiltInHandler                             hdl,
+        const TOpIdxList                           &derefs)
 {
-    cl_uid_t uid;
-    if (!core.fncFromOperand(&uid, op))
+    tbl_[name] = hdl;
+    aliases_.erase(name);
+
+    if (derefs.empty())
+        der_.erase(name);
+    else
+        der_[name] = derefs;
+}
+
+bool BuiltInTable::registerAlias(
+        const std::string                          &name,
+        const std::string                          &model,
+        const TOpIdxList                           *derefs)
+{
+    const TBuiltInHandler hdl = this->lookForHandler(model.c_str());
+    if (!hdl)
+        return false;
+
+    if (!derefs)
+        // inherit the operands with dereference semantics from the model
+        derefs = &this->lookForDerefs(model.c_str());
+
+    // copy the list as registerModel() may overwrite der_[model]
+    const TOpIdxList derefsCopy(*derefs);
+    const std::string base(this->lookForModel(model.c_str()));
+    this->registerModel(name, hdl, derefsCopy);
+    if (base != name)
+        aliases_[name] = base;
+
+    return true;
+}
+
+void BuiltInTable::resolve(TStorRef stor)
+{
+    bindings_.clear();
+
+    for (const CodeStorage::Fnc *fnc : stor.fncs) {
+        if (!fnc->def.data.cst.data.cst_fnc.is_extern)
+            // only external functions are candidates for built-in functions
+            continue;
+
+        const char *name = nameOf(*fnc);
+        if (!name)
+            continue;
+
+        const TBuiltInHandler hdl = this->lookForHandler(name);
+        const TOpIdxList &derefs = this->lookForDerefs(name);
+        if (!hdl && derefs.empty())
+            // no fnc name matched as built-in
+            continue;
+
+        BuiltInBinding &bin = bindings_[uidOf(*fnc)];
+        bin.hdl     = hdl;
+        bin.name    = name;
+        bin.model   = this->lookForModel(name);
+        bin.derefs  = &derefs;
+    }
+
+    CL_DEBUG("BuiltInTable::resolve() bound " << bindings_.size()
+            << " functions to models of built-ins");
+}
+
+/// read models of built-ins from a file, one 'fnc model [idx [...]]' per line
+bool loadModelFile(BuiltInTable *tbl, const std::string &fileName)
+{
+    std::ifstream str(fileName.c_str());
+    if (!str) {
+        CL_ERROR("unable to open model file: " << fileName);
         return false;
+    }
+
+    bool ok = true;
+    std::string line;
+    for (int lineNo = 1; std::getline(str, line); ++lineNo) {
+        const size_t posComment = line.find('#');
+        if (std::string::npos != posComment)
+            line.resize(posComment);
+
+        std::istringstream lineStr(line);
+        std::string name, model;
+        if (!(lineStr >> name))
+            // empty line
+            continue;
+
+        if (!(lineStr >> model)) {
+            CL_ERROR(fileName << ":" << lineNo << ": model name expected");
+            ok = false;
+            continue;
+        }
+
+        TOpIdxList derefs;
+        unsigned idx;
+        while (lineStr >> idx)
+            derefs.push_back(idx);
+
+        if (!lineStr.eof()) {
+            CL_ERROR(fileName << ":" << lineNo
+                    << ": index of an operand expected");
+            ok = false;
+            continue;
+        }
+
+        if (!tbl->registerAlias(name, model, (derefs.empty()) ? 0 : &derefs)) {
+            CL_ERROR(fileName << ":" << lineNo
+                    << ": unknown model of a built-in: " << model);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
 
-    TStorRef stor = core.sh().stor();
-    const CodeStorage::Fnc *fnc = stor.fncs[uid];
-    if (!fnc->def.data.cst.data.cst_fnc.is_extern)
-        // only external functions are candidates for built-in functions
+/// load a shared object and let it register its models of built-ins
+bool loadModelPlugin(const std::string &fileName)
+{
+    void *handle = dlopen(fileName.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        CL_ERROR("unable to load models of built-ins: " << dlerror());
         return false;
+    }
 
-    const char *name = nameOf(*fnc);
-    if (!name)
+    typedef void (*TInitFnc)();
+    void *sym = dlsym(handle, SL_BUILTIN_MODELS_INIT);
+    if (!sym) {
+        CL_ERROR(fileName << ": symbol " SL_BUILTIN_MODELS_INIT "() not found");
+        dlclose(handle);
         return false;
+    }
 
-    *pName = name;
+    // the shared object stays loaded as its handlers are in use from now on
+    reinterpret_cast<TInitFnc>(sym)();
     return true;
 }
 
+void registerBuiltIn(
+        const char                                 *name,
+        TBuiltInHandler                             hdl,
+        const TOpIdxList                           &derefs)
+{
+    BuiltInTable::inst()->registerModel(name, hdl, derefs);
+}
+
+bool registerBuiltInAlias(const char *name, const char *model)
+{
+    return BuiltInTable::inst()->registerAlias(name, model, /* derefs */ 0);
+}
+
+bool loadBuiltInModels(const std::string &fileName)
+{
+    static const std::string suffix = ".so";
+    const size_t len = fileName.size();
+    if (suffix.size() < len && !fileName.compare(len - suffix.size(),
+                suffix.size(), suffix))
+        return loadModelPlugin(fileName);
+
+    return loadModelFile(BuiltInTable::inst(), fileName);
+}
+
+void resolveBuiltIns(TStorRef stor)
+{
+    BuiltInTable::inst()->resolve(stor);
+}
+
+const BuiltInBinding* bindingFromOp(
+        SymExecCore                                 &core,
+        const struct cl_operand                     &op)
+{
+    cl_uid_t uid;
+    if (!core.fncFromOperand(&uid, op))
+        return 0;
+
+    return BuiltInTable::inst()->binding(uid);
+}
+
 bool handleBuiltIn(
         SymState                                    &dst,
         SymExecCore                                 &core,
         const CodeStorage::Insn                     &insn)
 {
-    const char *name;
-    if (!fncNameFromOp(&name, core, insn.operands[/* fnc */ 1]))
+    const BuiltInBinding *bin = bindingFromOp(core, insn.operands[/* fnc */ 1]);
+    if (!bin || !bin->hdl)
         return false;
 
     const BuiltInTable *tbl = BuiltInTable::inst();
-    return tbl->handleBuiltIn(dst, core, insn, name);
+    return tbl->handleBuiltIn(dst, core, insn, *bin);
 }
 
 const TOpIdxList& opsWithDerefSemanticsInCallInsn(
         SymExecCore                                 &core,
         const CodeStorage::Insn                     &insn)
 {
-    const BuiltInTable *tbl = BuiltInTable::inst();
-
-    const char *name;
-    if (!fncNameFromOp(&name, core, insn.operands[/* fnc */ 1]))
-        return tbl->emp_;
+    const BuiltInBinding *bin = bindingFromOp(core, insn.operands[/* fnc */ 1]);
+    if (!bin)
+        return BuiltInTable::inst()->emp_;
 
-    return tbl->lookForDerefs(name);
+    return *bin->derefs;
 }
@@ -25,6 +25,7 @@
  * implementation of built-in functions
  */
 
+#include <string>
 #include <vector>
 
 class SymExecCore;
@@ -32,11 +33,50 @@ class SymState;
 
 namespace CodeStorage {
     struct Insn;
+    struct Storage;
 }
 
 /// list of indexes of operands in an instruction
 typedef std::vector<unsigned /* idx */>         TOpIdxList;
 
+/**
+ * model of a built-in function, returns true if the call has been handled
+ * @param name name of the model, also if it is called through an alias
+ */
+typedef bool (*TBuiltInHandler)(
+        SymState                                &dst,
+        SymExecCore                             &core,
+        const CodeStorage::Insn                 &insn,
+        const char                              *name);
+
+/// a shared object with extra models needs to export this (extern "C") function
+#define SL_BUILTIN_MODELS_INIT "sl_register_builtin_models"
+
+/**
+ * register a model of a built-in function of the given name, replacing the
+ * model of the same name if there is any
+ * @param derefs operands of the call with dereference semantics
+ */
+void registerBuiltIn(
+        const char                              *name,
+        TBuiltInHandler                          hdl,
+        const TOpIdxList                        &derefs);
+
+/// model calls of the function @b name the same way as calls of @b model
+bool registerBuiltInAlias(const char *name, const char *model);
+
+/**
+ * load extra models of built-in functions from the given file, which is
+ * either a shared object exporting SL_BUILTIN_MODELS_INIT, or a text file
+ * with lines like 'my_alloc malloc' (each optionally followed by the indexes
+ * of the operands with dereference semantics), '#' starts a comment
+ * @return true if all the models have been loaded successfully
+ */
+bool loadBuiltInModels(const std::string &fileName);
+
+/// bind the models of built-ins to the functions of the analysed program
+void resolveBuiltIns(const CodeStorage::Storage &);
+
 /// list of operands which have dereference semantics for a detected built-in
 const TOpIdxList& opsWithDerefSemanticsInCallInsn(
         SymExecCore                             &core,
@@ -222,6 +222,13 @@ const struct cl_loc* SymBackTrace::topCallLoc() const
     return top.loc;
 }
 
+const CodeStorage::Fnc* SymBackTrace::fncAt(const unsigned depth) const
+{
+    CL_BREAK_IF(d->btStack.size() <= depth);
+    const BtStackItem &item = d->btStack[depth];
+    return &item.fnc;
+}
+
 bool areEqual(const SymBackTrace *btA, const SymBackTrace *btB)
 {
     if (!btA && !btB)
@@ -98,6 +98,9 @@ class SymBackTrace {
         /// return location of call of the topmost function in the backtrace
         const struct cl_loc* topCallLoc() const;
 
+        /// return the function at the given depth (0 is the topmost one)
+        const CodeStorage::Fnc* fncAt(unsigned depth) const;
+
     protected:
         /**
          * stream out the backtrace, using CL_NOTE_MSG; or do nothing if the
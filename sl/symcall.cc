@@ -21,7 +21,9 @@
 #include "symcall.hh"
 
 #include <cl/cl_msg.hh>
+#include <cl/json.hh>
 #include <cl/storage.hh>
+#include <cl/timeline.hh>
 
 #include "glconf.hh"
 #include "symabstract.hh"
@@ -38,15 +40,64 @@
 #include "util.hh"
 
 #include <algorithm>
+#include <fstream>
+#include <map>
 #include <vector>
 
+
 LOCAL_DEBUG_PLOTTER(symcall, DEBUG_SYMCALL)
 
+// /////////////////////////////////////////////////////////////////////////////
+// per-function statistics of SymCallCache, accumulated over the whole run
+struct FncCallStats {
+    const CodeStorage::Fnc     *fnc;
+    unsigned long               cntCalls;
+    unsigned long               cntHits;
+    unsigned long               cntMisses;
+    unsigned long               cntWidened;
+    unsigned long               cntJoinAttempts;
+    unsigned long               cntIsoChecks;
+    unsigned long               cntResults;     ///< total count of result heaps
+    unsigned long               maxResults;     ///< max. result heaps per call
+
+    // the following ones are collected only if call_cache_stats is given
+    unsigned long               maxEntryObjs;   ///< max. objects in entry heap
+    double                      timeIncl;       ///< including nested calls
+    double                      timeExcl;       ///< excluding nested calls
+
+    FncCallStats():
+        fnc(0),
+        cntCalls(0UL),
+        cntHits(0UL),
+        cntMisses(0UL),
+        cntWidened(0UL),
+        cntJoinAttempts(0UL),
+        cntIsoChecks(0UL),
+        cntResults(0UL),
+        maxResults(0UL),
+        maxEntryObjs(0UL),
+        timeIncl(0.0),
+        timeExcl(0.0)
+    {
+    }
+};
+
+typedef std::map<cl_uid_t, FncCallStats>            TFncCallStatsMap;
+
+static TFncCallStatsMap fncCallStats;
+
+/// true if the call_cache_stats option has been given
+static bool callCacheStatsEnabled()
+{
+    return !GlConf::data.callCacheStatsFile.empty();
+}
+
 // /////////////////////////////////////////////////////////////////////////////
 // call context cache per one fnc
 class PerFncCache {
     private:
-        typedef std::vector<SymCallCtx *> TCtxMap;
+        typedef MemAccountingAllocator<SymCallCtx *, MC_CALL_CACHE> TAlloc;
+        typedef std::vector<SymCallCtx *, TAlloc> TCtxMap;
 
         SymHeapUnion    huni_;
         TCtxMap         ctxMap_;
@@ -54,10 +105,16 @@ class PerFncCache {
         SymCallCtx     *null_;
 #endif
         int             missCntSinceLastHit_;
+        int             cntMisses_;
+        FncCallStats   *stats_;         ///< 0 for lookups not caused by calls
 
-        int lookupCore(const SymHeap &sh);
+        int lookupCore(const SymHeap &sh, bool *pWidened = 0);
+        int lookupByJoin(const SymHeap &sh, bool *pWidened, bool widening);
 
         void cacheHit() {
+            if (stats_)
+                ++stats_->cntHits;
+
             if (0 < missCntSinceLastHit_)
                 missCntSinceLastHit_ = 0;
             else
@@ -66,7 +123,9 @@ class PerFncCache {
 
     public:
         PerFncCache():
-            missCntSinceLastHit_(0)
+            missCntSinceLastHit_(0),
+            cntMisses_(0),
+            stats_(0)
         {
         }
 
@@ -103,25 +162,39 @@ class PerFncCache {
 
         /**
          * look for the given heap; return the corresponding call ctx if found,
-         * 0 otherwise
+         * 0 otherwise.  If the cache entry has been widened to cover sh,
+         * *pWidened is set to the widened entry heap, to 0 otherwise.
          */
-        SymCallCtx*& lookup(const SymHeap &sh) {
+        SymCallCtx*& lookup(
+                const SymHeap              &sh,
+                const SymHeap             **pWidened,
+                FncCallStats               *stats)
+        {
+            *pWidened = 0;
 #if SE_ENABLE_CALL_CACHE
-            return ctxMap_[this->lookupCore(sh)];
+            bool widened = false;
+            stats_ = stats;
+            const int idx = this->lookupCore(sh, &widened);
+            stats_ = 0;
+            if (widened)
+                *pWidened = &huni_[idx];
+
+            return ctxMap_[idx];
 #else
             (void) sh;
+            if (stats)
+                ++stats->cntMisses;
             return null_ = 0;
 #endif
         }
 };
 
-int PerFncCache::lookupCore(const SymHeap &sh)
+/// return the index of an entry that has been joined with sh, -1 if none
+int PerFncCache::lookupByJoin(
+        const SymHeap               &sh,
+        bool                        *pWidened,
+        const bool                  widening)
 {
-#if 1 < SE_ENABLE_CALL_CACHE
-    if (GlConf::data.stateLiveOrdering)
-        CL_DIE("SE_STATE_ON_THE_FLY_ORDERING"
-               " is incompatible with join-based call cache");
-
     EJoinStatus     status;
     SymHeap         result(sh.stor(), new Trace::TransientNode("PerFncCache"));
     const int       cnt = huni_.size();
@@ -130,6 +203,9 @@ int PerFncCache::lookupCore(const SymHeap &sh)
     // try join
     for(idx = 0; idx < cnt; ++idx) {
         const SymHeap &shIn = huni_[idx];
+        if (stats_)
+            ++stats_->cntJoinAttempts;
+
         if (!joinSymHeaps(&status, &result, shIn, sh))
             // join failed with this heap, try the next one
             continue;
@@ -137,6 +213,10 @@ int PerFncCache::lookupCore(const SymHeap &sh)
         switch (status) {
             case JS_USE_ANY:
             case JS_USE_SH1:
+                if (widening && ctxMap_[idx]->inUse())
+                    // the result is not computed yet, try the next one
+                    continue;
+
                 // already covered by the cached ctx --> cache hit!
                 this->cacheHit();
                 return idx;
@@ -166,12 +246,36 @@ int PerFncCache::lookupCore(const SymHeap &sh)
             huni_.swapExisting(idx, shDup);
         }
 
+        if (pWidened)
+            *pWidened = true;
+
+        if (stats_)
+            ++stats_->cntWidened;
+
         this->cacheHit();
         return idx;
     }
 
+    // not found
+    return -1;
+}
+
+int PerFncCache::lookupCore(const SymHeap &sh, bool *pWidened)
+{
+#if 1 < SE_ENABLE_CALL_CACHE
+    if (GlConf::data.stateLiveOrdering)
+        CL_DIE("SE_STATE_ON_THE_FLY_ORDERING"
+               " is incompatible with join-based call cache");
+
+    int idx = this->lookupByJoin(sh, pWidened, /* widening */ false);
+    if (-1 != idx)
+        return idx;
+
 #else // 1 == SE_ENABLE_CALL_CACHE means "graph isomorphism only"
     int idx = huni_.lookup(sh);
+    if (stats_)
+        stats_->cntIsoChecks += (-1 == idx) ? huni_.size() : (1 + idx);
+
     if (-1 != idx) {
         this->cacheHit();
 
@@ -182,6 +286,18 @@ int PerFncCache::lookupCore(const SymHeap &sh)
 
         return idx;
     }
+
+    const int widenThr = GlConf::data.callCacheWidenThr;
+    if (pWidened && 0 < widenThr && widenThr <= cntMisses_) {
+        if (GlConf::data.stateLiveOrdering)
+            CL_DIE("SE_STATE_ON_THE_FLY_ORDERING"
+                   " is incompatible with call cache widening");
+
+        // too many misses, widen the entry by joining it with a cached one
+        idx = this->lookupByJoin(sh, pWidened, /* widening */ true);
+        if (-1 != idx)
+            return idx;
+    }
 #endif
 
     // cache miss
@@ -190,6 +306,10 @@ int PerFncCache::lookupCore(const SymHeap &sh)
     ctxMap_.push_back((SymCallCtx *) 0);
     CL_BREAK_IF(huni_.size() != ctxMap_.size());
 
+    if (stats_)
+        ++stats_->cntMisses;
+
+    ++cntMisses_;
     ++missCntSinceLastHit_;
     return idx;
 }
@@ -200,26 +320,32 @@ int PerFncCache::lookupCore(const SymHeap &sh)
 struct SymCallCache::Private {
     typedef const CodeStorage::Fnc                     &TFncRef;
     typedef CodeStorage::TVarSet                        TFncVarSet;
-    typedef std::map<cl_uid_t, PerFncCache>             TCache;
+    typedef std::pair<const cl_uid_t, PerFncCache>      TCacheItem;
+    typedef MemAccountingAllocator<TCacheItem, MC_CALL_CACHE> TCacheAlloc;
+    typedef std::map<cl_uid_t, PerFncCache, std::less<cl_uid_t>, TCacheAlloc>
+                                                        TCache;
     typedef std::vector<SymCallCtx *>                   TCtxStack;
 
     TCache                      cache;
     TCtxStack                   ctxStack;
     SymBackTrace                bt;
 
+    TStorRef                    stor;
+
     void importGlVar(SymHeap &sh, const CVar &cv);
     void resolveHeapCut(TCVarList &cut, SymHeap &sh, TFncRef fnc);
     SymCallCtx* getCallCtx(const SymHeap &entry, TFncRef fnc);
 
-    Private(TStorRef stor):
-        bt(stor)
+    Private(TStorRef stor_):
+        bt(stor_),
+        stor(stor_)
     {
     }
 };
 
 // /////////////////////////////////////////////////////////////////////////////
 // implementation of SymCallCtx
-struct SymCallCtx::Private {
+struct SymCallCtx::Private: public MemAccounted<MC_CALL_CACHE> {
     SymCallCache::Private       *cd;
     const CodeStorage::Fnc      *fnc;
     SymHeap                     entry;
@@ -229,6 +355,9 @@ struct SymCallCtx::Private {
     int                         nestLevel;
     bool                        computed;
     bool                        flushed;
+    bool                        partial;
+    double                      timeEnter;
+    double                      timeNested;
 
     void assignReturnValue(SymHeap &sh);
     void destroyStackFrame(SymHeap &sh);
@@ -242,7 +371,10 @@ struct SymCallCtx::Private {
         callFrame(cd_->bt.stor(),
                 new Trace::TransientNode("SymCallCtx::Private::callFrame")),
         computed(false),
-        flushed(false)
+        flushed(false),
+        partial(false),
+        timeEnter(0.0),
+        timeNested(0.0)
     {
     }
 };
@@ -267,7 +399,7 @@ bool SymCallCtx::inUse() const
     if (!d->flushed)
         return true;
 
-    CL_BREAK_IF(!d->computed);
+    CL_BREAK_IF(!d->computed && !d->partial);
     return false;
 }
 
@@ -419,6 +551,22 @@ void SymCallCtx::flushCallResults(SymState &dst)
     CL_BREAK_IF(this != d->cd->ctxStack.back());
     d->cd->ctxStack.pop_back();
 
+    FncCallStats &stats = fncCallStats[uidOf(*d->fnc)];
+    if (callCacheStatsEnabled()) {
+        // account the time spent in this call
+        const double timeIncl = Timeline::wallClock() - d->timeEnter;
+        stats.timeIncl += timeIncl;
+        stats.timeExcl += timeIncl - d->timeNested;
+        if (!d->cd->ctxStack.empty())
+            d->cd->ctxStack.back()->d->timeNested += timeIncl;
+    }
+
+    // account the count of result heaps
+    const unsigned long cntResults = d->rawResults.size();
+    stats.cntResults += cntResults;
+    if (stats.maxResults < cntResults)
+        stats.maxResults = cntResults;
+
     // go through the results and make them of the form that the caller likes
     const unsigned cnt = d->rawResults.size();
     for (unsigned i = 0; i < cnt; ++i) {
@@ -460,8 +608,8 @@ void SymCallCtx::flushCallResults(SymState &dst)
         dst.insert(sh);
     }
 
-    // mark as done
-    d->computed = true;
+    // mark as done unless some of the results are computed elsewhere
+    d->computed = !d->partial;
     d->flushed = true;
 
     // leave backtrace
@@ -516,6 +664,74 @@ SymBackTrace& SymCallCache::bt()
     return d->bt;
 }
 
+void SymCallCache::markCallsInProgressPartial()
+{
+    for (SymCallCtx *ctx : d->ctxStack)
+        ctx->d->partial = true;
+}
+
+void SymCallCache::printStats() const
+{
+    for (TFncCallStatsMap::const_reference item : fncCallStats) {
+        const FncCallStats &stats = item.second;
+        const CodeStorage::Fnc &fnc = *stats.fnc;
+        CL_NOTE_MSG(locationOf(fnc), "___ SymCallCache: " << nameOf(fnc)
+                << "() has " << stats.cntHits << " hits, "
+                << stats.cntMisses << " misses, "
+                << stats.cntWidened << " widened entries");
+    }
+}
+
+void printCallCacheStatsJson(std::ostream &str)
+{
+    str << "{\n  \"functions\": [";
+
+    const char *sep = "\n";
+    for (TFncCallStatsMap::const_reference item : fncCallStats) {
+        const FncCallStats &stats = item.second;
+        const CodeStorage::Fnc &fnc = *stats.fnc;
+        const struct cl_loc *loc = locationOf(fnc);
+
+        str << sep << "    {"
+            << "\"uid\": "              << item.first
+            << ", \"name\": "           << JsonStr(nameOf(fnc))
+            << ", \"file\": "           << JsonStr((loc->file) ? loc->file : "")
+            << ", \"line\": "           << loc->line
+            << ", \"calls\": "          << stats.cntCalls
+            << ", \"hits\": "           << stats.cntHits
+            << ", \"misses\": "         << stats.cntMisses
+            << ", \"widened\": "        << stats.cntWidened
+            << ", \"join_attempts\": "  << stats.cntJoinAttempts
+            << ", \"iso_checks\": "     << stats.cntIsoChecks
+            << ", \"results_total\": "  << stats.cntResults
+            << ", \"results_max\": "    << stats.maxResults
+            << ", \"entry_objs_max\": " << stats.maxEntryObjs
+            << ", \"time_incl\": "      << stats.timeIncl
+            << ", \"time_excl\": "      << stats.timeExcl
+            << "}";
+
+        sep = ",\n";
+    }
+
+    str << "\n  ]\n}\n";
+}
+
+void dumpCallCacheStats()
+{
+    const std::string &fileName = GlConf::data.callCacheStatsFile;
+    if (fileName.empty())
+        return;
+
+    std::fstream str(fileName.c_str(), std::ios::out);
+    if (!str) {
+        CL_ERROR("unable to create file '" << fileName << "'");
+        return;
+    }
+
+    printCallCacheStatsJson(str);
+    CL_NOTE("call cache statistics dumped to '" << fileName << "'");
+}
+
 void pullGlVar(SymHeap &result, SymHeap origin, const CVar &cv)
 {
     // do not try to combine things, it causes problems
@@ -722,15 +938,38 @@ SymCallCtx* SymCallCache::Private::getCallCtx(const SymHeap &entry, TFncRef fnc)
     // cache lookup
     const cl_uid_t uid = uidOf(fnc);
     PerFncCache &pfc = this->cache[uid];
-    SymCallCtx *&ctx = pfc.lookup(entry);
+
+    FncCallStats &stats = fncCallStats[uid];
+    stats.fnc = &fnc;
+    ++stats.cntCalls;
+
+    const bool statsEnabled = callCacheStatsEnabled();
+    if (statsEnabled) {
+        TObjList entryObjs;
+        entry.gatherObjects(entryObjs);
+        if (stats.maxEntryObjs < entryObjs.size())
+            stats.maxEntryObjs = entryObjs.size();
+    }
+
+    const SymHeap *widened;
+    SymCallCtx *&ctx = pfc.lookup(entry, &widened, &stats);
     if (!ctx) {
         // cache miss
         ctx = new SymCallCtx(this);
         ctx->d->fnc     = &fnc;
-        ctx->d->entry   = entry;
+        ctx->d->entry   = (widened) ? *widened : entry;
         Trace::waiveCloneOperation(ctx->d->entry);
 
+        if (widened)
+            CL_DEBUG_MSG(locationOf(fnc), "<W> SymCallCache widens entry of "
+                    << nameOf(fnc) << "()");
+
         // enter ctx stack
+        if (statsEnabled) {
+            ctx->d->timeEnter = Timeline::wallClock();
+            ctx->d->timeNested = 0.0;
+        }
+
         this->ctxStack.push_back(ctx);
         return ctx;
     }
@@ -738,7 +977,14 @@ SymCallCtx* SymCallCache::Private::getCallCtx(const SymHeap &entry, TFncRef fnc)
     const struct cl_loc *loc = locationOf(fnc);
 
     // cache hit, perform some sanity checks
-    if (!ctx->d->computed) {
+    if (ctx->d->partial && ctx->d->flushed) {
+        // some of the results have been computed by another process
+        CL_DEBUG_MSG(loc, "SymCallCache drops partial results of "
+                << nameOf(fnc) << "()");
+        ctx->d->partial = false;
+        ctx->d->rawResults.clear();
+    }
+    else if (!ctx->d->computed) {
         // oops, we are not ready for this!
         CL_ERROR_MSG(loc, "call cache entry found, but result not "
                 "computed yet; perhaps a recursive function call?");
@@ -752,6 +998,11 @@ SymCallCtx* SymCallCache::Private::getCallCtx(const SymHeap &entry, TFncRef fnc)
     }
 
     // enter ctx stack
+    if (statsEnabled) {
+        ctx->d->timeEnter = Timeline::wallClock();
+        ctx->d->timeNested = 0.0;
+    }
+
     this->ctxStack.push_back(ctx);
 
     // all OK, return the cached ctx
@@ -763,6 +1014,7 @@ SymCallCtx* SymCallCache::getCallCtx(
         const CodeStorage::Fnc          &fnc,
         const CodeStorage::Insn         &insn)
 {
+    const Timeline::Scope timelineScope("SymCallCache::getCallCtx");
     const struct cl_loc *loc = &insn.loc;
     CL_DEBUG_MSG(loc, "SymCallCache is looking for " << nameOf(fnc) << "()...");
 
@@ -28,6 +28,8 @@
 
 #include "symheap.hh"
 
+#include <iosfwd>
+
 class SymBackTrace;
 class SymState;
 class SymCallCtx;
@@ -61,6 +63,16 @@ class SymCallCache {
                 const CodeStorage::Fnc       &fnc,
                 const CodeStorage::Insn      &insn);
 
+        /**
+         * mark the results of all calls in progress as partial, so that they
+         * are computed again when the cache is hit by them later on
+         * @note used once the work of the calls is split among processes
+         */
+        void markCallsInProgressPartial();
+
+        /// print per-function count of hits, misses, and widened entries
+        void printStats() const;
+
     private:
         /// object copying is @b not allowed
         SymCallCache(const SymCallCache &);
@@ -141,4 +153,14 @@ class SymCallCtx {
         Private *d;
 };
 
+/**
+ * print per-function statistics of SymCallCache (count of calls, hits, misses,
+ * widened entries, join attempts, isomorphism checks, size of entry/result
+ * states, inclusive/exclusive time) accumulated over the whole run as JSON
+ */
+void printCallCacheStatsJson(std::ostream &);
+
+/// print the statistics to the file given by the call_cache_stats option
+void dumpCallCacheStats();
+
 #endif /* H_GUARD_SYM_CALL_H */
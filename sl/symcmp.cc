@@ -21,7 +21,9 @@
 #include "symcmp.hh"
 
 #include <cl/cl_msg.hh>
+#include <cl/timeline.hh>
 
+#include "heaplog.hh"
 #include "symbt.hh"
 #include "symseg.hh"
 #include "symutil.hh"
@@ -336,10 +338,11 @@ class VarScheduleVisitor {
         }
 };
 
-bool areEqual(
+static bool areEqualCore(
         const SymHeap           &sh1,
         const SymHeap           &sh2)
 {
+    const Timeline::Scope timelineScope("areEqual");
     if (!areEqual(sh1.exitPoint(), sh2.exitPoint()))
         return false;
 
@@ -373,3 +376,13 @@ bool areEqual(
     return sh1.matchPreds(sh2, vMap[0])
         && sh2.matchPreds(sh1, vMap[1]);
 }
+
+bool areEqual(
+        const SymHeap           &sh1,
+        const SymHeap           &sh2)
+{
+    HeapLog::CallRecorder rec(HeapLog::HO_COMPARE, sh1, &sh2);
+    const bool equal = areEqualCore(sh1, sh2);
+    rec.setResult(equal);
+    return equal;
+}
@@ -23,17 +23,26 @@
 #include <cl/cl_msg.hh>
 #include <cl/clutil.hh>
 #include <cl/storage.hh>
+#include <cl/timeline.hh>
 
+#include "glconf.hh"
+#include "governor.hh"
 #include "prototype.hh"
 #include "symcmp.hh"
 #include "symjoin.hh"
 #include "symseg.hh"
 #include "symutil.hh"
 #include "util.hh"
+#include "worklist.hh"
 
 #include <algorithm>                // for std::copy()
+#include <cstdlib>
+#include <iostream>
 #include <set>
 
+#include <sys/wait.h>
+#include <unistd.h>
+
 // costs are now hard-wired in the paper, so they were removed from config.h
 #define SE_PROTO_COST_SYM           0
 #define SE_PROTO_COST_ASYM          1
@@ -41,15 +50,14 @@
 
 int minLengthByCost(int cost)
 {
-    // abstraction length thresholds are now configurable in config.h
-    static const int thrTable[] = {
-        (SE_COST0_LEN_THR),
-        (SE_COST1_LEN_THR),
-        (SE_COST2_LEN_THR)
-    };
-
-    static const int maxCost = sizeof(thrTable)/sizeof(thrTable[0]) - 1;
-    if (maxCost < cost)
+    // abstraction length thresholds are configurable by abstraction_len_thr
+    const std::vector<int> &thrTable = GlConf::data.absLenThr;
+
+    const int maxCost = thrTable.size() - 1;
+    if (Governor::GL_ABSTRACT <= Governor::level())
+        // running out of resources, abstract as if it costed nothing
+        cost = 0;
+    else if (maxCost < cost)
         cost = maxCost;
 
     // Predator counts elementar merges whereas the paper counts objects on path
@@ -597,6 +605,7 @@ void digShapePropsCandidates(
 struct SegCandidate {
     TObjId                      entry;
     TShapePropsList             propsList;
+    std::vector<TRankMap>       rankList;   ///< one rank map per propsList item
 };
 
 typedef std::vector<SegCandidate> TSegCandidateList;
@@ -624,9 +633,12 @@ bool selectBestAbstraction(
 
         // go through binding candidates
         const SegCandidate &segc = candidates[idx];
-        for (const ShapeProps &props : segc.propsList) {
-            TRankMap rMap;
-            segDiscover(rMap, sh, props, segc.entry);
+        const unsigned cntProps = segc.rankList.size();
+        CL_BREAK_IF(segc.propsList.size() != cntProps);
+
+        for (unsigned propsIdx = 0; propsIdx < cntProps; ++propsIdx) {
+            const ShapeProps &props = segc.propsList[propsIdx];
+            const TRankMap &rMap = segc.rankList[propsIdx];
 
             // go through all cost/length pairs
             for (TRankMap::const_reference rank : rMap) {
@@ -638,6 +650,8 @@ bool selectBestAbstraction(
 #if SE_COST_OF_SEG_INTRODUCTION
                 if (!segOnPath(sh, props.bOff, segc.entry, len))
                     cost += (SE_COST_OF_SEG_INTRODUCTION);
+#else
+                (void) sh;
 #endif
 
                 if (len < minLengthByCost(cost))
@@ -673,25 +687,474 @@ bool selectBestAbstraction(
     return true;
 }
 
-bool discoverBestAbstraction(Shape *pDst, SymHeap &sh)
+// /////////////////////////////////////////////////////////////////////////////
+// SegDiscovery implementation
+static SegDiscoveryStats segDiscoveryStatsData;
+
+SegDiscoveryStats& segDiscoveryStats()
+{
+    return segDiscoveryStatsData;
+}
+
+void printSegDiscoveryStats()
+{
+    const SegDiscoveryStats &st = segDiscoveryStatsData;
+    if (!st.cntRounds)
+        return;
+
+    CL_NOTE("[SegDiscovery] " << st.cntRounds << " discovery rounds, "
+            << st.cntCandidates << " candidates evaluated, "
+            << st.cntReused << " candidates reused, "
+            << st.cntBudgetHits << " rounds out of budget, "
+            << st.cntParallelRounds << " rounds evaluated in parallel, "
+            << st.cntSegsIntroduced << " segments introduced");
+}
+
+/// (index of candidate, index of props) pair scheduled for segDiscover()
+typedef std::pair<unsigned, unsigned>           TCandPair;
+typedef std::vector<TCandPair>                  TCandPairList;
+typedef std::vector<TRankMap>                   TRankMapList;
+
+void segDiscoverPair(
+        TRankMap                   &dst,
+        SymHeap                    &sh,
+        const TSegCandidateList    &candidates,
+        const TCandPair            &cp)
+{
+    const SegCandidate &segc = candidates[cp.first];
+    segDiscover(dst, sh, segc.propsList[cp.second], segc.entry);
+}
+
+bool writeAll(const int fd, const void *buf, size_t len)
+{
+    const char *ptr = static_cast<const char *>(buf);
+    while (len) {
+        const ssize_t written = write(fd, ptr, len);
+        if (written <= 0)
+            return false;
+
+        ptr += written;
+        len -= written;
+    }
+
+    return true;
+}
+
+bool readAll(const int fd, void *buf, size_t len)
+{
+    char *ptr = static_cast<char *>(buf);
+    while (len) {
+        const ssize_t got = read(fd, ptr, len);
+        if (got <= 0)
+            return false;
+
+        ptr += got;
+        len -= got;
+    }
+
+    return true;
+}
+
+/// evaluate each cntWorkers-th pair starting at idx and write results to fd
+void segDiscoverWorker(
+        const int                   fd,
+        SymHeap                    &sh,
+        const TSegCandidateList    &candidates,
+        const TCandPairList        &pairs,
+        const unsigned              cntWorkers,
+        unsigned                    idx)
+{
+    const unsigned cnt = pairs.size();
+    for (; idx < cnt; idx += cntWorkers) {
+        TRankMap rMap;
+        segDiscoverPair(rMap, sh, candidates, pairs[idx]);
+
+        // serialize as (idx, cnt, (cost, len)*)
+        std::vector<int> buf;
+        buf.push_back(idx);
+        buf.push_back(rMap.size());
+        for (TRankMap::const_reference rank : rMap) {
+            buf.push_back(rank.first);
+            buf.push_back(rank.second);
+        }
+
+        if (!writeAll(fd, &buf[0], buf.size() * sizeof(int)))
+            return;
+    }
+}
+
+/// read results of a worker, return false on a protocol error
+bool readWorkerResults(
+        TRankMapList               &dst,
+        std::vector<bool>          &done,
+        const int                   fd)
+{
+    int hdr[/* idx, cnt */ 2];
+    while (readAll(fd, hdr, sizeof hdr)) {
+        const int idx = hdr[0];
+        const int cnt = hdr[1];
+        if (idx < 0 || static_cast<int>(dst.size()) <= idx || cnt < 0)
+            return false;
+
+        TRankMap &rMap = dst[idx];
+        for (int i = 0; i < cnt; ++i) {
+            int rank[/* cost, len */ 2];
+            if (!readAll(fd, rank, sizeof rank))
+                return false;
+
+            rMap[rank[0]] = rank[1];
+        }
+
+        done[idx] = true;
+    }
+
+    return true;
+}
+
+/// measured costs that decide whether forking the worker processes pays off
+struct ParallelDiscoveryCosts {
+    double  timePerStep;    ///< sequential time per pair and heap object
+    double  timePerFork;    ///< time the parent spends forking one worker
+    bool    forkProbed;     ///< true once timePerFork has been measured
+
+    ParallelDiscoveryCosts():
+        timePerStep(0.0),
+        timePerFork(0.0),
+        forkProbed(false)
+    {
+    }
+};
+
+static ParallelDiscoveryCosts parallelDiscoveryCosts;
+
+/// measure the cost of forking a worker process that does nothing
+double probeForkTime()
+{
+    std::cout.flush();
+    std::cerr.flush();
+
+    const double start = Timeline::wallClock();
+    const pid_t pid = fork();
+    if (!pid)
+        _exit(EXIT_SUCCESS);
+
+    if (pid < 0)
+        // fork() does not work, never try it again
+        return -1.0;
+
+    waitpid(pid, 0, 0);
+    return Timeline::wallClock() - start;
+}
+
+/**
+ * return true if the sequential evaluation of cntSteps (pairs times heap
+ * objects) is estimated to take longer than forking cntWorkers processes and
+ * evaluating the pairs by them.  The cost of fork() grows with the size of the
+ * address space of the compiler process, so it is measured rather than guessed.
+ */
+bool parallelDiscoveryPaysOff(const double cntSteps, const unsigned cntWorkers)
+{
+    ParallelDiscoveryCosts &pc = parallelDiscoveryCosts;
+    if (pc.timePerStep <= 0.0)
+        // no sequential round has been measured yet
+        return false;
+
+    if (!pc.forkProbed) {
+        pc.timePerFork = probeForkTime();
+        pc.forkProbed = true;
+    }
+    if (pc.timePerFork < 0.0)
+        return false;
+
+    const double timeSeq = pc.timePerStep * cntSteps;
+    const double timePar = pc.timePerFork * cntWorkers + timeSeq / cntWorkers;
+    return timePar < timeSeq;
+}
+
+/**
+ * evaluate the (entry, props) pairs by forked worker processes, which explore
+ * copy-on-write snapshots of the heap and send the rank maps back over pipes.
+ * Lookups of fields performed by the workers may create them in the snapshots
+ * only, the heap of the parent process is touched by the fallback path only.
+ * Pairs that no worker has delivered are evaluated sequentially.  The result
+ * does not depend on the count of workers, so the selection of the best
+ * abstraction remains deterministic.
+ */
+void segDiscoverInParallel(
+        TRankMapList               &dst,
+        SymHeap                    &sh,
+        const TSegCandidateList    &candidates,
+        const TCandPairList        &pairs,
+        unsigned                    cntWorkers)
 {
+    const unsigned cnt = pairs.size();
+    if (cnt < cntWorkers)
+        cntWorkers = cnt;
+
+    std::vector<bool> done(cnt, false);
+    std::vector<pid_t> pids;
+    std::vector<int> fds;
+
+    // flush the output streams before they get duplicated by fork()
+    std::cout.flush();
+    std::cerr.flush();
+
+    const double start = Timeline::wallClock();
+    for (unsigned i = 0; i < cntWorkers; ++i) {
+        int pfd[2];
+        if (pipe(pfd))
+            break;
+
+        const pid_t pid = fork();
+        if (pid < 0) {
+            close(pfd[0]);
+            close(pfd[1]);
+            break;
+        }
+
+        if (!pid) {
+            // worker process
+            close(pfd[0]);
+            segDiscoverWorker(pfd[1], sh, candidates, pairs, cntWorkers, i);
+            close(pfd[1]);
+            _exit(EXIT_SUCCESS);
+        }
+
+        close(pfd[1]);
+        pids.push_back(pid);
+        fds.push_back(pfd[0]);
+    }
+
+    const unsigned cntForked = pids.size();
+    if (cntForked)
+        // keep track of the cost of fork() as the address space grows
+        parallelDiscoveryCosts.timePerFork =
+            (Timeline::wallClock() - start) / cntForked;
+
+    for (unsigned i = 0; i < cntForked; ++i) {
+        if (!readWorkerResults(dst, done, fds[i]))
+            CL_WARN("segDiscoverInParallel() got garbage from a worker");
+
+        close(fds[i]);
+        waitpid(pids[i], 0, 0);
+    }
+
+    // evaluate whatever has not been delivered by the workers
+    for (unsigned idx = 0; idx < cnt; ++idx) {
+        if (done[idx])
+            continue;
+
+        dst[idx].clear();
+        segDiscoverPair(dst[idx], sh, candidates, pairs[idx]);
+    }
+}
+
+struct SegDiscovery::Private {
+    typedef std::map<TObjId, SegCandidate>      TCache;
+
+    SymHeap                    &sh;
+    const bool                  incremental;
+    TCache                      cache;
+    unsigned                    budget;
+
+    Private(SymHeap &sh_, const bool incremental_):
+        sh(sh_),
+        incremental(incremental_),
+        budget(SE_ABSTRACTION_WORK_BUDGET)
+    {
+    }
+
+    void evaluate(TRankMapList &dst, const TSegCandidateList &candidates,
+            const TCandPairList &pairs, unsigned cntObjs) const;
+};
+
+void SegDiscovery::Private::evaluate(
+        TRankMapList               &dst,
+        const TSegCandidateList    &candidates,
+        const TCandPairList        &pairs,
+        const unsigned              cntObjs)
+    const
+{
+    const unsigned cnt = pairs.size();
+    dst.resize(cnt);
+
+    // more workers than the available CPUs would only add the cost of fork()
+    int cntWorkers = GlConf::data.parallelDiscovery;
+    const long cntCpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (0 < cntCpus && cntCpus < cntWorkers)
+        cntWorkers = cntCpus;
+
+    if (cntWorkers < 2) {
+        for (unsigned idx = 0; idx < cnt; ++idx)
+            segDiscoverPair(dst[idx], this->sh, candidates, pairs[idx]);
+        return;
+    }
+
+    // the walks are bounded by the count of heap objects
+    const double cntSteps = static_cast<double>(cnt) * cntObjs;
+    if ((SE_PARALLEL_DISCOVERY_THR) <= cnt
+            && parallelDiscoveryPaysOff(cntSteps, cntWorkers))
+    {
+        ++segDiscoveryStatsData.cntParallelRounds;
+        segDiscoverInParallel(dst, this->sh, candidates, pairs, cntWorkers);
+        return;
+    }
+
+    const double start = Timeline::wallClock();
+    for (unsigned idx = 0; idx < cnt; ++idx)
+        segDiscoverPair(dst[idx], this->sh, candidates, pairs[idx]);
+
+    if (cnt)
+        parallelDiscoveryCosts.timePerStep =
+            (Timeline::wallClock() - start) / cntSteps;
+}
+
+SegDiscovery::SegDiscovery(SymHeap &sh, const bool incremental):
+    d(new Private(sh, incremental))
+{
+}
+
+SegDiscovery::~SegDiscovery()
+{
+    delete d;
+}
+
+bool SegDiscovery::discoverBestAbstraction(Shape *pDst)
+{
+    SegDiscoveryStats &st = segDiscoveryStatsData;
+    ++st.cntRounds;
+
     TSegCandidateList candidates;
+    std::vector<bool> fresh;
 
     // go through all potential segment entries
     TObjList heapObjs;
-    sh.gatherObjects(heapObjs, isOnHeap);
+    d->sh.gatherObjects(heapObjs, isOnHeap);
     for (const TObjId obj : heapObjs) {
-        /// probe neighbouring objects
-        SegCandidate segc;
-        digShapePropsCandidates(&segc.propsList, sh, obj);
-        if (segc.propsList.empty())
-            // found nothing
+        const Private::TCache::const_iterator it = d->cache.find(obj);
+        if (it != d->cache.end()) {
+            // the candidate has not been affected since the last round
+            const SegCandidate &segc = it->second;
+            if (segc.propsList.empty())
+                continue;
+
+            st.cntReused += segc.propsList.size();
+            candidates.push_back(segc);
+            fresh.push_back(false);
             continue;
+        }
 
-        // append a segment candidate
+        // probe neighbouring objects
+        SegCandidate segc;
         segc.entry = obj;
+        digShapePropsCandidates(&segc.propsList, d->sh, obj);
         candidates.push_back(segc);
+        fresh.push_back(true);
     }
 
-    return selectBestAbstraction(pDst, sh, candidates);
+    // schedule the (entry, props) pairs that need to be evaluated
+    const unsigned cntCands = candidates.size();
+    TCandPairList pairs;
+    bool outOfBudget = false;
+    for (unsigned candIdx = 0; candIdx < cntCands && !outOfBudget; ++candIdx) {
+        if (!fresh[candIdx])
+            continue;
+
+        const unsigned cntProps = candidates[candIdx].propsList.size();
+        for (unsigned propsIdx = 0; propsIdx < cntProps; ++propsIdx) {
+            if ((SE_ABSTRACTION_WORK_BUDGET) && !d->budget) {
+                outOfBudget = true;
+                ++st.cntBudgetHits;
+                break;
+            }
+
+            pairs.push_back(TCandPair(candIdx, propsIdx));
+            if (SE_ABSTRACTION_WORK_BUDGET)
+                --d->budget;
+        }
+    }
+
+    TRankMapList ranks;
+    d->evaluate(ranks, candidates, pairs, heapObjs.size());
+    st.cntCandidates += pairs.size();
+
+    // store the rank maps to their candidates
+    const unsigned cntPairs = pairs.size();
+    for (unsigned idx = 0; idx < cntPairs; ++idx) {
+        SegCandidate &segc = candidates[pairs[idx].first];
+        CL_BREAK_IF(segc.rankList.size() != pairs[idx].second);
+        segc.rankList.push_back(ranks[idx]);
+    }
+
+    for (unsigned candIdx = 0; candIdx < cntCands; ++candIdx) {
+        if (!fresh[candIdx])
+            continue;
+
+        SegCandidate &segc = candidates[candIdx];
+        if (segc.rankList.size() != segc.propsList.size()) {
+            // out of budget, do not cache the incomplete result
+            segc.propsList.resize(segc.rankList.size());
+            continue;
+        }
+
+        if (d->incremental)
+            d->cache[segc.entry] = segc;
+    }
+
+    return selectBestAbstraction(pDst, d->sh, candidates);
+}
+
+void SegDiscovery::invalidate(const Shape &shape)
+{
+    if (d->cache.empty())
+        return;
+
+    SymHeap &sh = d->sh;
+
+    // the objects of shape are going to be merged together with everything
+    // reachable from them (prototypes and the data they share)
+    TObjList shapeObjs;
+    objListByShape(&shapeObjs, sh, shape);
+
+    WorkList<TObjId> wlFwd;
+    for (const TObjId obj : shapeObjs)
+        wlFwd.schedule(obj);
+
+    TObjSet affected;
+    TObjId obj;
+    while (wlFwd.next(obj)) {
+        affected.insert(obj);
+
+        FldList fields;
+        sh.gatherLiveFields(fields, obj);
+        for (const FldHandle &fld : fields) {
+            const TValId val = fld.value();
+            if (val <= 0 || !isAnyDataArea(sh.valTarget(val)))
+                continue;
+
+            const TObjId target = sh.objByAddr(val);
+            if (sh.isValid(target))
+                wlFwd.schedule(target);
+        }
+    }
+
+    // whoever can reach an affected object needs to be evaluated again
+    WorkList<TObjId> wlBwd;
+    for (const TObjId obj : affected)
+        wlBwd.schedule(obj);
+
+    while (wlBwd.next(obj)) {
+        d->cache.erase(obj);
+
+        FldList refs;
+        sh.pointedBy(refs, obj);
+        for (const FldHandle &fld : refs)
+            wlBwd.schedule(fld.obj());
+    }
+}
+
+bool discoverBestAbstraction(Shape *pDst, SymHeap &sh)
+{
+    SegDiscovery discovery(sh, /* incremental */ false);
+    return discovery.discoverBestAbstraction(pDst);
 }
@@ -48,4 +48,48 @@ bool canMergeObjWithNextObj(
  */
 bool discoverBestAbstraction(Shape *pDst, SymHeap &sh);
 
+/// counters of list segment discovery, accumulated over the whole run
+struct SegDiscoveryStats {
+    unsigned long       cntRounds;          ///< calls of discoverBestAbstraction
+    unsigned long       cntCandidates;      ///< (entry, props) pairs evaluated
+    unsigned long       cntReused;          ///< (entry, props) pairs reused
+    unsigned long       cntBudgetHits;      ///< rounds that ran out of budget
+    unsigned long       cntParallelRounds;  ///< rounds evaluated by workers
+    unsigned long       cntSegsIntroduced;  ///< abstractions actually applied
+};
+
+/// access the global counters of list segment discovery
+SegDiscoveryStats& segDiscoveryStats();
+
+/// print the global counters of list segment discovery (CL_NOTE)
+void printSegDiscoveryStats();
+
+/**
+ * list segment discovery over a single symbolic heap, which may be repeated
+ * after each abstraction step.  In the incremental mode, the results of entry
+ * candidates that cannot reach any object affected by the previous abstraction
+ * are reused in the subsequent rounds.  The count of (entry, props) pairs
+ * evaluated over the lifetime of the object is bounded by
+ * SE_ABSTRACTION_WORK_BUDGET.
+ */
+class SegDiscovery {
+    public:
+        SegDiscovery(SymHeap &sh, bool incremental);
+        ~SegDiscovery();
+
+        /// same as ::discoverBestAbstraction() but reuses cached results
+        bool discoverBestAbstraction(Shape *pDst);
+
+        /// to be called @b before the abstraction of shape is applied
+        void invalidate(const Shape &shape);
+
+    private:
+        // not implemented
+        SegDiscovery(const SegDiscovery &);
+        SegDiscovery& operator=(const SegDiscovery &);
+
+        struct Private;
+        Private *d;
+};
+
 #endif /* H_GUARD_SYMDISCOVER_H */
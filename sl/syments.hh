@@ -24,6 +24,8 @@
 
 #include "util.hh"
 
+#include <cl/memdebug.hh>
+
 #include <vector>
 
 #if SH_COPY_ON_WRITE
@@ -197,7 +199,8 @@ class EntStore {
         // intentionally not implemented
         EntStore& operator=(const EntStore &);
 
-        std::vector<TBaseEnt *>                 ents_;
+        typedef MemAccountingAllocator<TBaseEnt *, MC_SYM_HEAPS> TAlloc;
+        std::vector<TBaseEnt *, TAlloc>         ents_;
         EntCounter                             *entCnt_;
 };
 
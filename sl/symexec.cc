@@ -24,25 +24,38 @@
 #include <cl/cldebug.hh>
 #include <cl/clutil.hh>
 #include <cl/memdebug.hh>
+#include <cl/metrics.hh>
 #include <cl/storage.hh>
+#include <cl/timeline.hh>
 
 #include "fixed_point_proxy.hh"
 #include "glconf.hh"
+#include "governor.hh"
+#include "partition.hh"
+#include "profiler.hh"
 #include "sigcatch.hh"
+#include "strpool.hh"
 #include "symabstract.hh"
 #include "symcall.hh"
 #include "symdebug.hh"
+#include "symdiscover.hh"
 #include "symproc.hh"
 #include "symstate.hh"
 #include "symutil.hh"
 #include "symtrace.hh"
 #include "util.hh"
+#include "vra_ranges.hh"
 
 #include <queue>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 
+static Metrics::Histogram heapsPerBlockHist("symexec.heaps_per_block");
+static Metrics::Histogram entitiesPerHeapHist("symexec.entities_per_heap");
+static Metrics::Histogram callDepthHist("symexec.call_depth");
+static Metrics::Gauge callDepthGauge("symexec.call_depth_now");
+
 LOCAL_DEBUG_PLOTTER(nondetCond, DEBUG_SE_NONDET_COND)
 
 bool installSignalHandlers(void)
@@ -84,6 +97,9 @@ class SymExec: public IStatsProvider {
                 const CodeStorage::Insn     &insn,
                 const CodeStorage::Fnc      &fnc);
 
+        /// split the work among forked processes if allowed to do so
+        Partition::Slice splitWork(unsigned cntParts);
+
         virtual void printStats() const;
 
     private:
@@ -107,22 +123,31 @@ class SymExecEngine: public IStatsProvider {
         SymExecEngine(
                 SymState                &results,
                 const SymHeap           &entry,
-                const IStatsProvider    &stats,
+                SymExec                 &exec,
                 SymBackTrace            &bt):
             stor_(entry.stor()),
             bt_(bt),
             dst_(results),
-            stats_(stats),
+            exec_(exec),
             sched_(stateMap_),
             block_(0),
             insnIdx_(0),
             heapIdx_(0),
             waiting_(false),
-            endReached_(false)
+            endReached_(false),
+            partitioned_(false),
+            dropPending_(false),
+            timelineStart_((Timeline::enabled()) ? Timeline::now() : -1.0)
         {
             this->initEngine(entry);
         }
 
+        ~SymExecEngine() {
+            if (0.0 <= timelineStart_)
+                // record the whole call frame as a phase of the timeline
+                Timeline::record(fncName_ + "()", timelineStart_);
+        }
+
     public:
         bool /* complete */ run();
 
@@ -135,12 +160,20 @@ class SymExecEngine: public IStatsProvider {
         bool                            endReached() const;
         void                            forceEndReached();
 
+        /**
+         * the work of this call frame has been split among processes
+         * @param keepPending false if the work pending at the time of the split
+         * is explored by another process
+         */
+        void                            markPartitioned(bool keepPending);
+
     private:
         const CodeStorage::Storage      &stor_;
         SymBackTrace                    &bt_;
         SymState                        &dst_;
-        const IStatsProvider            &stats_;
+        SymExec                         &exec_;
         std::string                     fncName_;
+        std::string                     profStack_;
         TObjType                        fncReturnType_;
 
         SymStateMap                     stateMap_;
@@ -150,6 +183,9 @@ class SymExecEngine: public IStatsProvider {
         unsigned                        heapIdx_;
         bool                            waiting_;
         bool                            endReached_;
+        bool                            partitioned_;
+        bool                            dropPending_;
+        const double                    timelineStart_;
 
         SymHeapList                     localState_;
         SymHeapList                     nextLocalState_;
@@ -205,6 +241,8 @@ void SymExecEngine::initEngine(const SymHeap &init)
     const CodeStorage::Fnc &fnc = *bt_.topFnc();
     fncName_ = nameOf(fnc);
     lw_ = locationOf(fnc);
+    if (Profiler::enabled())
+        profStack_ = Profiler::stackOf(bt_);
     CL_DEBUG_MSG(lw_, ">>> entering " << fncName_ << "()");
 
     const TObjType fncType = fnc.def.type;
@@ -310,13 +348,31 @@ void SymExecEngine::updateState(SymHeap &sh, const CodeStorage::Block *ofBlock)
 #if SE_ABSTRACT_ON_LOOP_EDGES_ONLY
     if (closingLoop)
 #endif
+    {
+        const Profiler::Probe probe(Profiler::PE_ABSTRACT, profStack_,
+                *block_->back());
         abstractIfNeeded(sh);
+    }
 
     if (!GlConf::data.joinOnLoopEdgesOnly)
         closingLoop = true;
 
     // update _target_ state and check if anything has changed
-    if (stateMap_.insert(ofBlock, sh, closingLoop)) {
+    bool changed;
+    {
+        const Profiler::Probe probe(Profiler::PE_JOIN, profStack_,
+                *ofBlock->front());
+        changed = stateMap_.insert(ofBlock, sh, closingLoop);
+    }
+
+    const unsigned cntHeaps = stateMap_[ofBlock].size();
+    heapsPerBlockHist.add(cntHeaps);
+    entitiesPerHeapHist.add(sh.lastId());
+
+    if (Profiler::enabled())
+        Profiler::updatePeakState(ofBlock, cntHeaps);
+
+    if (changed) {
         const SymStateMarked &target = stateMap_[ofBlock];
 
         // schedule for next wheel (if not already)
@@ -518,6 +574,14 @@ void SymExecEngine::execCondInsn()
         return;
     }
 
+    bool branch;
+    if (vraDecideCond(&branch, block_, *insnCnd)) {
+        // the other branch has been proven infeasible by vra
+        CL_DEBUG_MSG(lw_, "-V- CL_INSN_COND decided by vra");
+        this->updateStateInBranch(sh, branch, *insnCmp, *insnCnd, v1, v2);
+        return;
+    }
+
     if (this->bypassNonPointers(proc, *insnCmp, *insnCnd, v1, v2))
         // do not track relations over data we are not interested in
         return;
@@ -538,11 +602,20 @@ void SymExecEngine::execCondInsn()
         LDP_PLOT(nondetCond, sh);
     }
 
-    CL_DEBUG_MSG(lw_, "?T? CL_INSN_COND updates TRUE branch");
-    this->updateStateInBranch(sh, true,  *insnCmp, *insnCnd, v1, v2);
+    // explore each of the branches by a separate process if allowed to
+    Partition::Slice slice = { /* idx */ 0U, /* cnt */ 1U };
+    if (Partition::enabled())
+        slice = exec_.splitWork(/* then, else */ 2U);
+
+    if (slice.owns(/* then label */ 0)) {
+        CL_DEBUG_MSG(lw_, "?T? CL_INSN_COND updates TRUE branch");
+        this->updateStateInBranch(sh, true,  *insnCmp, *insnCnd, v1, v2);
+    }
 
-    CL_DEBUG_MSG(lw_, "?F? CL_INSN_COND updates FALSE branch");
-    this->updateStateInBranch(sh, false, *insnCmp, *insnCnd, v1, v2);
+    if (slice.owns(/* else label */ 1)) {
+        CL_DEBUG_MSG(lw_, "?F? CL_INSN_COND updates FALSE branch");
+        this->updateStateInBranch(sh, false, *insnCmp, *insnCnd, v1, v2);
+    }
 }
 
 void SymExecEngine::execAbort()
@@ -671,6 +744,14 @@ bool /* complete */ SymExecEngine::execInsn()
     // go through the remainder of symbolic heaps corresponding to localState_
     const unsigned hCnt = localState_.size();
     for (/* we allow resume */; heapIdx_ < hCnt; ++heapIdx_) {
+        if (dropPending_) {
+            // the remaining heaps are explored by another process
+            for (unsigned i = heapIdx_; !insnIdx_ && i < hCnt; ++i)
+                origin.setDone(i);
+
+            break;
+        }
+
         if (!insnIdx_) {
             if (origin.isDone(heapIdx_))
                 // for this particular symbolic heap, we already know the result
@@ -699,6 +780,10 @@ bool /* complete */ SymExecEngine::execInsn()
         // time to respond to a single pending signal
         this->processPendingSignals();
 
+        // account the time spent on this heap to the instruction (time spent
+        // by joins and abstractions in updateState() is accounted separately)
+        const Profiler::Probe probe(Profiler::PE_EXEC, profStack_, *insn);
+
         if (this->handleExitPoint(localState_[heapIdx_]))
             // program exited on this execution path, go directly to the caller
             continue;
@@ -722,6 +807,7 @@ bool /* complete */ SymExecEngine::execInsn()
         localState_.swap(nextLocalState_);
 
     // completed execution of the given insn
+    dropPending_ = false;
     heapIdx_ = 0;
     return true;
 }
@@ -789,10 +875,20 @@ void SymExecEngine::joinCallResults()
 #else
     SymHeapUnion all;
 #endif
+    const unsigned cnt = callResults_.size();
+
+    // explore the results by separate processes if allowed to
+    Partition::Slice slice = { /* idx */ 0U, /* cnt */ 1U };
+    if (Partition::enabled())
+        slice = exec_.splitWork(cnt);
+
     all.swap(nextLocalState_);
 
-    const unsigned cnt = callResults_.size();
     for (unsigned i = 0; i < cnt; ++i) {
+        if (!slice.owns(i))
+            // explored by another process
+            continue;
+
         if (1 < cnt) {
             CL_DEBUG("*** SymExecEngine::joinCallResults() is processing heap #"
                      << i << " of " << cnt << " heaps total (size of target is "
@@ -852,7 +948,12 @@ bool /* complete */ SymExecEngine::run()
     int debugFixedPoint = (DEBUG_SE_FIXED_POINT);
 
     const struct cl_loc *loc = locationOf(fnc);
-    if (!endReached_) {
+    if (!endReached_ && partitioned_) {
+        // the end may have been reached by another process
+        CL_DEBUG_MSG(loc, "end of function "
+                << nameOf(fnc) << "() has not been reached by this process");
+    }
+    else if (!endReached_) {
         CL_WARN_MSG(loc, "end of function "
                 << nameOf(fnc) << "() has not been reached");
 #if DEBUG_SE_END_NOT_REACHED
@@ -932,9 +1033,9 @@ void SymExecEngine::dumpStateMap(int flags)
     if (!flags)
         return;
 
-    if (SE_STATE_PRUNING_MODE) {
+    if (GlConf::data.statePruningMode) {
         CL_WARN("fixed-point dump poisoned by SE_STATE_PRUNING_MODE = "
-                << (SE_STATE_PRUNING_MODE));
+                << GlConf::data.statePruningMode);
     }
 
     // obtain the list of visisted blocks
@@ -1008,15 +1109,49 @@ void SymExecEngine::forceEndReached()
     endReached_ = true;
 }
 
+void SymExecEngine::markPartitioned(const bool keepPending)
+{
+    partitioned_ = true;
+    if (keepPending)
+        return;
+
+    // drop the results of the heaps processed so far by the current insn
+    dropPending_ = true;
+    nextLocalState_.clear();
+
+    // drop all blocks waiting in the queue, including their heaps
+    const BlockScheduler::TBlockSet todo(sched_.todo());
+    sched_.clear();
+    for (const BlockScheduler::TBlock bb : todo) {
+        SymStateMarked &state = stateMap_[bb];
+        const unsigned cnt = state.size();
+        for (unsigned i = 0; i < cnt; ++i)
+            state.setDone(i);
+    }
+}
+
 void SymExecEngine::processPendingSignals()
 {
+    // rewrite the metrics file once in a while if asked to do so
+    Metrics::tick();
+
+    // trade precision for resources if the analysis runs out of its budget
+    if (Governor::GL_GIVE_UP == Governor::tick()) {
+        CL_WARN_MSG(lw_, "resource budget exhausted, the verdict is unknown");
+        throw std::runtime_error("resource budget exhausted");
+    }
+
     int signum;
     if (!SignalCatcher::caught(&signum))
         return;
 
     CL_WARN_MSG(lw_, "caught signal " << signum);
-    stats_.printStats();
+    exec_.printStats();
     printMemUsage("SymExec::printStats");
+    printMemAccounting();
+    dumpCallCacheStats();
+    Profiler::dump();
+    Metrics::dump();
 
     switch (signum) {
         case SIGUSR1:
@@ -1030,14 +1165,20 @@ void SymExecEngine::processPendingSignals()
 
 void SymExecEngine::pruneOrigin()
 {
-#if SE_STATE_PRUNING_MODE
+    // the resource governor may ask us to prune whatever we can
+    const bool forced = (Governor::GL_FORCE_PRUNING <= Governor::level());
+    const int mode = GlConf::data.statePruningMode;
+    if (!mode && !forced)
+        return;
+
     if (block_->isLoopEntry())
-#endif
         // never prune loop entry, it would break the fixed-point computation
         return;
 
     SymStateMarked &origin = stateMap_[block_];
     const unsigned size = origin.size();
+    if (forced)
+        goto thr_reached;
 
 #if SE_STATE_PRUNING_MISS_THR
     if (!stateMap_.anyReuseHappened(block_)
@@ -1050,21 +1191,15 @@ void SymExecEngine::pruneOrigin()
         goto thr_reached;
 #endif
 
-#if SE_STATE_PRUNING_MODE < 2
-    if (!cl_is_term_insn(block_->front()->code)
+    if (mode < 2 && !cl_is_term_insn(block_->front()->code)
             && (CL_INSN_COND != block_->back()->code || 2 < block_->size()))
         return;
-#endif
 
-#if SE_STATE_PRUNING_MODE < 3
-    if (1 < block_->inbound().size())
+    if (mode < 3 && 1 < block_->inbound().size())
         // more than one incoming edges, keep this one
         return;
-#endif
 
-#if SE_STATE_PRUNING_MISS_THR || SE_STATE_PRUNING_TOTAL_THR
 thr_reached:
-#endif
     if (0x100 < size)
         printMemUsage("SymExecEngine::execInsn");
 
@@ -1183,7 +1318,7 @@ void SymExec::enterCall(SymCallCtx *ctx, SymState &results)
     SymExecEngine *eng = new SymExecEngine(
             ctx->rawResults(),
             ctx->entry(),
-            /* IStatsProvider */ *this,
+            *this,
             callCache_.bt());
 
     // initialize a stack item
@@ -1194,6 +1329,10 @@ void SymExec::enterCall(SymCallCtx *ctx, SymState &results)
 
     // push the item to the exec-stack
     execStack_.push_front(item);
+
+    const unsigned depth = execStack_.size();
+    callDepthHist.add(depth);
+    callDepthGauge.set(depth);
     printMemUsage("SymExec::enterCall");
 }
 
@@ -1231,6 +1370,7 @@ void SymExec::execFnc(
             delete engine;
             printMemUsage("SymExecEngine::~SymExecEngine");
             execStack_.pop_front();
+            callDepthGauge.set(execStack_.size());
 
             if (!execStack_.empty() && forceEndReached)
                 // well, we got no results, but the callee suggests to be silent
@@ -1277,9 +1417,32 @@ void SymExec::execFnc(
     }
 }
 
+Partition::Slice SymExec::splitWork(const unsigned cntParts)
+{
+    const Partition::Slice slice = Partition::split(cntParts);
+    if (slice.cnt < 2U)
+        // nothing has been split
+        return slice;
+
+    CL_DEBUG("SymExec::splitWork() explores part #" << slice.idx
+            << " of " << slice.cnt << " in this process");
+
+    // none of the calls in progress is going to compute all of its results
+    callCache_.markCallsInProgressPartial();
+
+    // the first process keeps the work that was pending at the time of split
+    const bool keepPending = !slice.idx;
+    for (const ExecStackItem &item : execStack_)
+        item.eng->markPartitioned(keepPending);
+
+    return slice;
+}
+
 void SymExec::printStats() const
 {
-    // TODO: print SymCallCache stats here as soon as we have implemented some
+    callCache_.printStats();
+    printSegDiscoveryStats();
+    StrPool::printStats();
 
     for (const ExecStackItem &item : execStack_) {
         const IStatsProvider *provider = item.eng;
@@ -1301,6 +1464,10 @@ void execTopCall(
         se.execFnc(results, entry, insn, fnc);
         // SymExec::~SymExec() is going to be executed as leaving this block
     }
+    catch (const Partition::Delegated &) {
+        // the analysis has been completed by forked processes
+        throw;
+    }
     catch (const std::runtime_error &e) {
         const struct cl_loc *loc = locationOf(fnc);
         CL_WARN_MSG(loc, "symbolic execution terminates prematurely");
@@ -21,6 +21,7 @@
 #include "symgc.hh"
 
 #include <cl/cl_msg.hh>
+#include <cl/timeline.hh>
 
 #include "symheap.hh"
 #include "symplot.hh"
@@ -77,6 +78,7 @@ bool isJunk(SymHeap &sh, TObjId obj)
 
 bool gcCore(SymHeap &sh, TObjId obj, TObjSet *leakObjs, bool sharedOnly)
 {
+    const Timeline::Scope timelineScope("collectJunk");
     if (OBJ_INVALID == obj)
         return false;
 
@@ -0,0 +1,823 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file symheap-bench.cc
+ * micro-benchmarks of SymHeap primitives on synthetic heaps (SLL, DLL, nested
+ * lists, trees, and arrays of structs), reporting ns/op and allocations/op
+ */
+
+#include "config.h"
+
+#include <cl/code_listener.h>
+#include <cl/easy.hh>
+#include <cl/storage.hh>
+#include <cl/timeline.hh>
+
+#include "symabstract.hh"
+#include "symcmp.hh"
+#include "symcut.hh"
+#include "symgc.hh"
+#include "symheap.hh"
+#include "symjoin.hh"
+#include "symtrace.hh"
+#include "symutil.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <string>
+#include <vector>
+
+// /////////////////////////////////////////////////////////////////////////////
+// libcl requires the analyzer to define clEasyRun(), it is never called here
+void clEasyRun(const CodeStorage::Storage &, const char *)
+{
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// allocation counting (all allocations of the process go through this)
+//
+// The replacements are not inlined, so that the compiler does not complain
+// about free() of memory obtained from operator new.
+static unsigned long cntAllocs;
+static unsigned long cntAllocBytes;
+
+__attribute__((noinline))
+void* operator new(std::size_t size)
+{
+    ++cntAllocs;
+    cntAllocBytes += size;
+
+    void *ptr = malloc(size ? size : 1U);
+    if (!ptr)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+__attribute__((noinline))
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+__attribute__((noinline))
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    free(ptr);
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// synthetic type-info and program variables
+static const int ptrSize = sizeof(void *);
+
+struct Field {
+    const char             *name;
+    const struct cl_type   *type;
+};
+
+class BenchStor {
+    public:
+        CodeStorage::Storage            stor;
+
+        const struct cl_type           *cltInt;
+        const struct cl_type           *cltSll;
+        const struct cl_type           *cltDll;
+        const struct cl_type           *cltTop;
+        const struct cl_type           *cltTree;
+        const struct cl_type           *cltItem;
+
+        BenchStor(unsigned cntItems);
+
+        /// create a global variable of the given type and return its CVar
+        CVar addGlVar(const char *name, const struct cl_type *clt);
+
+    private:
+        struct cl_type* addType(enum cl_type_e code, int size);
+        struct cl_type* addPtr(const struct cl_type *target);
+        struct cl_type* addStruct(const char *name);
+        void setFields(struct cl_type *clt, const std::vector<Field> &fields);
+
+        std::deque<struct cl_type>              types_;
+        std::deque<std::vector<cl_type_item> > items_;
+        cl_uid_t                                lastUid_;
+        int                                     cntGlVars_;
+};
+
+BenchStor::BenchStor(const unsigned cntItems):
+    lastUid_(0),
+    cntGlVars_(0)
+{
+    cltInt = this->addType(CL_TYPE_INT, sizeof(int));
+
+    // void * makes the generic data pointer of TypeDb
+    const struct cl_type *cltVoid = this->addType(CL_TYPE_VOID, 0);
+    this->addPtr(cltVoid);
+
+    struct cl_type *sll  = this->addStruct("sll");
+    struct cl_type *dll  = this->addStruct("dll");
+    struct cl_type *top  = this->addStruct("top");
+    struct cl_type *tree = this->addStruct("tree");
+    struct cl_type *item = this->addStruct("item");
+
+    const struct cl_type *sllPtr = this->addPtr(sll);
+    const struct cl_type *dllPtr = this->addPtr(dll);
+    const struct cl_type *topPtr = this->addPtr(top);
+    const struct cl_type *treePtr = this->addPtr(tree);
+
+    // struct sll { struct sll *next; int data; }
+    std::vector<Field> fields;
+    fields.push_back(Field { "next", sllPtr });
+    fields.push_back(Field { "data", cltInt });
+    this->setFields(sll, fields);
+
+    // struct dll { struct dll *next; struct dll *prev; int data; }
+    fields.clear();
+    fields.push_back(Field { "next", dllPtr });
+    fields.push_back(Field { "prev", dllPtr });
+    fields.push_back(Field { "data", cltInt });
+    this->setFields(dll, fields);
+
+    // struct top { struct top *next; struct sll *child; }
+    fields.clear();
+    fields.push_back(Field { "next", topPtr });
+    fields.push_back(Field { "child", sllPtr });
+    this->setFields(top, fields);
+
+    // struct tree { struct tree *left; struct tree *right; int data; }
+    fields.clear();
+    fields.push_back(Field { "left", treePtr });
+    fields.push_back(Field { "right", treePtr });
+    fields.push_back(Field { "data", cltInt });
+    this->setFields(tree, fields);
+
+    // struct item { struct sll *p; int data; }
+    fields.clear();
+    fields.push_back(Field { "p", sllPtr });
+    fields.push_back(Field { "data", cltInt });
+    this->setFields(item, fields);
+
+    cltSll  = sll;
+    cltDll  = dll;
+    cltTop  = top;
+    cltTree = tree;
+    cltItem = item;
+
+    // struct item items[cntItems]
+    struct cl_type *arr = this->addType(CL_TYPE_ARRAY, cntItems * item->size);
+    arr->array_size = cntItems;
+    items_.push_back(std::vector<cl_type_item>(1U));
+    items_.back()[0].type = item;
+    arr->item_cnt = 1;
+    arr->items = &items_.back()[0];
+
+    this->addGlVar("sll_head",  sllPtr);
+    this->addGlVar("dll_head",  dllPtr);
+    this->addGlVar("top_head",  topPtr);
+    this->addGlVar("tree_root", treePtr);
+    this->addGlVar("items",     arr);
+}
+
+struct cl_type* BenchStor::addType(const enum cl_type_e code, const int size)
+{
+    types_.push_back(cl_type());
+    struct cl_type *clt = &types_.back();
+    memset(clt, 0, sizeof *clt);
+    clt->uid = ++lastUid_;
+    clt->code = code;
+    clt->loc = cl_loc_unknown;
+    clt->scope = CL_SCOPE_GLOBAL;
+    clt->size = size;
+    clt->ptr_type = CL_PTR_TYPE_NOT_PTR;
+    return clt;
+}
+
+struct cl_type* BenchStor::addPtr(const struct cl_type *target)
+{
+    struct cl_type *clt = this->addType(CL_TYPE_PTR, ptrSize);
+    clt->ptr_type = CL_PTR_TYPE_BASIC;
+
+    items_.push_back(std::vector<cl_type_item>(1U));
+    items_.back()[0].type = target;
+    clt->item_cnt = 1;
+    clt->items = &items_.back()[0];
+
+    stor.types.insert(clt);
+    return clt;
+}
+
+struct cl_type* BenchStor::addStruct(const char *name)
+{
+    struct cl_type *clt = this->addType(CL_TYPE_STRUCT, 0);
+    clt->name = name;
+    return clt;
+}
+
+void BenchStor::setFields(struct cl_type *clt, const std::vector<Field> &fields)
+{
+    std::vector<cl_type_item> items;
+    int off = 0;
+    for (const Field &fld : fields) {
+        // pointers and ints are naturally aligned, no padding inside
+        const cl_type_item item = { fld.type, fld.name, off };
+        items.push_back(item);
+        off += fld.type->size;
+    }
+
+    // pad the struct to the size of pointer
+    clt->size = (off + ptrSize - 1) / ptrSize * ptrSize;
+
+    items_.push_back(items);
+    clt->item_cnt = items.size();
+    clt->items = &items_.back()[0];
+    stor.types.insert(clt);
+}
+
+CVar BenchStor::addGlVar(const char *name, const struct cl_type *clt)
+{
+    stor.types.insert(clt);
+
+    const cl_uid_t uid = ++lastUid_;
+    CodeStorage::Var &var = stor.vars[uid];
+    var.code = CodeStorage::VAR_GL;
+    var.type = clt;
+    var.uid = uid;
+    var.name = name;
+
+    // normally assigned by ClStorageBuilder once the storage is complete
+    var.denseIdx = cntGlVars_++;
+    return CVar(uid, /* gl var */ 0);
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// synthetic heap generators
+struct Synth {
+    SymHeap                     sh;
+    CVar                        root;       ///< pointer at offset 0 is the root
+    TObjId                      rootObj;
+    std::vector<TObjId>         nodes;      ///< concrete objects, in order
+
+    Synth(TStorRef stor, const CVar &root_):
+        sh(stor, new Trace::TransientNode("symheap-bench")),
+        root(root_),
+        rootObj(sh.regionByVar(root_, /* createIfNeeded */ true))
+    {
+    }
+};
+
+static TObjId allocNode(Synth &syn, const struct cl_type *clt)
+{
+    SymHeap &sh = syn.sh;
+    const TObjId obj = sh.heapAlloc(IR::rngFromNum(clt->size));
+    sh.objSetEstimatedType(obj, clt);
+    syn.nodes.push_back(obj);
+    return obj;
+}
+
+static void setPtr(SymHeap &sh, TObjId obj, TOffset off, TObjId target)
+{
+    const TValId val = (OBJ_INVALID == target)
+        ? VAL_NULL
+        : sh.addrOfTarget(target, TS_REGION);
+
+    PtrHandle ptr(sh, obj, off);
+    ptr.setValue(val);
+}
+
+static void setInt(SymHeap &sh, TObjId obj, TOffset off, TObjType clt, int n)
+{
+    const FldHandle fld(sh, obj, clt, off);
+    fld.setValue(sh.valWrapCustom(CustomValue(IR::rngFromNum(n))));
+}
+
+/// build an SLL of the given length, return its head (or OBJ_INVALID)
+static TObjId buildSll(Synth &syn, const BenchStor &bs, unsigned len)
+{
+    TObjId next = OBJ_INVALID;
+    for (; len; --len) {
+        const TObjId obj = allocNode(syn, bs.cltSll);
+        setPtr(syn.sh, obj, /* next */ 0, next);
+        setInt(syn.sh, obj, /* data */ ptrSize, bs.cltInt, 0);
+        next = obj;
+    }
+
+    return next;
+}
+
+static void genSll(Synth &syn, const BenchStor &bs, const unsigned len)
+{
+    const TObjId head = buildSll(syn, bs, len);
+    setPtr(syn.sh, syn.rootObj, 0, head);
+}
+
+static void genDll(Synth &syn, const BenchStor &bs, const unsigned len)
+{
+    SymHeap &sh = syn.sh;
+    TObjId prev = OBJ_INVALID;
+    for (unsigned i = 0; i < len; ++i) {
+        const TObjId obj = allocNode(syn, bs.cltDll);
+        setPtr(sh, obj, /* prev */ ptrSize, prev);
+        setInt(sh, obj, /* data */ 2 * ptrSize, bs.cltInt, 0);
+        if (OBJ_INVALID == prev)
+            setPtr(sh, syn.rootObj, 0, obj);
+        else
+            setPtr(sh, prev, /* next */ 0, obj);
+
+        prev = obj;
+    }
+
+    if (OBJ_INVALID != prev)
+        setPtr(sh, prev, /* next */ 0, OBJ_INVALID);
+}
+
+static void genNested(
+        Synth                  &syn,
+        const BenchStor        &bs,
+        const unsigned          len,
+        const unsigned          lenInner)
+{
+    SymHeap &sh = syn.sh;
+    TObjId next = OBJ_INVALID;
+    for (unsigned i = 0; i < len; ++i) {
+        const TObjId child = buildSll(syn, bs, lenInner);
+        const TObjId obj = allocNode(syn, bs.cltTop);
+        setPtr(sh, obj, /* next */ 0, next);
+        setPtr(sh, obj, /* child */ ptrSize, child);
+        next = obj;
+    }
+
+    setPtr(sh, syn.rootObj, 0, next);
+}
+
+static void genTree(Synth &syn, const BenchStor &bs, const unsigned cnt)
+{
+    SymHeap &sh = syn.sh;
+    for (unsigned i = 0; i < cnt; ++i) {
+        const TObjId obj = allocNode(syn, bs.cltTree);
+        setInt(sh, obj, /* data */ 2 * ptrSize, bs.cltInt, 0);
+    }
+
+    // complete binary tree laid out as a binary heap
+    for (unsigned i = 0; i < cnt; ++i) {
+        for (unsigned son = 1; son <= 2; ++son) {
+            const unsigned idx = 2 * i + son;
+            const TObjId target = (idx < cnt) ? syn.nodes[idx] : OBJ_INVALID;
+            setPtr(sh, syn.nodes[i], (son - 1) * ptrSize, target);
+        }
+    }
+
+    setPtr(sh, syn.rootObj, 0, (cnt) ? syn.nodes[0] : OBJ_INVALID);
+}
+
+static void genArray(Synth &syn, const BenchStor &bs, const unsigned cnt)
+{
+    SymHeap &sh = syn.sh;
+    const int size = bs.cltItem->size;
+    for (unsigned i = 0; i < cnt; ++i) {
+        const TObjId obj = allocNode(syn, bs.cltSll);
+        setPtr(sh, obj, /* next */ 0, OBJ_INVALID);
+        setPtr(sh, syn.rootObj, /* p */ i * size, obj);
+        setInt(sh, syn.rootObj, /* data */ i * size + ptrSize, bs.cltInt, i);
+    }
+}
+
+enum EShape {
+    SH_SLL,
+    SH_DLL,
+    SH_NESTED,
+    SH_TREE,
+    SH_ARRAY,
+    SH_TOTAL
+};
+
+static const char *shapeNames[SH_TOTAL] = {
+    "sll",
+    "dll",
+    "nested",
+    "tree",
+    "array"
+};
+
+struct Params {
+    unsigned                    len;        ///< length of lists, size of trees
+    unsigned                    lenInner;   ///< length of nested lists
+    double                      minTime;    ///< seconds spent per benchmark
+};
+
+static void generate(
+        Synth                  *pDst,
+        const BenchStor        &bs,
+        const EShape            shape,
+        const Params           &par)
+{
+    switch (shape) {
+        case SH_SLL:    genSll(*pDst, bs, par.len);                     break;
+        case SH_DLL:    genDll(*pDst, bs, par.len);                     break;
+        case SH_NESTED: genNested(*pDst, bs, par.len, par.lenInner);    break;
+        case SH_TREE:   genTree(*pDst, bs, par.len);                    break;
+        case SH_ARRAY:  genArray(*pDst, bs, par.len);                   break;
+        case SH_TOTAL:  break;
+    }
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// benchmarks
+class Benchmark {
+    public:
+        Benchmark(const Synth &syn):
+            syn_(syn)
+        {
+        }
+
+        virtual ~Benchmark() { }
+
+        virtual const char* name() const = 0;
+
+        /// prepare inputs for cnt operations, not included in the measurement
+        virtual bool setup(unsigned cnt) {
+            work_.assign(cnt, syn_.sh);
+            return true;
+        }
+
+        /// the measured operation, idx is in the range given by setup()
+        virtual void run(unsigned idx) = 0;
+
+        /// release the inputs, not included in the measurement
+        virtual void teardown() {
+            work_.clear();
+        }
+
+    protected:
+        const Synth                &syn_;
+        std::vector<SymHeap>        work_;
+};
+
+/// copy and destroy a whole heap
+class BenchHeapCopy: public Benchmark {
+    public:
+        BenchHeapCopy(const Synth &syn): Benchmark(syn) { }
+        virtual const char* name() const { return "heap copy"; }
+        virtual bool setup(unsigned) { return true; }
+        virtual void run(unsigned) {
+            SymHeap sh(syn_.sh);
+            (void) sh;
+        }
+};
+
+/// clone a single concrete object (and its outgoing fields)
+class BenchObjClone: public Benchmark {
+    public:
+        BenchObjClone(const Synth &syn): Benchmark(syn) { }
+        virtual const char* name() const { return "objClone"; }
+        virtual void run(unsigned idx) {
+            const TObjId obj = syn_.nodes[idx % syn_.nodes.size()];
+            (void) work_[idx].objClone(obj);
+        }
+};
+
+/// read the first pointer of concrete objects in turn
+class BenchValueOf: public Benchmark {
+    public:
+        BenchValueOf(const Synth &syn): Benchmark(syn), sh_(syn.sh) { }
+        virtual const char* name() const { return "valueOf"; }
+        virtual bool setup(unsigned) { return true; }
+        virtual void run(unsigned idx) {
+            const TObjId obj = syn_.nodes[idx % syn_.nodes.size()];
+            const PtrHandle ptr(sh_, obj);
+            (void) ptr.value();
+        }
+
+    private:
+        SymHeap                     sh_;
+};
+
+/// look up the object of the root variable, as valFromOperand() does
+class BenchRegionByVar: public Benchmark {
+    public:
+        BenchRegionByVar(const Synth &syn): Benchmark(syn), sh_(syn.sh) { }
+        virtual const char* name() const { return "regionByVar"; }
+        virtual bool setup(unsigned) { return true; }
+        virtual void run(unsigned) {
+            if (OBJ_INVALID == sh_.regionByVar(syn_.root, false))
+                CL_BREAK_IF("symheap-bench: regionByVar() failed");
+        }
+
+    private:
+        SymHeap                     sh_;
+};
+
+/// make the first pointer of concrete objects point to the next object
+class BenchSetValueOf: public Benchmark {
+    public:
+        BenchSetValueOf(const Synth &syn): Benchmark(syn), sh_(syn.sh) { }
+        virtual const char* name() const { return "setValueOf"; }
+        virtual bool setup(unsigned) { return true; }
+        virtual void run(unsigned idx) {
+            const unsigned cnt = syn_.nodes.size();
+            const TObjId obj = syn_.nodes[idx % cnt];
+            const TObjId target = syn_.nodes[(idx + 1U) % cnt];
+            const PtrHandle ptr(sh_, obj);
+            ptr.setValue(sh_.addrOfTarget(target, TS_REGION));
+        }
+
+    private:
+        SymHeap                     sh_;
+};
+
+/// gather live fields of concrete objects in turn
+class BenchGatherLiveFields: public Benchmark {
+    public:
+        BenchGatherLiveFields(const Synth &syn): Benchmark(syn) { }
+        virtual const char* name() const { return "gatherLiveFields"; }
+        virtual bool setup(unsigned) { return true; }
+        virtual void run(unsigned idx) {
+            FldList fields;
+            const TObjId obj = syn_.nodes[idx % syn_.nodes.size()];
+            syn_.sh.gatherLiveFields(fields, obj);
+        }
+};
+
+/// compare the heap with an isomorphic copy built independently
+class BenchAreEqual: public Benchmark {
+    public:
+        BenchAreEqual(const Synth &syn, const Synth &twin):
+            Benchmark(syn),
+            twin_(twin)
+        {
+        }
+
+        virtual const char* name() const { return "areEqual"; }
+        virtual bool setup(unsigned) { return true; }
+        virtual void run(unsigned) {
+            if (!areEqual(syn_.sh, twin_.sh))
+                CL_BREAK_IF("symheap-bench: areEqual() failed");
+        }
+
+    private:
+        const Synth                &twin_;
+};
+
+/// join the heap with an isomorphic copy built independently
+class BenchJoin: public Benchmark {
+    public:
+        BenchJoin(const Synth &syn, const Synth &twin):
+            Benchmark(syn),
+            twin_(twin)
+        {
+        }
+
+        virtual const char* name() const { return "joinSymHeaps"; }
+        virtual bool setup(unsigned) { return true; }
+        virtual void run(unsigned) {
+            EJoinStatus status;
+            SymHeap result(syn_.sh.stor(),
+                    new Trace::TransientNode("symheap-bench"));
+            if (!joinSymHeaps(&status, &result, syn_.sh, twin_.sh))
+                CL_BREAK_IF("symheap-bench: joinSymHeaps() failed");
+        }
+
+    private:
+        const Synth                &twin_;
+};
+
+/// abstract a fully concrete heap
+class BenchAbstract: public Benchmark {
+    public:
+        BenchAbstract(const Synth &syn): Benchmark(syn) { }
+        virtual const char* name() const { return "abstractIfNeeded"; }
+        virtual void run(unsigned idx) {
+            abstractIfNeeded(work_[idx]);
+        }
+};
+
+/// concretize the object pointed by the root of an abstracted heap
+class BenchConcretize: public Benchmark {
+    public:
+        BenchConcretize(const Synth &syn):
+            Benchmark(syn),
+            shAbs_(syn.sh)
+        {
+            abstractIfNeeded(shAbs_);
+            const PtrHandle ptr(shAbs_, syn.rootObj);
+            const TValId val = ptr.value();
+            seg_ = shAbs_.objByAddr(val);
+            ts_ = shAbs_.targetSpec(val);
+        }
+
+        virtual const char* name() const { return "concretizeObj"; }
+
+        virtual bool setup(unsigned cnt) {
+            if (!isAbstractObject(shAbs_, seg_))
+                // nothing to concretize in this shape
+                return false;
+
+            work_.assign(cnt, shAbs_);
+            return true;
+        }
+
+        virtual void run(unsigned idx) {
+            TSymHeapList todo;
+            concretizeObj(work_[idx], todo, seg_, ts_);
+        }
+
+    private:
+        SymHeap                     shAbs_;
+        TObjId                      seg_;
+        ETargetSpecifier            ts_;
+};
+
+/// collect the whole data structure once the root pointer is lost
+class BenchCollectJunk: public Benchmark {
+    public:
+        BenchCollectJunk(const Synth &syn): Benchmark(syn) { }
+        virtual const char* name() const { return "collectJunk"; }
+
+        virtual bool setup(unsigned cnt) {
+            SymHeap sh(syn_.sh);
+            PtrHandle ptr(sh, syn_.rootObj);
+            junk_ = sh.objByAddr(ptr.value());
+            if (!sh.isValid(junk_))
+                return false;
+
+            ptr.setValue(VAL_NULL);
+            work_.assign(cnt, sh);
+            return true;
+        }
+
+        virtual void run(unsigned idx) {
+            collectJunk(work_[idx], junk_);
+        }
+
+    private:
+        TObjId                      junk_;
+};
+
+/// cut the heap by the root variable
+class BenchSplitHeap: public Benchmark {
+    public:
+        BenchSplitHeap(const Synth &syn): Benchmark(syn) { }
+        virtual const char* name() const { return "splitHeapByCVars"; }
+        virtual void run(unsigned idx) {
+            TCVarList cut;
+            cut.push_back(syn_.root);
+            SymHeap frame(syn_.sh.stor(),
+                    new Trace::TransientNode("symheap-bench"));
+            splitHeapByCVars(&work_[idx], cut, &frame);
+        }
+};
+
+/// run the benchmark in growing batches until minTime is spent in one batch
+static void measure(Benchmark &bench, const char *shape, const Params &par)
+{
+    unsigned cnt = 1U;
+    for (;;) {
+        if (!bench.setup(cnt)) {
+            printf("%-8s %-18s %12s\n", shape, bench.name(), "n/a");
+            return;
+        }
+
+        const unsigned long allocs0 = cntAllocs;
+        const unsigned long bytes0 = cntAllocBytes;
+        const double start = Timeline::wallClock();
+        for (unsigned idx = 0; idx < cnt; ++idx)
+            bench.run(idx);
+
+        const double elapsed = Timeline::wallClock() - start;
+        const unsigned long allocs = cntAllocs - allocs0;
+        const unsigned long bytes = cntAllocBytes - bytes0;
+        bench.teardown();
+
+        if (elapsed < par.minTime && cnt < (1U << 24)) {
+            cnt <<= 1;
+            continue;
+        }
+
+        printf("%-8s %-18s %12.1f %12.2f %12.1f %10u\n", shape, bench.name(),
+                1e9 * elapsed / cnt,
+                static_cast<double>(allocs) / cnt,
+                static_cast<double>(bytes) / cnt,
+                cnt);
+        return;
+    }
+}
+
+static void benchShape(
+        const BenchStor        &bs,
+        const EShape            shape,
+        const Params           &par,
+        const char             *filter)
+{
+    const char *name = shapeNames[shape];
+    const CVar root = CVar(/* first gl var */ bs.stor.vars.begin()->uid
+            + static_cast<int>(shape), /* gl var */ 0);
+
+    Synth syn(bs.stor, root);
+    generate(&syn, bs, shape, par);
+
+    Synth twin(bs.stor, root);
+    generate(&twin, bs, shape, par);
+
+    BenchHeapCopy           bHeapCopy(syn);
+    BenchObjClone           bObjClone(syn);
+    BenchValueOf            bValueOf(syn);
+    BenchRegionByVar        bRegionByVar(syn);
+    BenchSetValueOf         bSetValueOf(syn);
+    BenchGatherLiveFields   bGatherLiveFields(syn);
+    BenchAreEqual           bAreEqual(syn, twin);
+    BenchJoin               bJoin(syn, twin);
+    BenchAbstract           bAbstract(syn);
+    BenchConcretize         bConcretize(syn);
+    BenchCollectJunk        bCollectJunk(syn);
+    BenchSplitHeap          bSplitHeap(syn);
+
+    Benchmark *const benchList[] = {
+        &bHeapCopy,
+        &bObjClone,
+        &bValueOf,
+        &bRegionByVar,
+        &bSetValueOf,
+        &bGatherLiveFields,
+        &bAreEqual,
+        &bJoin,
+        &bAbstract,
+        &bConcretize,
+        &bCollectJunk,
+        &bSplitHeap
+    };
+
+    for (Benchmark *bench : benchList) {
+        if (filter && !strstr(bench->name(), filter) && !strstr(name, filter))
+            continue;
+
+        measure(*bench, name, par);
+    }
+}
+
+static void usage(const char *self)
+{
+    fprintf(stderr, "Usage: %s [-l LEN] [-i LEN] [-t SEC] [FILTER]\n"
+            "  -l LEN  length of lists and count of tree nodes "
+            "or array items (default 32)\n"
+            "  -i LEN  length of the nested lists (default 4)\n"
+            "  -t SEC  minimal time spent by each benchmark (default 0.2)\n"
+            "  FILTER  run only benchmarks whose operation or shape "
+            "contains FILTER\n", self);
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    Params par;
+    par.len = 32U;
+    par.lenInner = 4U;
+    par.minTime = 0.2;
+    const char *filter = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (!strcmp(arg, "-l") && i + 1 < argc)
+            par.len = atoi(argv[++i]);
+        else if (!strcmp(arg, "-i") && i + 1 < argc)
+            par.lenInner = atoi(argv[++i]);
+        else if (!strcmp(arg, "-t") && i + 1 < argc)
+            par.minTime = atof(argv[++i]);
+        else if ('-' == arg[0] || filter)
+            usage(argv[0]);
+        else
+            filter = arg;
+    }
+
+    if (!par.len)
+        usage(argv[0]);
+
+    cl_global_init_defaults("symheap-bench", /* debug_level */ 0);
+
+    const BenchStor bs(par.len);
+    printf("# list length %u, nested length %u, pointer size %d\n",
+            par.len, par.lenInner, ptrSize);
+    printf("%-8s %-18s %12s %12s %12s %10s\n",
+            "shape", "operation", "ns/op", "allocs/op", "bytes/op", "ops");
+
+    for (int shape = 0; shape < SH_TOTAL; ++shape)
+        benchShape(bs, static_cast<EShape>(shape), par, filter);
+
+    cl_global_cleanup();
+    return 0;
+}
@@ -0,0 +1,783 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file symheap-replay.cc
+ * standalone replayer of the heap operations recorded by the record_heap_ops
+ * option, it rebuilds the recorded type-info, variables, and input heaps, then
+ * re-executes and times each of the recorded calls (no compiler is involved)
+ */
+
+#include "config.h"
+
+#include <cl/code_listener.h>
+#include <cl/easy.hh>
+#include <cl/storage.hh>
+#include <cl/timeline.hh>
+
+#include "heaplog.hh"
+#include "symabstract.hh"
+#include "symcmp.hh"
+#include "symheap.hh"
+#include "symjoin.hh"
+#include "symtrace.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+using HeapLog::EHeapOp;
+
+// /////////////////////////////////////////////////////////////////////////////
+// libcl requires the analyzer to define clEasyRun(), it is never called here
+void clEasyRun(const CodeStorage::Storage &, const char *)
+{
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// decoding of records
+class LogReader {
+    public:
+        LogReader():
+            pos_(0U),
+            ok_(true)
+        {
+        }
+
+        bool load(const char *fileName);
+
+        bool ok() const { return ok_; }
+        bool atEnd() const { return !ok_ || data_.size() <= pos_; }
+        size_t pos() const { return pos_; }
+
+        unsigned long long getU();
+        long long getS();
+        const char* getStr();
+
+        HeapLog::EHeapLogTag getTag() {
+            return static_cast<HeapLog::EHeapLogTag>(this->getU());
+        }
+
+        IR::Range getRange() {
+            IR::Range rng;
+            rng.lo          = this->getS();
+            rng.hi          = this->getS();
+            rng.alignment   = this->getS();
+            return rng;
+        }
+
+        /// report malformed input and stop reading
+        void fail(const char *what);
+
+    private:
+        std::string                 data_;
+        size_t                      pos_;
+        bool                        ok_;
+
+        /// strings returned by getStr(), they need to live as long as types
+        std::deque<std::string>     strs_;
+};
+
+bool LogReader::load(const char *fileName)
+{
+    FILE *fp = fopen(fileName, "rb");
+    if (!fp) {
+        fprintf(stderr, "error: unable to open '%s'\n", fileName);
+        return false;
+    }
+
+    char buf[0x10000];
+    size_t len;
+    while (0U < (len = fread(buf, 1U, sizeof buf, fp)))
+        data_.append(buf, len);
+
+    fclose(fp);
+
+    static const char magic[] = HEAP_LOG_MAGIC;
+    if (data_.compare(0U, sizeof magic - 1U, magic)) {
+        fprintf(stderr, "error: '%s' is not a log of heap operations\n",
+                fileName);
+        return false;
+    }
+
+    pos_ = sizeof magic - 1U;
+    return true;
+}
+
+void LogReader::fail(const char *what)
+{
+    if (ok_)
+        fprintf(stderr, "error: malformed log at offset %zu: %s\n", pos_, what);
+
+    ok_ = false;
+}
+
+unsigned long long LogReader::getU()
+{
+    unsigned long long num = 0ULL;
+    for (int shift = 0; ok_; shift += 7) {
+        if (data_.size() <= pos_ || 63 < shift) {
+            this->fail("truncated integer");
+            break;
+        }
+
+        const unsigned char byte = data_[pos_++];
+        num |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+
+    return num;
+}
+
+long long LogReader::getS()
+{
+    const unsigned long long un = this->getU();
+    return static_cast<long long>((un >> 1) ^ (~(un & 1ULL) + 1ULL));
+}
+
+const char* LogReader::getStr()
+{
+    const unsigned long long len = this->getU();
+    if (data_.size() - pos_ < len) {
+        this->fail("truncated string");
+        return "";
+    }
+
+    strs_.push_back(data_.substr(pos_, len));
+    pos_ += len;
+    return strs_.back().c_str();
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// type-info and variables rebuilt from the log
+class ReplayStor {
+    public:
+        CodeStorage::Storage                stor;
+
+        /// return the type of the given uid, create a placeholder if needed
+        const struct cl_type* typeByUid(cl_uid_t uid);
+
+        void readType(LogReader &in);
+        void readVar(LogReader &in);
+
+        /// register the types read so far (once their items are complete)
+        void flushTypes();
+
+    private:
+        struct cl_type* slot(cl_uid_t uid);
+
+        std::map<cl_uid_t, struct cl_type *>        typeByUid_;
+        std::deque<struct cl_type>                  types_;
+        std::deque<std::vector<cl_type_item> >      items_;
+        std::vector<const struct cl_type *>         pending_;
+};
+
+struct cl_type* ReplayStor::slot(const cl_uid_t uid)
+{
+    struct cl_type *&clt = typeByUid_[uid];
+    if (clt)
+        return clt;
+
+    types_.push_back(cl_type());
+    clt = &types_.back();
+    memset(clt, 0, sizeof *clt);
+    clt->uid = uid;
+    clt->loc = cl_loc_unknown;
+    clt->scope = CL_SCOPE_GLOBAL;
+    return clt;
+}
+
+const struct cl_type* ReplayStor::typeByUid(const cl_uid_t uid)
+{
+    return (-1 == uid)
+        ? 0
+        : this->slot(uid);
+}
+
+void ReplayStor::readType(LogReader &in)
+{
+    struct cl_type *clt = this->slot(in.getS());
+    clt->code = static_cast<enum cl_type_e>(in.getU());
+    clt->size = in.getS();
+    clt->name = in.getStr();
+    if (!*clt->name)
+        clt->name = 0;
+
+    const unsigned flags = in.getU();
+    clt->is_unsigned = !!(flags & 1U);
+    clt->is_const = !!(flags & 2U);
+    clt->ptr_type = static_cast<enum cl_ptr_type_e>(in.getU());
+    clt->array_size = in.getS();
+
+    const unsigned cnt = in.getU();
+    items_.push_back(std::vector<cl_type_item>(cnt));
+    std::vector<cl_type_item> &items = items_.back();
+    for (unsigned i = 0; in.ok() && i < cnt; ++i) {
+        items[i].type = this->typeByUid(in.getS());
+        items[i].name = in.getStr();
+        items[i].offset = in.getS();
+    }
+
+    clt->item_cnt = cnt;
+    clt->items = (cnt) ? &items[0] : 0;
+    pending_.push_back(clt);
+}
+
+void ReplayStor::flushTypes()
+{
+    for (const struct cl_type *clt : pending_)
+        stor.types.insert(clt);
+
+    pending_.clear();
+}
+
+void ReplayStor::readVar(LogReader &in)
+{
+    const cl_uid_t uid = in.getS();
+    CodeStorage::Var &var = stor.vars[uid];
+    var.uid = uid;
+    var.code = static_cast<CodeStorage::EVar>(in.getU());
+    var.type = this->typeByUid(in.getS());
+    var.name = in.getStr();
+    var.denseIdx = in.getS();
+    var.fncIdx = in.getS();
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// input heaps rebuilt from the log
+class HeapBuilder {
+    public:
+        HeapBuilder(ReplayStor &rs, LogReader &in):
+            rs_(rs),
+            in_(in),
+            sh_(0)
+        {
+        }
+
+        ~HeapBuilder() {
+            this->clear();
+        }
+
+        /// start a new input heap
+        void begin();
+
+        /// apply a single mutation to the heap being built
+        void apply(HeapLog::EHeapLogTag tag);
+
+        /// input heaps of the next call
+        const std::vector<SymHeap *>& heaps() const {
+            return heaps_;
+        }
+
+        void clear();
+
+    private:
+        TObjId obj(long long id);
+        TValId val(long long id);
+        void defObj(long long id, TObjId obj);
+        void defVal(long long id, TValId val);
+        void readMeta(long long id);
+        void readCustom(long long id);
+
+        ReplayStor                         &rs_;
+        LogReader                          &in_;
+        SymHeap                            *sh_;
+        std::vector<SymHeap *>              heaps_;
+        std::map<long long, TObjId>         objMap_;
+        std::map<long long, TValId>         valMap_;
+};
+
+void HeapBuilder::clear()
+{
+    for (SymHeap *sh : heaps_)
+        delete sh;
+
+    heaps_.clear();
+    sh_ = 0;
+}
+
+void HeapBuilder::begin()
+{
+    sh_ = new SymHeap(rs_.stor, new Trace::TransientNode("symheap-replay"));
+    heaps_.push_back(sh_);
+    objMap_.clear();
+    valMap_.clear();
+}
+
+TObjId HeapBuilder::obj(const long long id)
+{
+    if (id <= OBJ_RETURN)
+        // special object IDs always match
+        return static_cast<TObjId>(id);
+
+    const std::map<long long, TObjId>::const_iterator it = objMap_.find(id);
+    if (objMap_.end() != it)
+        return it->second;
+
+    in_.fail("reference to an undefined object");
+    return OBJ_INVALID;
+}
+
+TValId HeapBuilder::val(const long long id)
+{
+    if (id <= 0)
+        // special value IDs always match
+        return static_cast<TValId>(id);
+
+    const std::map<long long, TValId>::const_iterator it = valMap_.find(id);
+    if (valMap_.end() != it)
+        return it->second;
+
+    in_.fail("reference to an undefined value");
+    return VAL_INVALID;
+}
+
+void HeapBuilder::defObj(const long long id, const TObjId obj)
+{
+    objMap_[id] = obj;
+}
+
+void HeapBuilder::defVal(const long long id, const TValId val)
+{
+    valMap_[id] = val;
+}
+
+void HeapBuilder::readMeta(const long long id)
+{
+    const TObjId obj = this->obj(id);
+    const TObjType clt = rs_.typeByUid(in_.getS());
+    const TProtoLevel level = in_.getS();
+    const EObjKind kind = static_cast<EObjKind>(in_.getU());
+
+    BindingOff off;
+    TMinLen len = 0;
+    if (OK_REGION != kind) {
+        off.head = in_.getS();
+        off.next = in_.getS();
+        off.prev = in_.getS();
+        len = in_.getS();
+        if (OK_OBJ_OR_NULL == kind)
+            off = BindingOff(OK_OBJ_OR_NULL);
+    }
+
+    if (!in_.ok() || OBJ_INVALID == obj)
+        return;
+
+    if (clt)
+        sh_->objSetEstimatedType(obj, clt);
+
+    if (OBJ_RETURN == obj)
+        return;
+
+    sh_->objSetProtoLevel(obj, level);
+    if (OK_REGION == kind)
+        return;
+
+    sh_->objSetAbstract(obj, kind, off);
+    sh_->segSetMinLength(obj, len);
+}
+
+void HeapBuilder::readCustom(const long long id)
+{
+    CustomValue cv;
+    switch (static_cast<ECustomValue>(in_.getU())) {
+        case CV_FNC:
+            cv = CustomValue(static_cast<cl_uid_t>(in_.getS()));
+            break;
+
+        case CV_INT_RANGE:
+            cv = CustomValue(in_.getRange());
+            break;
+
+        case CV_REAL: {
+            const unsigned long long bits = in_.getU();
+            double fpn;
+            memcpy(&fpn, &bits, sizeof fpn);
+            cv = CustomValue(fpn);
+            break;
+        }
+
+        case CV_STRING:
+            cv = CustomValue(in_.getStr());
+            break;
+
+        default:
+            in_.fail("invalid custom value");
+            return;
+    }
+
+    if (in_.ok())
+        this->defVal(id, sh_->valWrapCustom(cv));
+}
+
+void HeapBuilder::apply(const HeapLog::EHeapLogTag tag)
+{
+    if (!sh_) {
+        in_.fail("heap mutation outside of a heap");
+        return;
+    }
+
+    SymHeap &sh = *sh_;
+    const long long id = in_.getS();
+    switch (tag) {
+        case HeapLog::HL_OBJ_VAR: {
+            const cl_uid_t uid = in_.getS();
+            const int inst = in_.getS();
+            if (in_.ok())
+                this->defObj(id, sh.regionByVar(CVar(uid, inst), true));
+            break;
+        }
+
+        case HeapLog::HL_OBJ_STACK: {
+            const TSizeRange size = in_.getRange();
+            const cl_uid_t uid = in_.getS();
+            const int inst = in_.getS();
+            if (in_.ok())
+                this->defObj(id, sh.stackAlloc(size, CallInst(uid, inst)));
+            break;
+        }
+
+        case HeapLog::HL_OBJ_HEAP: {
+            const TSizeRange size = in_.getRange();
+            if (in_.ok())
+                this->defObj(id, sh.heapAlloc(size));
+            break;
+        }
+
+        case HeapLog::HL_OBJ_META:
+            this->readMeta(id);
+            break;
+
+        case HeapLog::HL_OBJ_INVALIDATE: {
+            const TObjId obj = this->obj(id);
+            if (in_.ok())
+                sh.objInvalidate(obj);
+            break;
+        }
+
+        case HeapLog::HL_VAL_ADDR: {
+            const TObjId obj = this->obj(in_.getS());
+            const ETargetSpecifier ts = static_cast<ETargetSpecifier>(
+                    in_.getU());
+            const TOffset off = in_.getS();
+            if (in_.ok())
+                this->defVal(id, sh.addrOfTarget(obj, ts, off));
+            break;
+        }
+
+        case HeapLog::HL_VAL_RANGE: {
+            const TObjId obj = this->obj(in_.getS());
+            const ETargetSpecifier ts = static_cast<ETargetSpecifier>(
+                    in_.getU());
+            const IR::Range rng = in_.getRange();
+            if (in_.ok()) {
+                const TValId root = sh.addrOfTarget(obj, ts);
+                this->defVal(id, sh.valByRange(root, rng));
+            }
+            break;
+        }
+
+        case HeapLog::HL_VAL_CUSTOM:
+            this->readCustom(id);
+            break;
+
+        case HeapLog::HL_VAL_UNKNOWN: {
+            const EValueTarget code = static_cast<EValueTarget>(in_.getU());
+            const EValueOrigin vo = static_cast<EValueOrigin>(in_.getU());
+            if (in_.ok())
+                this->defVal(id, sh.valCreate(code, vo));
+            break;
+        }
+
+        case HeapLog::HL_FIELD: {
+            const TObjId obj = this->obj(id);
+            const TOffset off = in_.getS();
+            const TObjType clt = rs_.typeByUid(in_.getS());
+            const TValId val = this->val(in_.getS());
+            if (in_.ok() && clt) {
+                const FldHandle fld(sh, obj, clt, off);
+                fld.setValue(val);
+            }
+            break;
+        }
+
+        case HeapLog::HL_UNI_BLOCK: {
+            UniformBlock bl;
+            bl.off = in_.getS();
+            bl.size = in_.getS();
+            bl.tplValue = this->val(in_.getS());
+            const TObjId obj = this->obj(id);
+            if (in_.ok())
+                sh.writeUniformBlock(obj, bl);
+            break;
+        }
+
+        case HeapLog::HL_NEQ: {
+            const TValId v1 = this->val(id);
+            const TValId v2 = this->val(in_.getS());
+            if (in_.ok())
+                sh.addNeq(v1, v2);
+            break;
+        }
+
+        default:
+            in_.fail("unknown record");
+    }
+}
+
+// /////////////////////////////////////////////////////////////////////////////
+// re-execution of the recorded calls
+struct OpStats {
+    unsigned long               cnt;
+    unsigned long               cntMismatches;
+    double                      timeRecorded;
+    double                      timeReplayed;
+
+    OpStats():
+        cnt(0UL),
+        cntMismatches(0UL),
+        timeRecorded(0.0),
+        timeReplayed(0.0)
+    {
+    }
+};
+
+/// execute the operation once on copies of the input heaps, return the result
+static int execOnce(
+        double                         *pTime,
+        const EHeapOp                   op,
+        const int                       flags,
+        const std::vector<SymHeap *>   &heaps)
+{
+    // the copies are made before the clock starts
+    SymHeap sh1(*heaps[0]);
+    SymHeap sh2((1 < heaps.size()) ? *heaps[1] : *heaps[0]);
+    SymHeap dst(sh1.stor(), new Trace::TransientNode("symheap-replay"));
+    EJoinStatus status;
+
+    int result = -1;
+    const double start = Timeline::wallClock();
+    switch (op) {
+        case HeapLog::HO_JOIN:
+            if (joinSymHeaps(&status, &dst, sh1, sh2, !!flags))
+                result = status;
+            break;
+
+        case HeapLog::HO_COMPARE:
+            result = areEqual(sh1, sh2);
+            break;
+
+        case HeapLog::HO_ABSTRACT:
+            abstractIfNeeded(sh1);
+            break;
+
+        case HeapLog::HO_TOTAL:
+            break;
+    }
+
+    *pTime = Timeline::wallClock() - start;
+    if (HeapLog::HO_ABSTRACT == op)
+        result = HeapLog::countObjects(sh1);
+
+    return result;
+}
+
+struct Params {
+    unsigned                    cntReps;    ///< repetitions of each call
+    bool                        verbose;    ///< print each call
+};
+
+static void replayCall(
+        OpStats                         stats[HeapLog::HO_TOTAL],
+        LogReader                      &in,
+        const HeapBuilder              &hb,
+        const Params                   &par,
+        const unsigned long             idx)
+{
+    const unsigned long long rawOp = in.getU();
+    const int flags = in.getS();
+    const int expected = in.getS();
+    const double timeRecorded = 1e-9 * in.getU();
+    if (!in.ok())
+        return;
+
+    if (HeapLog::HO_TOTAL <= rawOp) {
+        in.fail("unknown operation");
+        return;
+    }
+
+    const EHeapOp op = static_cast<EHeapOp>(rawOp);
+    const std::vector<SymHeap *> &heaps = hb.heaps();
+    if (heaps.size() != static_cast<unsigned>(HeapLog::opArity(op))) {
+        in.fail("count of input heaps does not match the operation");
+        return;
+    }
+
+    // take the minimal time of all repetitions
+    double timeReplayed = 0.0;
+    int result = -1;
+    for (unsigned rep = 0; rep < par.cntReps; ++rep) {
+        double time;
+        result = execOnce(&time, op, flags, heaps);
+        if (!rep || time < timeReplayed)
+            timeReplayed = time;
+    }
+
+    OpStats &st = stats[op];
+    ++st.cnt;
+    st.timeRecorded += timeRecorded;
+    st.timeReplayed += timeReplayed;
+    if (result != expected)
+        ++st.cntMismatches;
+
+    if (!par.verbose && result == expected)
+        return;
+
+    printf("#%-6lu %-18s %8u %8u %12.1f %12.1f %6d %6d%s\n", idx,
+            HeapLog::opName(op),
+            heaps[0]->lastId(),
+            (1 < heaps.size()) ? heaps[1]->lastId() : 0U,
+            1e6 * timeRecorded,
+            1e6 * timeReplayed,
+            expected, result,
+            (result == expected) ? "" : "  MISMATCH");
+}
+
+static bool replay(LogReader &in, const Params &par)
+{
+    ReplayStor rs;
+    HeapBuilder hb(rs, in);
+    OpStats stats[HeapLog::HO_TOTAL];
+    unsigned long cntCalls = 0UL;
+
+    printf("%-7s %-18s %8s %8s %12s %12s %6s %6s\n", "# call", "operation",
+            "ids1", "ids2", "rec [us]", "replay [us]", "rec", "replay");
+
+    while (!in.atEnd()) {
+        const HeapLog::EHeapLogTag tag = in.getTag();
+        switch (tag) {
+            case HeapLog::HL_TYPE:
+                rs.readType(in);
+                continue;
+
+            case HeapLog::HL_VAR:
+                rs.readVar(in);
+                continue;
+
+            default:
+                break;
+        }
+
+        // all types read so far are complete now
+        rs.flushTypes();
+
+        switch (tag) {
+            case HeapLog::HL_HEAP:
+                hb.begin();
+                break;
+
+            case HeapLog::HL_CALL:
+                replayCall(stats, in, hb, par, cntCalls++);
+                hb.clear();
+                break;
+
+            default:
+                hb.apply(tag);
+        }
+    }
+
+    if (!in.ok())
+        return false;
+
+    printf("\n%-18s %8s %14s %14s %8s %10s\n", "# operation", "calls",
+            "recorded [ms]", "replayed [ms]", "ratio", "mismatches");
+
+    for (int op = 0; op < HeapLog::HO_TOTAL; ++op) {
+        const OpStats &st = stats[op];
+        if (!st.cnt)
+            continue;
+
+        const double ratio = (0.0 < st.timeRecorded)
+            ? st.timeReplayed / st.timeRecorded
+            : 0.0;
+
+        printf("%-18s %8lu %14.3f %14.3f %8.2f %10lu\n",
+                HeapLog::opName(static_cast<EHeapOp>(op)), st.cnt,
+                1e3 * st.timeRecorded, 1e3 * st.timeReplayed, ratio,
+                st.cntMismatches);
+    }
+
+    for (const OpStats &st : stats)
+        if (st.cntMismatches)
+            return false;
+
+    return true;
+}
+
+static void usage(const char *self)
+{
+    fprintf(stderr, "Usage: %s [-r N] [-v] LOG\n"
+            "  -r N    execute each call N times, take the minimal time "
+            "(default 1)\n"
+            "  -v      print each call (otherwise only the mismatches)\n"
+            "  LOG     log written by Predator with record_heap_ops\n"
+            "The exit code is 1 for a malformed log, or 2 if any result "
+            "does not match.\n", self);
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    Params par;
+    par.cntReps = 1U;
+    par.verbose = false;
+    const char *fileName = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (!strcmp(arg, "-r") && i + 1 < argc)
+            par.cntReps = atoi(argv[++i]);
+        else if (!strcmp(arg, "-v"))
+            par.verbose = true;
+        else if ('-' == arg[0] || fileName)
+            usage(argv[0]);
+        else
+            fileName = arg;
+    }
+
+    if (!fileName || !par.cntReps)
+        usage(argv[0]);
+
+    LogReader in;
+    if (!in.load(fileName))
+        return 1;
+
+    cl_global_init_defaults("symheap-replay", /* debug_level */ 0);
+    const bool ok = replay(in, par);
+    cl_global_cleanup();
+
+    if (!in.ok())
+        return 1;
+
+    return (ok) ? 0 : 2;
+}
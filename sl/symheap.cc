@@ -115,102 +115,129 @@ class CoincidenceDb: public SymPairMap</* v1, v2 */ TValId, TValId /* sum */> {
 
 // /////////////////////////////////////////////////////////////////////////////
 // CVar lookup container
+/// program variables by (call instance, dense index as assigned by CodeStorage)
 class CVarMap {
     public:
         RefCounter refCnt;
 
     private:
-        typedef std::map<CVar, TObjId>              TCont;
-        TCont                                       cont_;
+        typedef std::vector<TObjId>                 TObjByIdx;
+
+        /// variables on stack of a single call instance of a function
+        struct Frame {
+            int                                     fncIdx;
+            int                                     inst;
+            unsigned                                cntLive;
+            TObjByIdx                               objs;
+        };
+
+        typedef std::vector<Frame>                  TFrameList;
+
+        TObjByIdx                                   gl_;
+        TFrameList                                  frames_;
+
+        /// return pointer to the slot of the given var, 0 if there is none
+        TObjId* slot(const CVar &cv, const CodeStorage::Var &var, bool create);
 
     public:
-        void insert(CVar cVar, TObjId val) {
+        void insert(CVar cVar, const CodeStorage::Var &var, TObjId obj) {
+            TObjId *pObj = this->slot(cVar, var, /* create */ true);
+
             // check for mapping redefinition
-            CL_BREAK_IF(hasKey(cont_, cVar));
+            CL_BREAK_IF(OBJ_INVALID != *pObj);
 
             // define mapping
-            cont_[cVar] = val;
+            *pObj = obj;
         }
 
-        void remove(CVar cVar) {
-            if (1 != cont_.erase(cVar))
-                CL_BREAK_IF("offset detected in CVarMap::remove()");
-        }
+        void remove(CVar cVar, const CodeStorage::Var &var);
 
-        TObjId find(const CVar &cVar) {
-            // regular lookup
-            TCont::iterator iter = cont_.find(cVar);
-            const bool found = (cont_.end() != iter);
-            if (!cVar.inst) {
-                // gl variable explicitly requested
-                return (found)
-                    ? iter->second
-                    : OBJ_INVALID;
-            }
+        TObjId find(const CVar &cVar, const CodeStorage::Var &var) {
+            // gl variables are looked up regardless of cVar.inst
+            const TObjId *pObj = this->slot(cVar, var, /* create */ false);
+            return (pObj)
+                ? *pObj
+                : OBJ_INVALID;
+        }
+};
 
-            // automatic fallback to gl variable
-            CVar gl = cVar;
-            gl.inst = /* global variable */ 0;
-            TCont::iterator iterGl = cont_.find(gl);
-            const bool foundGl = (cont_.end() != iterGl);
+TObjId* CVarMap::slot(
+        const CVar                 &cv,
+        const CodeStorage::Var     &var,
+        const bool                  create)
+{
+    const int idx = var.denseIdx;
+    CL_BREAK_IF(idx < 0);
 
-            if (!found && !foundGl)
-                // not found anywhere
-                return OBJ_INVALID;
+    TObjByIdx *pObjs = &gl_;
+    if (isOnStack(var)) {
+        // look for the frame, starting with the most recently created one
+        TFrameList::reverse_iterator it = frames_.rbegin();
+        for (; frames_.rend() != it; ++it)
+            if (it->inst == cv.inst && it->fncIdx == var.fncIdx)
+                break;
 
-            // check for clash on uid among lc/gl variable
-            CL_BREAK_IF(found && foundGl);
+        if (frames_.rend() == it) {
+            if (!create)
+                return 0;
 
-            if (found)
-                return iter->second;
-            else /* if (foundGl) */
-                return iterGl->second;
+            Frame frm;
+            frm.fncIdx  = var.fncIdx;
+            frm.inst    = cv.inst;
+            frm.cntLive = 0;
+            frames_.push_back(frm);
+            it = frames_.rbegin();
         }
-};
 
+        if (create)
+            ++it->cntLive;
 
-// /////////////////////////////////////////////////////////////////////////////
-// implementation of CustomValue
-CustomValue::CustomValue():
-    code_(CV_INVALID)
-{
-    std::memset(&data_, 0, sizeof data_);
+        pObjs = &it->objs;
+    }
+
+    TObjByIdx &objs = *pObjs;
+    if (objs.size() <= static_cast<unsigned>(idx)) {
+        if (!create)
+            return 0;
+
+        objs.resize(idx + 1, OBJ_INVALID);
+    }
+
+    return &objs[idx];
 }
 
-CustomValue::~CustomValue()
+void CVarMap::remove(CVar cv, const CodeStorage::Var &var)
 {
-    if (CV_STRING != code_)
+    TObjId *pObj = this->slot(cv, var, /* create */ false);
+    if (!pObj || OBJ_INVALID == *pObj) {
+        CL_BREAK_IF("offset detected in CVarMap::remove()");
         return;
+    }
 
-    CL_BREAK_IF(!data_.str);
-    delete data_.str;
-}
+    *pObj = OBJ_INVALID;
+    if (!isOnStack(var))
+        return;
 
-CustomValue::CustomValue(const CustomValue &ref):
-    code_(ref.code_),
-    data_(ref.data_)
-{
-    if (CV_STRING == code_)
-        data_.str = new std::string(*ref.data_.str);
-}
+    // drop the frame once it contains no variables
+    for (TFrameList::iterator it = frames_.begin(); frames_.end() != it; ++it) {
+        if (it->inst != cv.inst || it->fncIdx != var.fncIdx)
+            continue;
 
-CustomValue& CustomValue::operator=(const CustomValue &ref)
-{
-    if (&ref == this)
-        return *this;
+        CL_BREAK_IF(!it->cntLive);
+        if (!--it->cntLive)
+            frames_.erase(it);
 
-    if (CV_STRING == code_) {
-        CL_BREAK_IF(!data_.str);
-        delete data_.str;
+        return;
     }
+}
 
-    code_ = ref.code_;
-    data_ = ref.data_;
-
-    if (CV_STRING == code_)
-        data_.str = new std::string(*ref.data_.str);
 
-    return *this;
+// /////////////////////////////////////////////////////////////////////////////
+// implementation of CustomValue
+CustomValue::CustomValue():
+    code_(CV_INVALID)
+{
+    std::memset(&data_, 0, sizeof data_);
 }
 
 cl_uid_t CustomValue::uid() const
@@ -231,11 +258,16 @@ double CustomValue::fpn() const
     return data_.fpn;
 }
 
-const std::string& CustomValue::str() const
+std::string CustomValue::str() const
 {
     CL_BREAK_IF(CV_STRING != code_);
-    CL_BREAK_IF(!data_.str);
-    return *data_.str;
+    return StrPool::str(data_.strId);
+}
+
+StrPool::TStrId CustomValue::strId() const
+{
+    CL_BREAK_IF(CV_STRING != code_);
+    return data_.strId;
 }
 
 /// eliminates the warning 'comparing floating point with == or != is unsafe'
@@ -263,8 +295,8 @@ bool operator==(const CustomValue &a, const CustomValue &b)
             return areEqual(a.data_.fpn, b.data_.fpn);
 
         case CV_STRING:
-            CL_BREAK_IF(!a.data_.str || !b.data_.str);
-            return !a.data_.str->compare(*b.data_.str);
+            // interned strings are equal iff their IDs are equal
+            return (a.data_.strId == b.data_.strId);
 
         case CV_INT_RANGE:
             return (a.data_.rng == b.data_.rng);
@@ -342,7 +374,7 @@ inline EBlockKind bkFromClt(const TObjType clt)
         : BK_FIELD;
 }
 
-class AbstractHeapEntity {
+class AbstractHeapEntity: public MemAccounted<MC_SYM_HEAPS> {
     public:
         // NVI to catch missing/incorrect overrides of doClone()
         AbstractHeapEntity* clone() const;
@@ -564,7 +596,7 @@ class CustomValueMapper {
         typedef std::map<cl_uid_t, TValId>                      TCustomByUid;
         typedef std::map<IR::TInt, TValId>                      TCustomByNum;
         typedef std::map<double, TValId>                        TCustomByReal;
-        typedef std::map<std::string, TValId>                   TCustomByString;
+        typedef std::map<StrPool::TStrId, TValId>               TCustomByString;
 
         TCustomByUid        fncMap;
         TCustomByNum        numMap;
@@ -595,7 +627,7 @@ class CustomValueMapper {
                     return assignInvalidIfNotFound(fpnMap, item.fpn());
 
                 case CV_STRING:
-                    return assignInvalidIfNotFound(strMap, item.str());
+                    return assignInvalidIfNotFound(strMap, item.strId());
             }
         }
 };
@@ -616,7 +648,7 @@ class IMatchPolicy {
         virtual TFldId bestMatch() const = 0;
 };
 
-struct SymHeapCore::Private {
+struct SymHeapCore::Private: public MemAccounted<MC_SYM_HEAPS> {
     Private(Trace::Node *);
     Private(const Private &);
     ~Private();
@@ -1074,12 +1106,13 @@ bool SymHeapCore::Private::writeCharToString(
     // extract the string that is going to be modified
     const InternalCustomValue *stringData =
         DCAST<const InternalCustomValue *>(dstData);
-    std::string str(stringData->customData.str());
-    CL_BREAK_IF(static_cast<TOffset>(str.size()) < pos || pos < 0);
+    StrPool::TStrId strId = stringData->customData.strId();
+    CL_BREAK_IF(static_cast<TOffset>(StrPool::length(strId)) < pos || pos < 0);
 
-    // modify the string accordingly as long as the result is still a string
+    // modify the string accordingly as long as the result is still a string,
+    // the prefix in front of pos is shared with the original string
     if (VAL_NULL == valToWrite)
-        str.resize(pos);
+        strId = StrPool::truncate(strId, pos);
     else {
         const BaseValue *valData;
         this->ents.getEntRO(&valData, valToWrite);
@@ -1094,13 +1127,13 @@ bool SymHeapCore::Private::writeCharToString(
             return false;
 
         const IR::TInt num = rng.lo;
-        str[pos] = num;
+        strId = StrPool::writeChar(strId, pos, num);
     }
 
     // update the mapping of the string being assigned
     CL_DEBUG("CV_STRING replaced as a consequence of data reinterpretation");
     RefCntLib<RCO_NON_VIRT>::requireExclusivity(this->cValueMap);
-    const CustomValue cvStr(str.c_str());
+    const CustomValue cvStr = CustomValue::fromStrId(strId);
     TValId &valStr = this->cValueMap->lookup(cvStr);
 
     if (VAL_INVALID == valStr) {
@@ -2166,8 +2199,7 @@ bool SymHeapCore::Private::findZeroInBlock(
         *provenPrefix = (off <= offSrc);
 
         // the length of the string is equal to the offset of its trailing zero
-        const std::string &str = valData->customData.str();
-        *offDst = off + str.size();
+        *offDst = off + StrPool::length(valData->customData.strId());
         return true;
     }
 
@@ -3297,7 +3329,8 @@ CVar SymHeapCore::cVarByObject(TObjId obj) const
 
 TObjId SymHeapCore::regionByVar(CVar cv, bool createIfNeeded)
 {
-    TObjId obj = d->cVarMap->find(cv);
+    const CodeStorage::Var &var = stor_.vars[cv.uid];
+    TObjId obj = d->cVarMap->find(cv, var);
     if (OBJ_INVALID != obj)
         return obj;
 
@@ -3306,7 +3339,6 @@ TObjId SymHeapCore::regionByVar(CVar cv, bool createIfNeeded)
         return OBJ_INVALID;
 
     // lazy creation of a program variable
-    const CodeStorage::Var &var = stor_.vars[cv.uid];
     if (!isOnStack(var))
         cv.inst = /* gl var */ 0;
 
@@ -3338,7 +3370,7 @@ TObjId SymHeapCore::regionByVar(CVar cv, bool createIfNeeded)
 
     // store the address for next wheel
     RefCntLib<RCO_NON_VIRT>::requireExclusivity(d->cVarMap);
-    d->cVarMap->insert(cv, obj);
+    d->cVarMap->insert(cv, var, obj);
     return obj;
 }
 
@@ -3520,7 +3552,8 @@ TSizeRange SymHeapCore::valSizeOfString(TValId addr) const
             return /* error */ IR::rngFromNum(IR::Int0);
 
         // string literal
-        const unsigned len = cv.str().size() + /* trailing zero */ 1;
+        const unsigned len = StrPool::length(cv.strId())
+            + /* trailing zero */ 1;
         return IR::rngFromNum(len);
     }
 
@@ -3585,7 +3618,7 @@ void SymHeapCore::objInvalidate(TObjId obj)
     if (cv.uid != /* heap object */ -1) {
         // remove the corresponding program variable
         RefCntLib<RCO_NON_VIRT>::requireExclusivity(d->cVarMap);
-        d->cVarMap->remove(cv);
+        d->cVarMap->remove(cv, stor_.vars[cv.uid]);
     }
 
     // release the root
@@ -3711,7 +3744,7 @@ bool SymHeapCore::chkNeq(TValId v1, TValId v2) const
 
 // /////////////////////////////////////////////////////////////////////////////
 // implementation of SymHeap
-struct AbstractObject {
+struct AbstractObject: public MemAccounted<MC_SYM_HEAPS> {
     RefCounter                      refCnt;
 
     EObjKind                        kind;
@@ -3730,7 +3763,7 @@ struct AbstractObject {
     }
 };
 
-struct SymHeap::Private {
+struct SymHeap::Private: public MemAccounted<MC_SYM_HEAPS> {
     RefCounter                      refCnt;
     EntStore<AbstractObject>        absRoots;
 };
@@ -29,10 +29,12 @@
 #include "config.h"
 
 #include "intrange.hh"
+#include "strpool.hh"
 #include "symid.hh"
 #include "util.hh"
 
 #include <cl/code_listener.h>
+#include <cl/memdebug.hh>
 
 #include <map>              // for TValMap
 #include <set>              // for TCVarSet
@@ -109,7 +111,7 @@ enum ECustomValue {
 union CustomValueData {
     cl_uid_t        uid;    ///< unique ID as assigned by Code Listener
     double          fpn;    ///< floating-point number
-    std::string    *str;    ///< string literal
+    StrPool::TStrId strId;  ///< string literal (interned)
     IR::Range       rng;    ///< closed interval over integral domain
 };
 
@@ -117,9 +119,6 @@ union CustomValueData {
 class CustomValue {
     public:
         CustomValue();
-        ~CustomValue();
-        CustomValue(const CustomValue &);
-        CustomValue& operator=(const CustomValue &);
 
         explicit CustomValue(cl_uid_t uid):
             code_(CV_FNC)
@@ -142,7 +141,15 @@ class CustomValue {
         explicit CustomValue(const char *str):
             code_(CV_STRING)
         {
-            data_.str = new std::string(str);
+            data_.strId = StrPool::intern(str);
+        }
+
+        /// string literal already interned in StrPool
+        static CustomValue fromStrId(StrPool::TStrId strId) {
+            CustomValue cv;
+            cv.code_ = CV_STRING;
+            cv.data_.strId = strId;
+            return cv;
         }
 
         /// custom value classification
@@ -165,7 +172,10 @@ class CustomValue {
         double fpn() const;
 
         /// string literal (only for CV_STRING)
-        const std::string &str() const;
+        std::string str() const;
+
+        /// ID of the interned string literal (only for CV_STRING)
+        StrPool::TStrId strId() const;
 
     private:
         friend bool operator==(const CustomValue &, const CustomValue &);
@@ -352,7 +362,7 @@ class FldList;
 class SymHeap;
 
 /// SymHeapCore - the elementary representation of the state of program memory
-class SymHeapCore {
+class SymHeapCore: public MemAccounted<MC_SYM_HEAPS> {
     public:
         /// create an empty symbolic heap
         SymHeapCore(TStorRef, Trace::Node *);
@@ -23,8 +23,11 @@
 #include <cl/cl_msg.hh>
 #include <cl/cldebug.hh>
 #include <cl/clutil.hh>
+#include <cl/metrics.hh>
+#include <cl/timeline.hh>
 
 #include "glconf.hh"
+#include "heaplog.hh"
 #include "prototype.hh"
 #include "shape.hh"
 #include "symcmp.hh"
@@ -2549,20 +2552,39 @@ void initTrace(SymJoinCtx &ctx)
     ctx.dst.traceUpdate(tr);
 }
 
-bool joinSymHeaps(
+static Metrics::Counter cntJoinUseAny   ("join.JS_USE_ANY");
+static Metrics::Counter cntJoinUseSh1   ("join.JS_USE_SH1");
+static Metrics::Counter cntJoinUseSh2   ("join.JS_USE_SH2");
+static Metrics::Counter cntJoinThreeWay ("join.JS_THREE_WAY");
+static Metrics::Counter cntJoinFailed   ("join.failed");
+
+static void countJoinStatus(const EJoinStatus status)
+{
+    switch (status) {
+        case JS_USE_ANY:    cntJoinUseAny.inc();    break;
+        case JS_USE_SH1:    cntJoinUseSh1.inc();    break;
+        case JS_USE_SH2:    cntJoinUseSh2.inc();    break;
+        case JS_THREE_WAY:  cntJoinThreeWay.inc();  break;
+    }
+}
+
+static bool joinSymHeapsCore(
         EJoinStatus             *pStatus,
         SymHeap                 *pDst,
-        SymHeap                  sh1,
-        SymHeap                  sh2,
+        SymHeap                 &sh1,
+        SymHeap                 &sh2,
         const bool               allowThreeWay)
 {
+    const Timeline::Scope timelineScope("joinSymHeaps");
     SJ_DEBUG("--> joinSymHeaps()");
     TStorRef stor = sh1.stor();
     CL_BREAK_IF(&stor != &sh2.stor());
 
-    if (!areEqual(sh1.exitPoint(), sh2.exitPoint()))
+    if (!areEqual(sh1.exitPoint(), sh2.exitPoint())) {
+        cntJoinFailed.inc();
         return false;
-    
+    }
+
     // update trace
     Trace::waiveCloneOperation(sh1);
     Trace::waiveCloneOperation(sh2);
@@ -2608,6 +2630,7 @@ bool joinSymHeaps(
 
     // all OK
     *pStatus = ctx.status;
+    countJoinStatus(ctx.status);
     SJ_DEBUG("<-- joinSymHeaps() says " << ctx.status);
     CL_BREAK_IF(!segCheckConsistency(ctx.dst));
     CL_BREAK_IF(!protoCheckConsistency(ctx.dst));
@@ -2616,9 +2639,25 @@ bool joinSymHeaps(
 fail:
     // if the join failed on heaps that were isomorphic, something went wrong
     CL_BREAK_IF(areEqual(sh1, sh2));
+    cntJoinFailed.inc();
     return false;
 }
 
+bool joinSymHeaps(
+        EJoinStatus             *pStatus,
+        SymHeap                 *pDst,
+        SymHeap                  sh1,
+        SymHeap                  sh2,
+        const bool               allowThreeWay)
+{
+    HeapLog::CallRecorder rec(HeapLog::HO_JOIN, sh1, &sh2, allowThreeWay);
+    if (!joinSymHeapsCore(pStatus, pDst, sh1, sh2, allowThreeWay))
+        return false;
+
+    rec.setResult(*pStatus);
+    return true;
+}
+
 // FIXME: this works only for nullified blocks anyway
 void killUniBlocksUnderBindingPtrs(
         SymHeap                &sh,
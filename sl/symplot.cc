@@ -30,7 +30,6 @@
 #include "symseg.hh"
 #include "util.hh"
 #include "worklist.hh"
-#include "extract_pta.hh"
 
 #include <cctype>
 #include <fstream>
@@ -1330,8 +1329,6 @@ bool plotHeapCore(
     out << "}\n";
     const bool ok = !!out;
     out.close();
-
-    extractPTA(sh, name, loc);
     return ok;
 }
 
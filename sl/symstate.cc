@@ -21,6 +21,7 @@
 #include "symstate.hh"
 
 #include <cl/cl_msg.hh>
+#include <cl/metrics.hh>
 #include <cl/storage.hh>
 
 #include "glconf.hh"
@@ -43,7 +44,9 @@
 // set to 'true' if you wonder why SymState matches states as it does (noisy)
 static bool debugSymState = static_cast<bool>(DEBUG_SYMSTATE);
 
-static int cntLookups = -1;
+static Metrics::Counter cntLookups("symstate.lookups");
+static Metrics::Counter cntBlockVisits("scheduler.block_visits");
+static Metrics::Gauge cntBlocksWaiting("scheduler.blocks_waiting");
 
 namespace {
     void debugPlot(const char *name, int idx, const SymHeap &sh) {
@@ -55,7 +58,7 @@ namespace {
 
         std::ostringstream str;
         str << "symstate-"
-            << FIXW(6) << ::cntLookups << "-" << name << "-"
+            << FIXW(6) << ::cntLookups.value() << "-" << name << "-"
             << FIXW(4) << idx;
 
         plotHeap(sh, str.str().c_str());
@@ -173,7 +176,7 @@ int SymHeapUnion::lookup(const SymHeap &lookFor) const
         // empty state --> not found
         return -1;
 
-    ++::cntLookups;
+    ::cntLookups.inc();
     debugPlot("lookup", 0, lookFor);
 
     for(int idx = 0; idx < cnt; ++idx) {
@@ -294,7 +297,7 @@ bool SymStateWithJoin::insert(const SymHeap &shNew, bool allowThreeWay)
             new Trace::TransientNode("SymStateWithJoin::insert()"));
     int             idx;
 
-    ++::cntLookups;
+    ::cntLookups.inc();
     for(idx = 0; idx < cnt; ++idx) {
         const SymHeap &shOld = this->operator[](idx);
         if (!joinSymHeaps(&status, &result, shOld, shNew, allowThreeWay))
@@ -509,9 +512,20 @@ bool BlockScheduler::getNext(TBlock *dst)
 
     *dst = bb;
     d->done[bb]++;
+    ::cntBlockVisits.inc();
+    ::cntBlocksWaiting.set(d->todo.size());
     return true;
 }
 
+void BlockScheduler::clear()
+{
+    d->todo.clear();
+#if SE_BLOCK_SCHEDULER_KIND < 3
+    d->sched = Private::TSched();
+#endif
+    ::cntBlocksWaiting.set(0);
+}
+
 void BlockScheduler::printStats() const
 {
     typedef std::map<unsigned /* cnt */, TBlockList> TRMap;
@@ -581,7 +595,11 @@ struct SymStateMap::Private {
         }
     };
 
-    std::map<TBlock, BlockState>        cont;
+    typedef std::pair<const TBlock, BlockState>                 TItem;
+    typedef MemAccountingAllocator<TItem, MC_STATES>            TAlloc;
+    typedef std::map<TBlock, BlockState, std::less<TBlock>, TAlloc> TCont;
+
+    TCont                               cont;
 };
 
 SymStateMap::SymStateMap():
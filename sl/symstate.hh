@@ -37,7 +37,8 @@ namespace CodeStorage {
 
 class SymState {
     private:
-        typedef std::vector<SymHeap *> TList;
+        typedef MemAccountingAllocator<SymHeap *, MC_STATES>   TAlloc;
+        typedef std::vector<SymHeap *, TAlloc>                  TList;
 
     public:
         typedef TList::const_iterator           const_iterator;
@@ -322,6 +323,9 @@ class BlockScheduler: public IStatsProvider {
 
         bool getNext(TBlock *dst);
 
+        /// drop all blocks waiting in the queue
+        void clear();
+
         virtual void printStats() const;
 
     private:
@@ -94,7 +94,7 @@ class NodeBase {
 };
 
 /// an abstract node of the symbolic execution trace graph
-class Node: public NodeBase {
+class Node: public NodeBase, public MemAccounted<MC_TRACE> {
     private:
         /// birth notification from a child node
         void notifyBirth(NodeBase *child);
@@ -0,0 +1,53 @@
+#!/bin/bash
+export SELF="$0"
+
+export LC_ALL=C
+
+die() {
+    printf "%s: %s\n" "$SELF" "$*" >&2
+    exit 1
+}
+
+usage() {
+    printf "Usage: %s path/to/probe.sh [test-0001.c [...]]\n" "$SELF" >&2
+    printf "Counts type comparisons of Predator over the given test-cases \
+(the whole regression suite if none given).\n" >&2
+    exit 1
+}
+
+export PROBE="$1"
+test -x "$PROBE" || usage
+shift
+
+topdir="`dirname "$(readlink -f "$SELF")"`/.."
+if test -z "$1"; then
+    set -- "$topdir"/tests/predator-regre/test-*.c
+fi
+
+# run Predator with the statistics of type comparisons enabled
+PFLAGS="error_label:ERROR,type_cmp_stats" "$PROBE" "$@" >&2
+
+TOTAL=0
+BY_UID=0
+BY_CANON_ID=0
+BY_WALK=0
+for i in "$@"; do
+    LINE="$(grep -E ': note: \[TypeDb\] [0-9]+ type comparisons' \
+        "$i-predator.err" | tail -1)"
+    test -n "$LINE" || continue
+
+    PATTERN='^.*\[TypeDb\] ([0-9]+) type comparisons, ([0-9]+) decided by UID'
+    PATTERN="$PATTERN"', ([0-9]+) by canonical ID, ([0-9]+) by walking.*$'
+    read CNT CNT_UID CNT_CANON CNT_WALK <<< \
+        "$(printf "%s\n" "$LINE" | sed -E "s|$PATTERN|\\1 \\2 \\3 \\4|")"
+
+    TOTAL=$(expr $TOTAL + $CNT)
+    BY_UID=$(expr $BY_UID + $CNT_UID)
+    BY_CANON_ID=$(expr $BY_CANON_ID + $CNT_CANON)
+    BY_WALK=$(expr $BY_WALK + $CNT_WALK)
+done
+
+printf "type comparisons:\t%12d\n" "$TOTAL"
+printf "decided by UID:\t\t%12d\n" "$BY_UID"
+printf "by canonical ID:\t%12d\n" "$BY_CANON_ID"
+printf "by walking types:\t%12d\n" "$BY_WALK"
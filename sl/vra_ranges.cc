@@ -0,0 +1,182 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+#include "vra_ranges.hh"
+
+#include <cl/cl_msg.hh>
+#include <cl/clutil.hh>
+#include <cl/storage.hh>
+
+#include "util.hh"
+
+#ifdef SL_USE_VRA
+
+#include <GlobAnalysis.h>
+#include <LoopFinder.h>
+#include <ValueAnalysis.h>
+
+static bool vraReady;
+
+/// uids of variables whose ranges computed by vra cannot be relied on
+static CodeStorage::TVarSet vraUntrusted;
+
+static bool isUntrusted(const struct cl_operand &op)
+{
+    return CL_OPERAND_VAR == op.code
+        && hasKey(vraUntrusted, varIdFromOperand(&op));
+}
+
+static bool isComparison(const CodeStorage::Insn &insn)
+{
+    if (CL_INSN_BINOP != insn.code)
+        return false;
+
+    switch (insn.subCode) {
+        case CL_BINOP_EQ:
+        case CL_BINOP_NE:
+        case CL_BINOP_LT:
+        case CL_BINOP_GT:
+        case CL_BINOP_LE:
+        case CL_BINOP_GE:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/// return true if the operands of insn make a so far trusted variable untrusted
+static bool taintByInsn(const CodeStorage::Insn &insn)
+{
+    const CodeStorage::TOperandList &opList = insn.operands;
+    if (CL_INSN_UNOP != insn.code && CL_INSN_BINOP != insn.code)
+        // the result of a call is not known to vra at all
+        return false;
+
+    bool taint = false;
+    for (unsigned i = /* src */ 1; i < opList.size(); ++i)
+        if (isUntrusted(opList[i]))
+            taint = true;
+
+    // vra trims the ranges of both operands of a comparison by the other one
+    const bool cmp = isComparison(insn);
+    if (cmp && isUntrusted(opList[/* dst */ 0]))
+        taint = true;
+
+    if (!taint)
+        return false;
+
+    bool changed = false;
+    for (unsigned i = 0; i < opList.size(); ++i) {
+        const struct cl_operand &op = opList[i];
+        if (CL_OPERAND_VAR != op.code || (i && !cmp))
+            continue;
+
+        const cl_uid_t uid = varIdFromOperand(&op);
+        changed |= vraUntrusted.insert(uid).second;
+    }
+
+    return changed;
+}
+
+/// vra sees only direct assignments, so it cannot track variables whose
+/// address is taken (or modified globals across calls), nor anything that is
+/// computed from them
+static void collectUntrusted(const CodeStorage::Storage &stor)
+{
+    for (const CodeStorage::Var &var : stor.vars)
+        if (var.mayBePointed || (CodeStorage::VAR_GL == var.code
+                    && GlobAnalysis::isModified(var.uid)))
+            vraUntrusted.insert(var.uid);
+
+    bool changed;
+    do {
+        changed = false;
+        for (const CodeStorage::Fnc *pFnc : stor.fncs) {
+            if (!isDefined(*pFnc))
+                continue;
+
+            for (const CodeStorage::Block *bb : pFnc->cfg)
+                for (const CodeStorage::Insn *insn : *bb)
+                    changed |= taintByInsn(*insn);
+        }
+    }
+    while (changed);
+
+    CL_DEBUG("vraComputeRanges() does not trust ranges of "
+            << vraUntrusted.size() << " variables");
+}
+
+void vraComputeRanges(const CodeStorage::Storage &stor)
+{
+    CL_DEBUG("vraComputeRanges() is computing value ranges...");
+    LoopFinder::computeLoopAnalysis(stor);
+    GlobAnalysis::computeGlobAnalysis(stor);
+
+    for (const CodeStorage::Fnc *pFnc : stor.fncs)
+        if (isDefined(*pFnc))
+            ValueAnalysis::computeAnalysisForFnc(*pFnc);
+
+    collectUntrusted(stor);
+    vraReady = true;
+}
+
+bool vraDecideCond(
+        bool                       *pResult,
+        const CodeStorage::Block   *bb,
+        const CodeStorage::Insn    &insnCnd)
+{
+    if (!vraReady)
+        return false;
+
+    CL_BREAK_IF(CL_INSN_COND != insnCnd.code);
+    const struct cl_operand &src = insnCnd.operands[/* src */ 0];
+    if (isUntrusted(src))
+        // the variable may be modified behind the back of vra
+        return false;
+
+    const Range *range = ValueAnalysis::getRangeAtBlockEnd(bb, src);
+    if (!range || range->empty())
+        // nothing known about the condition (or the block is unreachable)
+        return false;
+
+    const bool canBeTrue = range->containsTrue();
+    const bool canBeFalse = range->containsFalse();
+    if (canBeTrue == canBeFalse)
+        return false;
+
+    *pResult = canBeTrue;
+    return true;
+}
+
+#else // !SL_USE_VRA
+
+void vraComputeRanges(const CodeStorage::Storage &)
+{
+    CL_BREAK_IF("vraComputeRanges() requires SL_USE_VRA");
+}
+
+bool vraDecideCond(
+        bool                       * /* pResult */,
+        const CodeStorage::Block   * /* bb */,
+        const CodeStorage::Insn    & /* insnCnd */)
+{
+    return false;
+}
+
+#endif // SL_USE_VRA
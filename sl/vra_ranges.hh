@@ -0,0 +1,48 @@
+/*
+ * This file is part of predator.
+ *
+ * predator is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * predator is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with predator.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef H_GUARD_VRA_RANGES_H
+#define H_GUARD_VRA_RANGES_H
+
+/**
+ * @file vra_ranges.hh
+ * optional pre-pass computing value ranges of variables by vra, which are then
+ * used to prune paths that the symbolic execution cannot decide on its own
+ */
+
+namespace CodeStorage {
+    struct Block;
+    struct Insn;
+    struct Storage;
+}
+
+/// run value-range analysis over all defined functions of the given storage
+void vraComputeRanges(const CodeStorage::Storage &stor);
+
+/**
+ * check whether vra has proven the condition of a CL_INSN_COND constant
+ * @param pResult the value of the condition is stored there if proven
+ * @param bb the block that the CL_INSN_COND instruction terminates
+ * @param insnCnd the CL_INSN_COND instruction
+ * @return true if the value of the condition has been proven
+ */
+bool vraDecideCond(
+        bool                       *pResult,
+        const CodeStorage::Block   *bb,
+        const CodeStorage::Insn    &insnCnd);
+
+#endif /* H_GUARD_VRA_RANGES_H */
@@ -0,0 +1,39 @@
+#include <stdlib.h>
+
+struct item {
+    int data;
+};
+
+static void level1(struct item *p)
+{
+    p->data = 0;
+}
+
+static void level2(struct item *p)
+{
+    level1(p);
+}
+
+static void pong(struct item *p, int n);
+
+static void ping(struct item *p, int n)
+{
+    p->data = n;
+    if (n)
+        pong(p, n - 1);
+}
+
+static void pong(struct item *p, int n)
+{
+    ping(p, n);
+}
+
+int main(void)
+{
+    struct item it;
+    level1(&it);
+    level2(NULL);
+    ping(&it, 1);
+    pong(NULL, 1);
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <verifier-builtins.h>
+#include <stdlib.h>
+
+// bound to the models of built-ins by test-0616.models
+extern void* my_alloc(size_t);
+extern unsigned my_nondet_uint(void);
+extern void my_error(void);
+
+int main()
+{
+    void *ptr = my_alloc(sizeof(int));
+    if (!ptr)
+        return 0;
+
+    // the model of __VERIFIER_nondet_uint() returns a non-negative value
+    long long val = my_nondet_uint();
+    if (val < 0)
+        free(ptr);
+
+    free(ptr);
+
+    // the model of __VERIFIER_error() takes no argument
+    my_error();
+    return 0;
+}
+
+/**
+ * @file test-0616.c
+ *
+ * @brief models of built-ins loaded by the builtin_models option
+ *
+ * - the handlers are given the name of the model, not the name
+ *   of the alias
+ * - run with test-0616.models only (see sl/CMakeLists.txt)
+ *
+ * @attention
+ * This description is automatically imported from tests/predator-regre/README.
+ * Any changes made to this comment will be thrown away on the next import.
+ */
@@ -94,6 +94,26 @@ void GlobAnalysis::setIfModified(const Insn *insn)
 	}
 }
 
+/**
+* @brief If the address of a global variable is taken in @a insn, this function
+*        sets that the variable is modified, because it can be written through
+*        a pointer.
+*/
+void GlobAnalysis::setIfAddressTaken(const Insn *insn)
+{
+	for (const struct cl_operand &op : insn->operands) {
+		if (op.code != CL_OPERAND_VAR)
+			continue;
+
+		int uid = op.data.var->uid;
+		for (const struct cl_accessor *ac = op.accessor; ac; ac = ac->next) {
+			if (CL_ACCESSOR_REF == ac->code && isGlobal(uid)) {
+				GlobAnalysis::globVarInit[uid] = true;
+			}
+		}
+	}
+}
+
 /**
 * @brief Computes the glob analysis for the given instruction @a insn.
 */
@@ -101,6 +121,8 @@ void GlobAnalysis::computeGlobAnalysisForInsn(const Insn *insn)
 {
 	const enum cl_insn_e code = insn->code;
 
+	GlobAnalysis::setIfAddressTaken(insn);
+
 	switch (code) {
 		case CL_INSN_UNOP:
 		case CL_INSN_BINOP:
@@ -177,6 +199,13 @@ void GlobAnalysis::computeGlobAnalysis(const CodeStorage::Storage &stor)
 		GlobAnalysis::computeGlobAnalysisForFnc(fnc);
 	}
 
+	// Initializers of variables can take the addresses of global variables, too.
+	for (const Var &var : stor.vars) {
+		for (const Insn *insn : var.initials) {
+			GlobAnalysis::setIfAddressTaken(insn);
+		}
+	}
+
 	// Initializes the map storing ranges for global variables.
 	GlobAnalysis::initGlobVarMap(stor);
 }
@@ -449,6 +478,18 @@ void GlobAnalysis::processInitial(const Insn *insn)
 {
 	const enum cl_insn_e code = insn->code;
 
+	// Only numbers initialized by constants are tracked, e.g. no pointers.
+	const TOperandList &opList = insn->operands;
+	for (TOperandList::size_type i = 0; i < opList.size(); ++i) {
+		const struct cl_operand &op = opList[i];
+		if (!Utility::isSupportedOperand(op))
+			return;
+
+		if ((0 == i) ? !OperandToMemoryPlace::convert(&op)
+				: (op.code != CL_OPERAND_CST))
+			return;
+	}
+
 	switch (code) {
 		case CL_INSN_UNOP:
 			GlobAnalysis::processInitialForUnop(insn);
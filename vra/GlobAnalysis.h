@@ -64,6 +64,7 @@ class GlobAnalysis {
 		static void computeGlobAnalysisForBlock(const CodeStorage::Block *block);
 		static void computeGlobAnalysisForInsn(const CodeStorage::Insn *insn);
 		static void setIfModified(const CodeStorage::Insn *isns);
+		static void setIfAddressTaken(const CodeStorage::Insn *insn);
 		static void processInitial(const CodeStorage::Insn *insn);
 		static void processInitialForUnop(const CodeStorage::Insn *insn);
 		static void processInitialForBinop(const CodeStorage::Insn *insn);
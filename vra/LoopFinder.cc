@@ -12,6 +12,7 @@
 #include <stack>
 #include <set>
 #include <cassert>
+#include <boost/foreach.hpp>
 
 #include "LoopFinder.h"
 #include "Utility.h"
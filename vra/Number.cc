@@ -289,7 +289,7 @@ bool Number::isPositiveInf() const
 */
 bool Number::isNotNumber() const
 {
-	return isFloatingPoint() && isnan(floatValue);
+	return isFloatingPoint() && std::isnan(floatValue);
 }
 
 /**
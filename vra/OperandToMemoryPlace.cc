@@ -108,13 +108,41 @@ MemoryPlace* OperandToMemoryPlace::convertSimpleOperand(const cl_operand *operan
 
 }
 
+/**
+* @brief Returns @c true if @a operand accesses a variable, an item of a
+*        structure or an element of an array directly, @c false if it takes
+*        the address of a variable, accesses the memory through a pointer or
+*        accesses an item of a union, which shares the memory with the others.
+*/
+bool OperandToMemoryPlace::isTracked(const cl_operand *operand)
+{
+	for (const struct cl_accessor *ac = operand->accessor; ac; ac = ac->next) {
+		switch (ac->code) {
+			case CL_ACCESSOR_ITEM:
+				if (CL_TYPE_UNION == ac->type->code)
+					return false;
+				break;
+
+			case CL_ACCESSOR_DEREF_ARRAY:
+				break;
+
+			default:
+				// CL_ACCESSOR_REF, CL_ACCESSOR_DEREF, CL_ACCESSOR_OFFSET
+				return false;
+		}
+	}
+
+	return true;
+}
+
 /**
 * @brief Converts @c cl_operand to the instance of the @c MemoryPlace class.
 *
 * @param[in] operand It will be converted to the @c MemoryPlace object.
 * @param[in] indexes It specifies which items of the structure should be converted.
 *
-* @return @c MemoryPlace instance that was created from @a operand.
+* @return @c MemoryPlace instance that was created from @a operand, or @c NULL
+*         if @a operand is not tracked by the analysis (see @c isTracked()).
 *
 * Preconditions:
 * - @code operand->code == CL_OPERAND_VAR @endcode
@@ -122,6 +150,11 @@ MemoryPlace* OperandToMemoryPlace::convertSimpleOperand(const cl_operand *operan
 MemoryPlace* OperandToMemoryPlace::convert(const cl_operand *operand,
 										   deque<int> indexes)
 {
+	if (!OperandToMemoryPlace::isTracked(operand)) {
+		// The memory accessed through a pointer is not tracked.
+		return NULL;
+	}
+
 	if (indexes.empty()) {
 		// Simple variable.
 		return OperandToMemoryPlace::convertSimpleOperand(operand);
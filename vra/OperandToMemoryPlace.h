@@ -37,6 +37,8 @@ class OperandToMemoryPlace {
 
 		static MemoryPlace* convertSimpleOperand(const cl_operand *operand);
 
+		static bool isTracked(const cl_operand *operand);
+
 	public:
 		static MemoryPlace* convert(const cl_operand *operand,
 									std::deque<int> indexes = std::deque<int>());
@@ -1354,6 +1354,69 @@ Range Range::expand() const {
 	return result;
 }
 
+/**
+* @brief Widens the current range with respect to the previous range @a prev
+*        by using the given @a thresholds.
+*
+* For integral ranges:
+*  - Every lower bound of an interval that is not contained in @a prev is
+*    decreased to the nearest lower threshold (or to the minimum of the type).
+*  - Every upper bound of an interval that is not contained in @a prev is
+*    increased to the nearest higher threshold (or to the maximum of the type).
+*  - Thresholds that are not representable in the type of the range are
+*    ignored.
+*
+* For floating-point ranges:
+*  - Returns the maximal range.
+*/
+Range Range::widen(const Range &prev, const Thresholds &thresholds) const {
+	// I should always work with non-empty ranges.
+	assert(!empty());
+
+	// For floating-points, return the maximal range.
+	if (isFloatingPoint()) {
+		return getMaxRange(data[0].first);
+	}
+
+	Range result;
+	for (Range::const_iterator it = data.begin(); it != data.end(); it++) {
+		Number newMin = it->first;
+		Number newMax = it->second;
+		const bool isMinStable = !intersect(prev, Range(newMin)).empty();
+		const bool isMaxStable = !intersect(prev, Range(newMax)).empty();
+		if (!isMinStable) {
+			newMin = newMin.getMin();
+		}
+		if (!isMaxStable) {
+			newMax = newMax.getMax();
+		}
+
+		// Finds the nearest representable thresholds.
+		for (Thresholds::const_iterator t = thresholds.begin();
+				t != thresholds.end(); t++) {
+			if (!t->isIntegral())
+				continue;
+
+			Number n = it->first.assign(*t);
+			if (n.getInt() != t->getInt())
+				continue;
+
+			if (!isMinStable && n <= it->first && n > newMin)
+				newMin = n;
+			if (!isMaxStable && n >= it->second && n < newMax)
+				newMax = n;
+		}
+
+		result.data.push_back(Interval(newMin, newMax));
+	}
+
+	// We have to normalize the result before returning (there will be
+	// intervals that can be merged).
+	result.normalize();
+
+	return result;
+}
+
 /**
 * @brief Merges the intervals in the range.
 *
@@ -1703,13 +1766,16 @@ Range Range::performIntegralDivOp(const Range &r1, const Range &r2, bool exact)
 			const Number &z = jt->first;
 			const Number &w = jt->second;
 
+			// The quotient is monotonic in both operands on this box, so its
+			// extremes are in the corners. Since the values between the
+			// corners are reached as well, a single interval is needed.
 			Number xw = exact ? exact_div(x, w) : trunc_div(x, w);
 			Number xz = exact ? exact_div(x, z) : trunc_div(x, z);
-			result.data.push_back(Interval(std::min(xw, xz), std::max(xw, xz)));
-
 			Number yw = exact ? exact_div(y, w) : trunc_div(y, w);
 			Number yz = exact ? exact_div(y, z) : trunc_div(y, z);
-			result.data.push_back(Interval(std::min(yw, yz), std::max(yw, yz)));
+			result.data.push_back(Interval(
+				std::min(std::min(xw, xz), std::min(yw, yz)),
+				std::max(std::max(xw, xz), std::max(yw, yz))));
 		}
 	}
 
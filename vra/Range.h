@@ -43,6 +43,9 @@ class Range {
 		/// Definition of the type for expressing size.
 		typedef size_t size_type;
 
+		/// Definition of the type for thresholds used by widen().
+		typedef std::vector<Number> Thresholds;
+
 		/// Returns the iterator to the first interval.
 		iterator begin()             { return data.begin(); }
 
@@ -88,6 +91,7 @@ class Range {
 
 		Range assign(const Range &r) const;
 		Range expand() const;
+		Range widen(const Range &prev, const Thresholds &thresholds) const;
 		Range mergeIntervals() const;
 
 		bool containsNan() const;
@@ -154,3 +154,50 @@ Range Utility::getMaxRange(const cl_operand &operand, deque<int> indexes)
 	}
 }
 
+/**
+* @brief Returns @c true if @a type is a number, or a structure or an array
+*        consisting only of numbers, @c false otherwise.
+*/
+bool Utility::isSupportedType(const struct cl_type *type)
+{
+	switch (type->code) {
+		case CL_TYPE_INT:
+		case CL_TYPE_BOOL:
+		case CL_TYPE_REAL:
+		case CL_TYPE_ENUM:
+			return true;
+
+		case CL_TYPE_STRUCT:
+		case CL_TYPE_ARRAY:
+			for (int i = 0; i != type->item_cnt; ++i) {
+				if (!Utility::isSupportedType(type->items[i].type))
+					return false;
+			}
+			return (type->item_cnt != 0);
+
+		default:
+			// CL_TYPE_VOID, CL_TYPE_UNKNOWN, CL_TYPE_PTR, CL_TYPE_UNION,
+			// CL_TYPE_FNC, CL_TYPE_CHAR, CL_TYPE_STRING
+			return false;
+	}
+}
+
+/**
+* @brief Returns @c true if the value of @a operand can be represented by
+*        ranges, @c false otherwise (e.g. for pointers or addresses).
+*/
+bool Utility::isSupportedOperand(const cl_operand &operand)
+{
+	switch (operand.code) {
+		case CL_OPERAND_VAR:
+			return Utility::isSupportedType(operand.type);
+
+		case CL_OPERAND_CST:
+			return Utility::isSupportedType(operand.type)
+				&& (CL_TYPE_INT == operand.data.cst.code
+					|| CL_TYPE_REAL == operand.data.cst.code);
+
+		default:
+			return false;
+	}
+}
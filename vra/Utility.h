@@ -25,6 +25,8 @@ class Utility {
 		static Number convertOperandToNumber(const cl_operand *operand);
 		static Range getMaxRange(const cl_operand &operand,
 								 std::deque<int> indexes = std::deque<int>());
+		static bool isSupportedType(const struct cl_type *type);
+		static bool isSupportedOperand(const cl_operand &operand);
 };
 
 #endif
@@ -36,13 +36,19 @@ using std::pair;
 
 ValueAnalysis::BlockToTrimmedRangesMap ValueAnalysis::blockToTrimmedRangesMap;
 ValueAnalysis::BlockToResultMap ValueAnalysis::blockToInputRangesMap;
-ValueAnalysis::BlockToResultMap ValueAnalysis::blockToOutputRangesMap;
+ValueAnalysis::BlockToResultMap ValueAnalysis::blockToDefinedRangesMap;
+ValueAnalysis::BlockToChangeLogMap ValueAnalysis::blockToChangeLogMap;
+ValueAnalysis::EdgeToLogPositionMap ValueAnalysis::edgeToLogPositionMap;
 ValueAnalysis::SchedulerQueue ValueAnalysis::todoQueue;
 ValueAnalysis::SchedulerSet ValueAnalysis::todoSet;
 ValueAnalysis::BlockToCounterMap ValueAnalysis::blockToCounterMap;
 LoopFinder::BlockToUpperLimit ValueAnalysis::tripCountOfBlockMap;
 
-const unsigned ValueAnalysis::NumberOfPassesBeforeExpand = 1000;
+Range::Thresholds ValueAnalysis::thresholds;
+
+const unsigned ValueAnalysis::NumberOfPassesBeforeWiden = 3;
+const unsigned ValueAnalysis::NumberOfWideningsBeforeTop = 10;
+const unsigned ValueAnalysis::NumberOfNarrowingPasses = 2;
 
 namespace {
 
@@ -77,7 +83,7 @@ void ValueAnalysis::scheduleBlock(const Block *block) {
 *        Otherwise, maximal possible range is returned.
 */
 Range ValueAnalysis::getRange(const struct cl_operand &src,
-							  MemoryPlaceToRangeMap &output,
+							  RangeOverlay &output,
 							  deque<int> indexes)
 {
 	Range srcRange;
@@ -89,8 +95,11 @@ Range ValueAnalysis::getRange(const struct cl_operand &src,
 	} else if (src.code == CL_OPERAND_VAR) {
 		// Right operand of the unary operation is a variable.
 		MemoryPlace *srcVar = OperandToMemoryPlace::convert(&src, indexes);
-		if (output.find(srcVar) != output.end()) {
-			srcRange = output[srcVar];
+		if (srcVar == NULL) {
+			// The memory accessed through a pointer is not tracked.
+			srcRange = Utility::getMaxRange(src, indexes);
+		} else if (const Range *known = output.find(srcVar)) {
+			srcRange = *known;
 		} else {
 			// If we do not know what is in the variable, we set the maximal
 			// possible range. This is used also for the assignment of structure
@@ -115,7 +124,7 @@ Range ValueAnalysis::getRange(const struct cl_operand &src,
 */
 void ValueAnalysis::assignSimpleElement(const struct cl_operand &dst,
 										const struct cl_operand &src,
-										MemoryPlaceToRangeMap &output,
+										RangeOverlay &output,
 										deque<int> indDst,
 										deque<int> indSrc)
 {
@@ -164,6 +173,70 @@ void ValueAnalysis::generateIndexes(const struct cl_type *type,
 	ind.pop_back();
 }
 
+/**
+* @brief Sets the maximal possible ranges to all the memory places represented
+*        by the destination operand @a dst. It is used when the analysis is not
+*        able to compute the result of the instruction writing into @a dst.
+*/
+void ValueAnalysis::invalidate(const struct cl_operand &dst,
+							   RangeOverlay &output)
+{
+	if ((dst.code != CL_OPERAND_VAR) || !OperandToMemoryPlace::convert(&dst)) {
+		// Nothing is tracked for the destination.
+		return;
+	}
+
+	const struct cl_type *type = getType(dst);
+	if ((CL_TYPE_STRUCT != dst.type->code) && (CL_TYPE_ARRAY != dst.type->code)) {
+		if (Utility::isSupportedType(dst.type))
+			output[OperandToMemoryPlace::convert(&dst)] = Utility::getMaxRange(dst);
+		return;
+	}
+
+	if (0 == type->item_cnt)
+		return;
+
+	// Invalidates all items of the structure that hold numbers.
+	deque<int> ind;
+	vector<deque<int> > indVec;
+	generateIndexes(type, ind, indVec);
+	for (const deque<int> &indexes : indVec) {
+		const struct cl_type *item = type;
+		for (int index : indexes)
+			item = item->items[index].type;
+
+		if (Utility::isSupportedType(item)) {
+			output[OperandToMemoryPlace::convert(&dst, indexes)] =
+				Utility::getMaxRange(dst, indexes);
+		}
+	}
+}
+
+/**
+* @brief Returns @c true if the analysis is able to compute the result of
+*        @a insn, i.e. the values of all its operands can be represented by
+*        ranges and neither its destination nor a structure it reads is
+*        accessed through a pointer.
+*/
+bool ValueAnalysis::isSupportedInsn(const Insn *insn)
+{
+	const TOperandList &opList = insn->operands;
+	const struct cl_operand &dst = opList[0];
+	if ((CL_OPERAND_VAR != dst.code) || !OperandToMemoryPlace::convert(&dst))
+		return false;
+
+	for (const struct cl_operand &op : opList) {
+		if (!Utility::isSupportedOperand(op))
+			return false;
+
+		if ((CL_OPERAND_VAR == op.code) && (CL_TYPE_STRUCT == op.type->code)
+				&& !OperandToMemoryPlace::convert(&op))
+			return false;
+	}
+
+	return true;
+}
+
 /**
 * @brief Gets the type of the operand @a op.
 */
@@ -188,7 +261,7 @@ const struct cl_type *ValueAnalysis::getType(const struct cl_operand &op)
 */
 void ValueAnalysis::assign(const struct cl_operand &dst,
 						   const struct cl_operand &src,
-						   MemoryPlaceToRangeMap &output)
+						   RangeOverlay &output)
 {
 	// Checks if left operand is valid.
 	assert(dst.code == CL_OPERAND_VAR);
@@ -219,23 +292,6 @@ void ValueAnalysis::assign(const struct cl_operand &dst,
 	}
 }
 
-/**
-* @brief If the given @a block is found as a key in the given @a inputMap
-*        then it returns the ranges associated with this key in @a inputMap.
-*        Otherwise, it returns an empty map.
-*/
-ValueAnalysis::MemoryPlaceToRangeMap ValueAnalysis::getRanges(const Block* block,
-													const BlockToResultMap &inputMap)
-{
-	BlockToResultMap::const_iterator it = inputMap.find(block);
-	if (it != inputMap.end()) {
-		return it->second;
-	} else {
-		MemoryPlaceToRangeMap emptyMap;
-		return emptyMap;
-	}
-}
-
 /**
 * @brief If the given @a block is found as a key in @c blockToTrimmedRangesMap
 *        then it returns the output ranges that get off the given @a block.
@@ -252,135 +308,117 @@ ValueAnalysis::TrimmedRangesMap ValueAnalysis::getTrimmedRanges(const Block* blo
 }
 
 /**
-* @brief Computes the partial input ranges for the given block @a current from
-*        the given output ranges of its predecessor stored in @a outs and from
-*        the given trimmed ranges of its predecessor stored in @a trimmed.
+* @brief Returns the output range of @a mp in the given @a block, which is the
+*        range defined by the block or the input range of the block. If none
+*        of them is known, it returns NULL.
 */
-ValueAnalysis::MemoryPlaceToRangeMap ValueAnalysis::computePartialInputRanges(
-	const CodeStorage::Block *current, const MemoryPlaceToRangeMap &outs,
-	const TrimmedRangesMap &trimmed)
+const Range *ValueAnalysis::getOutputRange(const Block *block,
+										   const MemoryPlace *mp)
 {
-	MemoryPlaceToRangeMap result;
-
-	for (const TrimmedRangesMap::value_type &trim : trimmed) {
-		// Firstly, we choose all trimmed ranges that are valid for the given block
-		// and store them as result.
-		const struct TrimmedKey key = trim.first;
-		const Range &range = trim.second;
-		if (key.block == current) {
-			// If the trimmed range was computed for the current block, we set
-			// the variable for which the trimmed range was computed and store
-			// this trimmed range into the result map.
-			MemoryPlaceToRangeMap::const_iterator it = outs.find(key.varMp);
-			if (it != outs.end() && !(intersect(range, it->second)).empty()) {
-				result[key.varMp] = range;
-			}
-		}
+	BlockToResultMap::const_iterator bt = blockToDefinedRangesMap.find(block);
+	if (bt != blockToDefinedRangesMap.end()) {
+		MemoryPlaceToRangeMap::const_iterator it = bt->second.find(mp);
+		if (it != bt->second.end())
+			return &it->second;
 	}
 
-	for (const MemoryPlaceToRangeMap::value_type &out : outs) {
-		// Secondly, we choose the output ranges for variables that do not have
-		// trimmed ranges set.
-		const MemoryPlace *mp = out.first;
-		const Range &range = out.second;
-		if (result.find(mp) == result.end()) {
-			// If there was no trimming for this memory place, we just add it.
-			result[mp] = range;
-		}
+	bt = blockToInputRangesMap.find(block);
+	if (bt != blockToInputRangesMap.end()) {
+		MemoryPlaceToRangeMap::const_iterator it = bt->second.find(mp);
+		if (it != bt->second.end())
+			return &it->second;
 	}
 
-	return result;
+	return NULL;
 }
 
 /**
-* @brief Computes the input ranges of the @a current block from the output ranges and
-*        trimmed ranges of predecessors' ranges. Trimmed ranges represents the ranges
-*        that are trimmed according to some condition in the block.
+* @brief Computes the range of @a mp that flows along the edge from @a pred to
+*        @a succ into @a result. It is the output range of @a pred, or the range
+*        trimmed according to the condition at the end of @a pred if it is
+*        valid for @a succ and it is not disjoint with the output range.
+*
+* @return @c false if the output range of @a mp in @a pred is not known.
 */
-void ValueAnalysis::computeInputRanges(const CodeStorage::Block *current)
+bool ValueAnalysis::getEdgeRange(const Block *pred, const Block *succ,
+								 const MemoryPlace *mp, Range &result)
 {
-	// Gets the predecessor of the current block.
-	const TTargetList &preds = current->inbound();
+	const Range *out = getOutputRange(pred, mp);
+	if (!out)
+		return false;
 
-	// Stores the input ranges of the current block, output ranges or trimmed ranges
-	// of its predecessors.
-	MemoryPlaceToRangeMapVector outputOfPreds;
-	outputOfPreds.push_back(ValueAnalysis::getRanges(current, blockToInputRangesMap));
+	result = *out;
 
-	for (const TTargetList::value_type &pred : preds) {
-		// Get the output ranges of the predecessor.
-		MemoryPlaceToRangeMap out = ValueAnalysis::getRanges(pred,
-										blockToOutputRangesMap);
-
-		if (blockToTrimmedRangesMap.find(pred) == blockToTrimmedRangesMap.end()) {
-			// If there are no trimmed ranges, we store the output ranges of
-			// predecessor.
-			outputOfPreds.push_back(out);
-		} else {
-			// If there are trimmed ranges, we have to compute the result from
-			// predecessor's output and trimmed ranges.
-			TrimmedRangesMap trimmed = ValueAnalysis::getTrimmedRanges(pred);
-			MemoryPlaceToRangeMap result
-					= ValueAnalysis::computePartialInputRanges(current, out, trimmed);
-			outputOfPreds.push_back(result);
+	BlockToTrimmedRangesMap::const_iterator bt
+		= blockToTrimmedRangesMap.find(pred);
+	if (bt == blockToTrimmedRangesMap.end())
+		return true;
+
+	for (const TrimmedRangesMap::value_type &trim : bt->second) {
+		const struct TrimmedKey &key = trim.first;
+		if (key.block == succ && key.varMp == mp
+				&& !(intersect(trim.second, *out)).empty()) {
+			result = trim.second;
 		}
 	}
 
-	// Joins the results of predecessors. It represents the input ranges into
-	// the currently processed block.
-	MemoryPlaceToRangeMap inputToBlock;
-	inputToBlock = ValueAnalysis::join(outputOfPreds);
-
-	// Assigns the input ranges to the currently processed block.
-	blockToInputRangesMap[current] = inputToBlock;
+	return true;
 }
 
 /**
-* @brief Gets the ranges that are changing between @a oldResult and @a newResult
-*        and expands these for faster convergence. Then, these new ranges are
-*        stored for the output of the given @a block.
+* @brief Computes the input ranges of the @a current block from the output ranges and
+*        trimmed ranges of predecessors' ranges. Trimmed ranges represents the ranges
+*        that are trimmed according to some condition in the block.
+*
+* Only the memory places whose ranges have changed in a predecessor since the
+* last computation are joined into the input ranges (the input ranges only
+* grow, so the rest of them would not change anything).
+*
+* @param[in] current Block to compute the input ranges for.
+* @param[out] prevInputs Previous input ranges of the memory places whose
+*                        input ranges have changed.
+* @param[out] addedInputs Memory places that had no input range before.
 */
-void ValueAnalysis::expandChangingRanges(const Block* block,
-										 const MemoryPlaceToRangeMap &oldResult,
-										 const MemoryPlaceToRangeMap &newResult)
+void ValueAnalysis::computeInputRanges(const CodeStorage::Block *current,
+									   MemoryPlaceToRangeMap &prevInputs,
+									   MemoryPlaceSet &addedInputs)
 {
+	MemoryPlaceToRangeMap &input = blockToInputRangesMap[current];
 
-	MemoryPlaceToRangeMap result;
-	for (MemoryPlaceToRangeMap::const_iterator it = oldResult.begin();
-		 it != oldResult.end(); ++it) {
-
-		const MemoryPlace *key = it->first;
-
-		// Key must exists in both maps.
-		assert(newResult.find(key) != newResult.end());
+	// Gets the predecessor of the current block.
+	const TTargetList &preds = current->inbound();
 
-		Range oldRange = it->second;
-		MemoryPlaceToRangeMap::const_iterator jt = newResult.find(key);
-		Range newRange = jt->second;
+	for (const TTargetList::value_type &pred : preds) {
+		// Gets the memory places changed in the predecessor since the last time.
+		const ChangeLog &log = blockToChangeLogMap[pred];
+		size_t &pos = edgeToLogPositionMap[Edge(pred, current)];
+		const MemoryPlaceSet changed(log.begin() + pos, log.end());
+		pos = log.size();
+
+		for (const MemoryPlace *mp : changed) {
+			Range edgeRange;
+			if (!ValueAnalysis::getEdgeRange(pred, current, mp, edgeRange))
+				continue;
+
+			MemoryPlaceToRangeMap::iterator it = input.find(mp);
+			if (it == input.end()) {
+				input[mp] = unite(Range(), edgeRange);
+				addedInputs.insert(mp);
+				continue;
+			}
 
-		if (oldRange == newRange) {
-			// Ranges do not change.
-			result[key] = newRange;
-		} else {
-			// Ranges change after the last processing of the block.
-			result[key] = newRange.expand();
-		}
-	}
+			const Range united = unite(it->second, edgeRange);
+			if (united == it->second)
+				continue;
 
-	// Firstly, I assumed that the size of oldResult and newResult must be same.
-	// However, this is not true. So, we have to add everything what is in
-	// newResult to result.
-	for (MemoryPlaceToRangeMap::const_iterator it = newResult.begin();
-		 it != newResult.end(); ++it) {
+			if (addedInputs.find(mp) == addedInputs.end()
+					&& prevInputs.find(mp) == prevInputs.end()) {
+				prevInputs[mp] = it->second;
+			}
 
-		const MemoryPlace *key = it->first;
-		if (result.find(key) == result.end()) {
-			// If key is not in the result, we have to add it.
-			result[key] = it->second;
+			it->second = united;
 		}
 	}
-
-	blockToOutputRangesMap[block] = result;
 }
 
 /**
@@ -405,6 +443,9 @@ void ValueAnalysis::computeAnalysisForFnc(const Fnc &fnc)
 	// Sets the ranges for global variables for the input of the entry block.
 	blockToInputRangesMap[entryBlock] = GlobAnalysis::getGlobVarMap();
 
+	// Gets the thresholds for the widening of changing ranges.
+	collectThresholds(fnc);
+
 	todoQueue.push(entryBlock);
 	todoSet.insert(entryBlock);
 
@@ -413,9 +454,6 @@ void ValueAnalysis::computeAnalysisForFnc(const Fnc &fnc)
 		todoQueue.pop();
 		todoSet.erase(block);
 
-		MemoryPlaceToRangeMap oldResult = ValueAnalysis::getRanges(block,
-			blockToOutputRangesMap);
-
 		unsigned long tripCount = LoopFinder::getUpperLimit(block);
 		if ((tripCount != 0) &&
 			(tripCount == ValueAnalysis::tripCountOfBlockMap[block]) ) {
@@ -424,21 +462,10 @@ void ValueAnalysis::computeAnalysisForFnc(const Fnc &fnc)
 			continue;
 		}
 
-		ValueAnalysis::computeAnalysisForBlock(block);
+		const bool changed = ValueAnalysis::computeAnalysisForBlock(block);
 		++ValueAnalysis::tripCountOfBlockMap[block];
-		MemoryPlaceToRangeMap newResult = ValueAnalysis::getRanges(block,
-			blockToOutputRangesMap);
-
-		if (newResult != oldResult) {
-			// If this block was analysed many times and still does
-			// not converge, we will help it a little.
-			if (blockToCounterMap[block] > ValueAnalysis::NumberOfPassesBeforeExpand) {
-				expandChangingRanges(block, oldResult, newResult);
-			}
-		}
 
-		newResult = ValueAnalysis::getRanges(block, blockToOutputRangesMap);
-		if ((newResult != oldResult) || (ValueAnalysis::containOnlyGotoInsn(block))) {
+		if (changed || (ValueAnalysis::containOnlyGotoInsn(block))) {
 			// Gets the successors of the processed block.
 			const TTargetList &succs = block->targets();
 			for (const TTargetList::value_type &succ : succs) {
@@ -446,30 +473,297 @@ void ValueAnalysis::computeAnalysisForFnc(const Fnc &fnc)
 			}
 		}
 	}
+
+	// Makes the widened ranges more precise.
+	narrowRangesForFnc(fnc);
+}
+
+/**
+* @brief Returns the range of the variable @a op at the end of the given
+*        @a block, or NULL if it is not known (e.g. the block has never been
+*        reached by the analysis).
+*
+* It can be used by other analyses once computeAnalysisForFnc() has been
+* called for the function containing the @a block.
+*/
+const Range *ValueAnalysis::getRangeAtBlockEnd(const Block *block,
+											   const struct cl_operand &op)
+{
+	if ((op.code != CL_OPERAND_VAR) || op.accessor)
+		return NULL;
+
+	const MemoryPlace *mp = OperandToMemoryPlace::convert(&op);
+	return ValueAnalysis::getOutputRange(block, mp);
 }
 
 /**
 * @brief Computes value-range analysis for the given @a block.
+*
+* The ranges of memory places whose output ranges have changed are recorded
+* into the change log of the @a block. If the block was analysed many times
+* and still does not converge, its changing input ranges are widened by using
+* the thresholds of the function (and eventually set to the maximal ranges),
+* so the number of passes through every block is bounded.
+*
+* @return @c true if any of the output ranges of the @a block has changed.
 */
-void ValueAnalysis::computeAnalysisForBlock(const Block *block)
+bool ValueAnalysis::computeAnalysisForBlock(const Block *block)
 {
-	computeInputRanges(block);
+	MemoryPlaceToRangeMap prevInputs;
+	MemoryPlaceSet addedInputs;
+	computeInputRanges(block, prevInputs, addedInputs);
+	MemoryPlaceToRangeMap &input = blockToInputRangesMap[block];
+	const TrimmedRangesMap prevTrimmed = getTrimmedRanges(block);
 
-	MemoryPlaceToRangeMap outputFromBlock;
-	outputFromBlock = ValueAnalysis::getRanges(block, blockToInputRangesMap);
+	// Increments counter.
+	const unsigned counter = ++blockToCounterMap[block];
+	const bool firstPass = (1 == counter);
+	const unsigned long passesBeforeWiden = LoopFinder::getUpperLimit(block)
+		+ ValueAnalysis::NumberOfPassesBeforeWiden;
+	const bool widen = (counter > passesBeforeWiden);
+	const bool top = (counter > passesBeforeWiden
+		+ ValueAnalysis::NumberOfWideningsBeforeTop);
+
+	if (widen) {
+		// Input ranges change after the last processing of the block. They are
+		// widened before the block is executed, so that the ranges trimmed by
+		// its condition are computed from the widened ranges, too.
+		for (const MemoryPlaceToRangeMap::value_type &prev : prevInputs) {
+			Range &in = input[prev.first];
+			if (in.empty())
+				continue;
+
+			in = (top)
+				? Range::getMaxRange(in[0].first)
+				: in.widen(prev.second, thresholds);
+		}
+	}
 
 	// Starts to analyze the given block.
+	RangeOverlay output(input);
 	const Insn *prevInsn = NULL;
 	for (const Insn *insn : *block) {
-		ValueAnalysis::computeAnalysisForInsn(insn, prevInsn, outputFromBlock);
+		ValueAnalysis::computeAnalysisForInsn(insn, prevInsn, output);
 		prevInsn = insn;
 	}
 
+	// Collects the memory places whose output ranges might have changed.
+	MemoryPlaceToRangeMap &prevDefs = blockToDefinedRangesMap[block];
+	MemoryPlaceToRangeMap defs = output.getDefs();
+	MemoryPlaceSet candidates;
+	for (const MemoryPlaceToRangeMap::value_type &def : defs)
+		candidates.insert(def.first);
+	for (const MemoryPlaceToRangeMap::value_type &def : prevDefs)
+		candidates.insert(def.first);
+	for (const MemoryPlaceToRangeMap::value_type &in : prevInputs)
+		candidates.insert(in.first);
+	candidates.insert(addedInputs.begin(), addedInputs.end());
+	if (firstPass) {
+		for (const MemoryPlaceToRangeMap::value_type &in : input)
+			candidates.insert(in.first);
+	}
+
+	ChangeLog &log = blockToChangeLogMap[block];
+	bool changed = false;
+	for (const MemoryPlace *mp : candidates) {
+		// The previous output range.
+		const Range *prevOut = NULL;
+		if (firstPass || addedInputs.find(mp) != addedInputs.end()) {
+			prevOut = NULL;
+		} else if (prevDefs.find(mp) != prevDefs.end()) {
+			prevOut = &prevDefs[mp];
+		} else if (prevInputs.find(mp) != prevInputs.end()) {
+			prevOut = &prevInputs[mp];
+		} else if (input.find(mp) != input.end()) {
+			prevOut = &input.find(mp)->second;
+		}
+
+		// The current output range.
+		const Range *out = output.find(mp);
+
+		if (prevOut && out && (*prevOut == *out))
+			continue;
+
+		if (!prevOut && !out)
+			continue;
+
+		log.push_back(mp);
+		changed = true;
+	}
+
 	// Assigns the output ranges to the currently processed block.
-	blockToOutputRangesMap[block] = outputFromBlock;
+	prevDefs.swap(defs);
 
-	// Increments counter.
-	++blockToCounterMap[block];
+	// Changes of trimmed ranges do not cause rescheduling of the successors,
+	// but they have to be propagated once the successors are processed.
+	const TrimmedRangesMap trimmed = getTrimmedRanges(block);
+	for (const TrimmedRangesMap::value_type &trim : trimmed) {
+		TrimmedRangesMap::const_iterator it = prevTrimmed.find(trim.first);
+		if (it == prevTrimmed.end() || it->second != trim.second)
+			log.push_back(trim.first.varMp);
+	}
+	for (const TrimmedRangesMap::value_type &trim : prevTrimmed) {
+		if (trimmed.find(trim.first) == trimmed.end())
+			log.push_back(trim.first.varMp);
+	}
+
+	return changed;
+}
+
+/**
+* @brief Collects the thresholds for the widening from the comparisons with
+*        integral constants in the given @a fnc.
+*
+* For every such constant @c c, the numbers @c c-1, @c c and @c c+1 are used,
+* so that both the strict and non-strict comparisons are covered.
+*/
+void ValueAnalysis::collectThresholds(const Fnc &fnc)
+{
+	thresholds.clear();
+
+	for (const Block *block : fnc.cfg) {
+		for (const Insn *insn : *block) {
+			if (insn->code != CL_INSN_BINOP)
+				continue;
+
+			switch (static_cast<enum cl_binop_e>(insn->subCode)) {
+				case CL_BINOP_EQ:
+				case CL_BINOP_NE:
+				case CL_BINOP_LT:
+				case CL_BINOP_GT:
+				case CL_BINOP_LE:
+				case CL_BINOP_GE:
+					break;
+
+				default:
+					continue;
+			}
+
+			// There are three operands for binary operation.
+			const TOperandList &opList = insn->operands;
+			for (TOperandList::size_type i = 1; i < opList.size(); ++i) {
+				const struct cl_operand &op = opList[i];
+				if ((op.code != CL_OPERAND_CST)
+						|| (op.data.cst.code != CL_TYPE_INT)) {
+					continue;
+				}
+
+				const Number c = Utility::convertOperandToNumber(&op);
+				const Number one = c.assign(
+					Number(1, c.getBitWidth(), c.isSigned()));
+				if (!c.isMin())
+					thresholds.push_back(c - one);
+				thresholds.push_back(c);
+				if (!c.isMax())
+					thresholds.push_back(c + one);
+			}
+		}
+	}
+}
+
+/**
+* @brief Narrows the ranges computed for the given @a fnc.
+*
+* The widening can over-approximate the ranges a lot, so after the fixed point
+* has been reached, all the reached blocks are executed a few more times
+* without the widening.
+*/
+void ValueAnalysis::narrowRangesForFnc(const Fnc &fnc)
+{
+	const Block *entryBlock = fnc.cfg.entry();
+
+	for (unsigned i = 0; i < ValueAnalysis::NumberOfNarrowingPasses; ++i) {
+		bool changed = false;
+		for (const Block *block : fnc.cfg) {
+			if (blockToCounterMap.find(block) == blockToCounterMap.end()) {
+				// This block has never been reached.
+				continue;
+			}
+
+			if (narrowRangesForBlock(block, block == entryBlock))
+				changed = true;
+		}
+
+		if (!changed)
+			break;
+	}
+}
+
+/**
+* @brief Executes the given @a block once more to narrow its ranges.
+*
+* The input ranges are computed from all the output ranges and trimmed ranges
+* of the predecessors. Both the input and output ranges are intersected with
+* the previous ones, so they can only become more precise.
+*
+* @return @c true if any of the ranges of the @a block has changed.
+*/
+bool ValueAnalysis::narrowRangesForBlock(const Block *block, bool isEntry)
+{
+	MemoryPlaceToRangeMap input;
+	if (isEntry)
+		input = GlobAnalysis::getGlobVarMap();
+
+	for (const TTargetList::value_type &pred : block->inbound()) {
+		MemoryPlaceSet mps;
+		for (const MemoryPlaceToRangeMap::value_type &in
+				: blockToInputRangesMap[pred])
+			mps.insert(in.first);
+		for (const MemoryPlaceToRangeMap::value_type &def
+				: blockToDefinedRangesMap[pred])
+			mps.insert(def.first);
+
+		for (const MemoryPlace *mp : mps) {
+			Range edgeRange;
+			if (ValueAnalysis::getEdgeRange(pred, block, mp, edgeRange))
+				input[mp] = unite(input[mp], edgeRange);
+		}
+	}
+
+	// Narrows the input ranges.
+	bool changed = false;
+	MemoryPlaceToRangeMap &prevInput = blockToInputRangesMap[block];
+	for (const MemoryPlaceToRangeMap::value_type &in : input) {
+		MemoryPlaceToRangeMap::iterator it = prevInput.find(in.first);
+		if (it == prevInput.end())
+			continue;
+
+		const Range narrowed = intersect(it->second, in.second);
+		if (narrowed.empty() || (narrowed == it->second))
+			continue;
+
+		it->second = narrowed;
+		changed = true;
+	}
+
+	// Executes the block.
+	RangeOverlay output(prevInput);
+	const Insn *prevInsn = NULL;
+	for (const Insn *insn : *block) {
+		ValueAnalysis::computeAnalysisForInsn(insn, prevInsn, output);
+		prevInsn = insn;
+	}
+
+	// Narrows the defined ranges.
+	MemoryPlaceToRangeMap &prevDefs = blockToDefinedRangesMap[block];
+	MemoryPlaceToRangeMap defs = output.getDefs();
+	for (MemoryPlaceToRangeMap::value_type &def : defs) {
+		MemoryPlaceToRangeMap::const_iterator it = prevDefs.find(def.first);
+		if (it == prevDefs.end())
+			continue;
+
+		// An empty intersection means that the new definition is not covered
+		// by the fixed point, so the previous range is kept.
+		const Range narrowed = intersect(it->second, def.second);
+		def.second = (narrowed.empty()) ? it->second : narrowed;
+	}
+
+	if (defs != prevDefs) {
+		prevDefs.swap(defs);
+		changed = true;
+	}
+
+	return changed;
 }
 
 /**
@@ -477,18 +771,13 @@ void ValueAnalysis::computeAnalysisForBlock(const Block *block)
 *        call instruction. Results are stored in @a output.
 */
 void ValueAnalysis::computeAnalysisForCall(const Insn* insn,
-	MemoryPlaceToRangeMap &output)
+	RangeOverlay &output)
 {
 	const TOperandList &opList = insn->operands;
 	const struct cl_operand &ret = opList[0];   // [0] - destination
 
-	if (ret.code == CL_OPERAND_VAR) {
-		// Without this condition, the problem with functions whose return values
-		// are not stored in the program occurred.
-		const MemoryPlace *retVar = OperandToMemoryPlace::convert(&ret);
-		Range retRange = ValueAnalysis::getRange(ret, output);
-		output[retVar] = retRange;
-	}
+	// Nothing is known about the returned value.
+	ValueAnalysis::invalidate(ret, output);
 }
 
 /**
@@ -496,7 +785,7 @@ void ValueAnalysis::computeAnalysisForCall(const Insn* insn,
 *        joins to @a output.
 */
 void ValueAnalysis::computeAnalysisForInsn(const Insn *insn, const Insn *prevInsn,
-										   MemoryPlaceToRangeMap &output)
+										   RangeOverlay &output)
 {
 	const enum cl_insn_e code = insn->code;
 
@@ -524,12 +813,18 @@ void ValueAnalysis::computeAnalysisForInsn(const Insn *insn, const Insn *prevIns
 
 		case CL_INSN_UNOP:
 			// Unary operation.
-			ValueAnalysis::computeAnalysisForUnop(insn, output);
+			if (!ValueAnalysis::isSupportedInsn(insn))
+				ValueAnalysis::invalidate(insn->operands[0], output);
+			else
+				ValueAnalysis::computeAnalysisForUnop(insn, output);
 			break;
 
 		case CL_INSN_BINOP:
 			// Binary operation.
-			ValueAnalysis::computeAnalysisForBinop(insn, output);
+			if (!ValueAnalysis::isSupportedInsn(insn))
+				ValueAnalysis::invalidate(insn->operands[0], output);
+			else
+				ValueAnalysis::computeAnalysisForBinop(insn, output);
 			break;
 
 		case CL_INSN_CALL:
@@ -610,7 +905,7 @@ bool ValueAnalysis::evaluateCond(const Range &r1, const Range &r2,
 *        This function is responsible for computing trimmed ranges.
 */
 void ValueAnalysis::computeAnalysisForCond(const Insn *insn, const Insn *prevInsn,
-										   MemoryPlaceToRangeMap &output)
+										   RangeOverlay &output)
 {
 	if (prevInsn == NULL) {
 		// If we do not have previous instruction, we cannot compute trimmed ranges.
@@ -624,6 +919,11 @@ void ValueAnalysis::computeAnalysisForCond(const Insn *insn, const Insn *prevIns
 		return;
 	}
 
+	if (!ValueAnalysis::isSupportedInsn(prevInsn)) {
+		// The operands of the comparison are not tracked.
+		return;
+	}
+
 	// Gets the necessary information about previous instruction.
 	const TOperandList &opListPrev = prevInsn->operands;
 
@@ -797,7 +1097,7 @@ void ValueAnalysis::computeAnalysisForCond(const Insn *insn, const Insn *prevIns
 *        an unary operation and computed result joins to @a output.
 */
 void ValueAnalysis::computeAnalysisForUnop(const Insn *insn,
-				    					   MemoryPlaceToRangeMap &output)
+				    					   RangeOverlay &output)
 {
 	// There are two operands for unary operations.
 	const TOperandList &opList = insn->operands;
@@ -872,7 +1172,7 @@ void ValueAnalysis::computeAnalysisForUnop(const Insn *insn,
 *        a binary operation and computed result joins to @a output.
 */
 void ValueAnalysis::computeAnalysisForBinop(const Insn *insn,
-	 										MemoryPlaceToRangeMap &output)
+	 										RangeOverlay &output)
 {
 	// There are three operands for binary operation.
 	const TOperandList &opList = insn->operands;
@@ -1090,7 +1390,11 @@ ostream& ValueAnalysis::printRanges(ostream &os, const Storage &stor)
 			os << "Block " << block.name() << "[OUT]:" << endl;
 
 			// Gets the result of analysis for the currently processed block.
-			MemoryPlaceToRangeMap &blockInfoOut = blockToOutputRangesMap[pBlock];
+			MemoryPlaceToRangeMap blockInfoOut = blockInfo;
+			for (const MemoryPlaceToRangeMap::value_type &def
+					: blockToDefinedRangesMap[pBlock])
+				blockInfoOut[def.first] = def.second;
+
 			vector<MemoryPlaceRangePair> sortedBlockInfoOut(
 				blockInfoOut.begin(), blockInfoOut.end());
 
@@ -1111,35 +1415,3 @@ ostream& ValueAnalysis::printRanges(ostream &os, const Storage &stor)
 	return os;
 }
 
-/**
-* @brief Joins data that was gained from the analysis of several blocks.
-*
-* @param[in] vec Data gained from the analysis of several blocks.
-*
-* @return United data from @a vec.
-*
-* Value-range analysis of every block is represented by @c MemoryPlaceToRangeMap
-* that contains all memory places and corresponding ranges for them. During
-* value-range analysis it is necessary to join data of different blocks
-* together. For example, join data of all predecessor blocks that will be
-* used as an input to the next block.
-*/
-ValueAnalysis::MemoryPlaceToRangeMap ValueAnalysis::join(const
-				             MemoryPlaceToRangeMapVector &vec)
-{
-	MemoryPlaceToRangeMap result;
-	if (vec.empty())
-		return result;
-
-	result = vec[0];
-	for (MemoryPlaceToRangeMap::size_type i = 1; i != vec.size(); ++i) {
-		// Iterates over all data that was got from several blocks.
-		for (MemoryPlaceToRangeMap::value_type item : vec[i]) {
-			// Iterates over all memory places.
-			result[item.first] = unite(result[item.first], item.second);
-		}
-	}
-
-	return result;
-}
-
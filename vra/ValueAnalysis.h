@@ -38,10 +38,58 @@ class ValueAnalysis {
 		/// Type of the pair consisting of memory place and corresponding range.
 		typedef std::pair<const MemoryPlace*, Range> MemoryPlaceRangePair;
 
+		/// Type of a set of memory places.
+		typedef std::set<const MemoryPlace*> MemoryPlaceSet;
+
 	private:
 		/// Just for assurance that nobody will try to use it.
 		ValueAnalysis() { }
 
+		/**
+		* @brief Ranges valid at some point of a block.
+		*
+		* These are the input ranges of the block overlaid by the ranges of
+		* memory places defined in the block so far. The input ranges are thus
+		* never copied and the evaluation of a block only touches the memory
+		* places the block defines.
+		*/
+		class RangeOverlay {
+			public:
+				/// Creates an overlay over the given input ranges.
+				explicit RangeOverlay(const MemoryPlaceToRangeMap &input):
+					input(input) {}
+
+				/// Returns the range of @a mp or NULL if it is not known.
+				const Range *find(const MemoryPlace *mp) const {
+					MemoryPlaceToRangeMap::const_iterator it = defs.find(mp);
+					if (it != defs.end())
+						return &it->second;
+
+					it = input.find(mp);
+					return (it != input.end()) ? &it->second : NULL;
+				}
+
+				/// Returns the range of @a mp for writing (it becomes defined).
+				Range& operator[](const MemoryPlace *mp) {
+					MemoryPlaceToRangeMap::iterator it = defs.find(mp);
+					if (it != defs.end())
+						return it->second;
+
+					const Range *r = find(mp);
+					return defs[mp] = (r) ? *r : Range();
+				}
+
+				/// Returns the ranges of memory places defined in the block.
+				const MemoryPlaceToRangeMap& getDefs() const { return defs; }
+
+			private:
+				/// Input ranges of the block.
+				const MemoryPlaceToRangeMap &input;
+
+				/// Ranges of memory places defined in the block.
+				MemoryPlaceToRangeMap defs;
+		};
+
 		/// Stores maximal number of passes through the block or zero if we do
 		/// not know.
 		static LoopFinder::BlockToUpperLimit tripCountOfBlockMap;
@@ -103,14 +151,37 @@ class ValueAnalysis {
 		/// Type for representing block counter.
 		typedef std::map<const CodeStorage::Block *, unsigned> BlockToCounterMap;
 
+		/// Type for the log of memory places whose output ranges (or trimmed
+		/// ranges) of a block have changed.
+		typedef std::vector<const MemoryPlace*> ChangeLog;
+
+		/// Type of change logs stored for every block.
+		typedef std::map<const CodeStorage::Block*, ChangeLog> BlockToChangeLogMap;
+
+		/// Type for representing an edge of the control flow graph.
+		typedef std::pair<const CodeStorage::Block*, const CodeStorage::Block*>
+			Edge;
+
+		/// Type for remembering how much of a change log has been propagated
+		/// along an edge.
+		typedef std::map<Edge, size_t> EdgeToLogPositionMap;
+
 		/// Mapping block to the trimmed ranges of this block.
 		static BlockToTrimmedRangesMap blockToTrimmedRangesMap;
 
 		/// Mapping block to the input ranges of this block.
 		static BlockToResultMap blockToInputRangesMap;
 
-		/// Mapping block to the output ranges of this block.
-		static BlockToResultMap blockToOutputRangesMap;
+		/// Mapping block to the ranges of memory places defined by this block.
+		/// The output ranges of other memory places are the input ranges.
+		static BlockToResultMap blockToDefinedRangesMap;
+
+		/// Mapping block to the log of changes of its output ranges.
+		static BlockToChangeLogMap blockToChangeLogMap;
+
+		/// Mapping edge to the part of the change log of its source block that
+		/// has been already propagated to its target block.
+		static EdgeToLogPositionMap edgeToLogPositionMap;
 
 		/// Block scheduler.
 		static SchedulerQueue todoQueue;
@@ -118,63 +189,78 @@ class ValueAnalysis {
 		/// Block scheduler.
 		static SchedulerSet todoSet;
 
-		/// Specifies how many times the block is executed before the expansion
-		/// of changing ranges will be performed.
-		static const unsigned NumberOfPassesBeforeExpand;
+		/// Specifies how many times the block is executed (besides the known
+		/// trip count of its loop) before the widening of changing ranges will
+		/// be performed.
+		static const unsigned NumberOfPassesBeforeWiden;
+
+		/// Specifies how many times the changing ranges of a block are widened
+		/// before they are set to the maximal ranges.
+		static const unsigned NumberOfWideningsBeforeTop;
+
+		/// Specifies how many times the blocks of a function are executed to
+		/// narrow the ranges after the fixed point has been reached.
+		static const unsigned NumberOfNarrowingPasses;
+
+		/// Thresholds for the widening harvested from the comparisons in the
+		/// currently analysed function.
+		static Range::Thresholds thresholds;
 
 		/// Stores how many times was the block executed.
 		static BlockToCounterMap blockToCounterMap;
 
 		static void scheduleBlock(const CodeStorage::Block *block);
 
-		static MemoryPlaceToRangeMap getRanges(const CodeStorage::Block* block,
-											   const BlockToResultMap &inputMap);
-
 		static TrimmedRangesMap getTrimmedRanges(const CodeStorage::Block* block);
 
-		static MemoryPlaceToRangeMap join(const MemoryPlaceToRangeMapVector &vec);
+		static const Range *getOutputRange(const CodeStorage::Block *block,
+										   const MemoryPlace *mp);
+
+		static bool getEdgeRange(const CodeStorage::Block *pred,
+								 const CodeStorage::Block *succ,
+								 const MemoryPlace *mp, Range &result);
+
+		static void computeInputRanges(const CodeStorage::Block *current,
+									   MemoryPlaceToRangeMap &prevInputs,
+									   MemoryPlaceSet &addedInputs);
 
-		static MemoryPlaceToRangeMap computePartialInputRanges(
-											const CodeStorage::Block *current,
-											const MemoryPlaceToRangeMap &out,
-											const TrimmedRangesMap &trimmed);
+		static bool computeAnalysisForBlock(const CodeStorage::Block *block);
 
-		static void computeInputRanges(const CodeStorage::Block *current);
+		static void collectThresholds(const CodeStorage::Fnc &fnc);
 
-		static void expandChangingRanges(const CodeStorage::Block *block,
-										 const MemoryPlaceToRangeMap &oldResult,
-										 const MemoryPlaceToRangeMap &newResult);
+		static void narrowRangesForFnc(const CodeStorage::Fnc &fnc);
 
-		static void computeAnalysisForBlock(const CodeStorage::Block *block);
+		static bool narrowRangesForBlock(const CodeStorage::Block *block,
+										 bool isEntry);
 
 		static void computeAnalysisForInsn(const CodeStorage::Insn *insn,
 										   const CodeStorage::Insn *prevInsn,
-										   MemoryPlaceToRangeMap &output);
+										   RangeOverlay &output);
 
 		static void computeAnalysisForCond(const CodeStorage::Insn *insn,
 										   const CodeStorage::Insn *prevInsn,
-										   MemoryPlaceToRangeMap &output);
+										   RangeOverlay &output);
 
 		static void computeAnalysisForUnop(const CodeStorage::Insn *insn,
-										   MemoryPlaceToRangeMap &output);
+										   RangeOverlay &output);
 
 		static void computeAnalysisForBinop(const CodeStorage::Insn *insn,
-										    MemoryPlaceToRangeMap &output);
+										    RangeOverlay &output);
 
 		static void computeAnalysisForCall(const CodeStorage::Insn* insn,
-										   MemoryPlaceToRangeMap &output);
+										   RangeOverlay &output);
 
 		static Range getRange(const struct cl_operand &src,
-							  MemoryPlaceToRangeMap &output,
+							  RangeOverlay &output,
 							  std::deque<int> indexes = std::deque<int>());
 
 		static void assign(const struct cl_operand &dst, const struct cl_operand &src,
-						   MemoryPlaceToRangeMap &output);
+						   RangeOverlay &output);
 
 		static void assignStructure(const struct cl_type *type,
 									const struct cl_operand &dst,
 									const struct cl_operand &src,
-				    				MemoryPlaceToRangeMap &output,
+				    				RangeOverlay &output,
 									std::deque<int> &indexes);
 
 		static void generateIndexes(const struct cl_type *type,
@@ -183,7 +269,7 @@ class ValueAnalysis {
 
 		static void assignSimpleElement(const struct cl_operand &dst,
 								 		const struct cl_operand &src,
-				 				 		MemoryPlaceToRangeMap &output,
+				 				 		RangeOverlay &output,
 								 		std::deque<int> indDst = std::deque<int>(),
 										std::deque<int> indSrc = std::deque<int>());
 
@@ -191,6 +277,10 @@ class ValueAnalysis {
 
 		static const struct cl_type *getType(const struct cl_operand &op);
 
+		static void invalidate(const struct cl_operand &dst, RangeOverlay &output);
+
+		static bool isSupportedInsn(const CodeStorage::Insn *insn);
+
 		static bool evaluateCond(const Range &r1, const Range &r2,
 			const enum cl_binop_e code);
 
@@ -200,6 +290,9 @@ class ValueAnalysis {
 										 const CodeStorage::Storage &stor);
 
 		static void computeAnalysisForFnc(const CodeStorage::Fnc &fnc);
+
+		static const Range *getRangeAtBlockEnd(const CodeStorage::Block *block,
+											   const struct cl_operand &op);
 };
 
 #endif
@@ -0,0 +1,27 @@
+# Copyright (C) 2013 Daniela Ďuričeková <xduric00@stud.fit.vutbr.cz>
+#
+# This file is part of value-range analyzer.
+#
+# Value-range analyzer is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or any later version.
+#
+# Value-range analyzer is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+# more details.
+#
+# You should have received a copy of the GNU General Public License along with
+# the value-range analyzer. If not, see <http://www.gnu.org/licenses/>.
+
+# the core of vra without its compiler plug-in entry point, shared with sl
+get_filename_component(VRA_DIR ${CMAKE_CURRENT_LIST_FILE} PATH)
+set(VRA_CORE_SOURCES
+    ${VRA_DIR}/Number.cc
+    ${VRA_DIR}/Range.cc
+    ${VRA_DIR}/MemoryPlace.cc
+    ${VRA_DIR}/OperandToMemoryPlace.cc
+    ${VRA_DIR}/ValueAnalysis.cc
+    ${VRA_DIR}/Utility.cc
+    ${VRA_DIR}/LoopFinder.cc
+    ${VRA_DIR}/GlobAnalysis.cc)
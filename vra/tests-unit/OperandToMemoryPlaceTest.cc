@@ -905,6 +905,60 @@ ConversionOfStructuresWithArrayWithSpecifiedIndexesWorksCorrectly)
 	delete op1.data.var;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// operands that are not tracked
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(OperandToMemoryPlaceTest,
+DereferencedPointerIsNotConvertedToMemoryPlace)
+{
+	// *p
+	struct cl_operand op1;
+	op1.code = CL_OPERAND_VAR;
+	op1.data.var = new struct cl_var;
+	op1.data.var->uid = 2569;
+	op1.data.var->name = "p";
+	op1.data.var->artificial = false;
+	op1.accessor = new struct cl_accessor;
+	op1.accessor->code = CL_ACCESSOR_DEREF;
+	op1.accessor->next = NULL;
+
+	EXPECT_EQ(NULL, OperandToMemoryPlace::convert(&op1));
+
+	// &p
+	op1.accessor->code = CL_ACCESSOR_REF;
+	EXPECT_EQ(NULL, OperandToMemoryPlace::convert(&op1));
+
+	delete op1.accessor;
+	delete op1.data.var;
+}
+
+TEST_F(OperandToMemoryPlaceTest,
+ItemOfUnionIsNotConvertedToMemoryPlace)
+{
+	// union {
+	//		int a;
+	// } u;
+	struct cl_operand op1;
+	op1.code = CL_OPERAND_VAR;
+	op1.data.var = new struct cl_var;
+	op1.data.var->uid = 2569;
+	op1.data.var->name = "u";
+	op1.data.var->artificial = false;
+	op1.accessor = new struct cl_accessor;
+	op1.accessor->code = CL_ACCESSOR_ITEM;
+	op1.accessor->data.item.id = 0;
+	op1.accessor->type = new struct cl_type;
+	op1.accessor->type->code = CL_TYPE_UNION;
+	op1.accessor->next = NULL;
+
+	EXPECT_EQ(NULL, OperandToMemoryPlace::convert(&op1));
+
+	delete op1.accessor->type;
+	delete op1.accessor;
+	delete op1.data.var;
+}
+
 int main(int argc, char *argv[])
 {
 	::testing::InitGoogleTest(&argc, argv);
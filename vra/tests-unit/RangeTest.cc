@@ -2847,6 +2847,67 @@ ExpandForFloatingPointsWorksCorrectly)
 		Range(F<float>(1)).expand());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// widen()
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(RangeTest,
+WidenForIntegralRangesMovesUnstableBoundsToThresholds)
+{
+	Range::Thresholds thresholds;
+	thresholds.push_back(I<int>(-10));
+	thresholds.push_back(I<int>(9));
+	thresholds.push_back(I<int>(10));
+	thresholds.push_back(I<int>(100));
+
+	// (0, 0) + (0, 1) -> (0, 9)
+	EXPECT_EQ(Range(Interval(I<int>(0), I<int>(9))),
+		Range(Interval(I<int>(0), I<int>(1))).widen(
+			Range(I<int>(0)), thresholds));
+
+	// (0, 9) + (0, 10) -> (0, 10)
+	EXPECT_EQ(Range(Interval(I<int>(0), I<int>(10))),
+		Range(Interval(I<int>(0), I<int>(10))).widen(
+			Range(Interval(I<int>(0), I<int>(9))), thresholds));
+
+	// (0, 10) + (-1, 11) -> (-10, 100)
+	EXPECT_EQ(Range(Interval(I<int>(-10), I<int>(100))),
+		Range(Interval(I<int>(-1), I<int>(11))).widen(
+			Range(Interval(I<int>(0), I<int>(10))), thresholds));
+
+	// (0, 100) + (0, 101) -> (0, MAX)
+	EXPECT_EQ(Range(Interval(I<int>(0), I<int>(vmax<int>()))),
+		Range(Interval(I<int>(0), I<int>(101))).widen(
+			Range(Interval(I<int>(0), I<int>(100))), thresholds));
+
+	// Stable ranges are not changed.
+	EXPECT_EQ(Range(Interval(I<int>(1), I<int>(5))),
+		Range(Interval(I<int>(1), I<int>(5))).widen(
+			Range(Interval(I<int>(0), I<int>(5))), thresholds));
+}
+
+TEST_F(RangeTest,
+WidenIgnoresThresholdsThatAreNotRepresentable)
+{
+	Range::Thresholds thresholds;
+	thresholds.push_back(I<int>(-1));
+	thresholds.push_back(I<int>(300));
+
+	// (0, 0) + (0, 1) -> (0, MAX)
+	EXPECT_EQ(Range(Interval(I<unsigned char>(0), I<unsigned char>(255))),
+		Range(Interval(I<unsigned char>(0), I<unsigned char>(1))).widen(
+			Range(I<unsigned char>(0)), thresholds));
+}
+
+TEST_F(RangeTest,
+WidenForFloatingPointsWorksCorrectly)
+{
+	// Currently, widen() for floating-point ranges returns the maximal range.
+	EXPECT_EQ(Range(Interval(F<float>(NAN), F<float>(NAN)),
+			Interval(F<float>(-INFINITY), F<float>(INFINITY))),
+		Range(F<float>(1)).widen(Range(F<float>(0)), Range::Thresholds()));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // mergeIntervals()
 ////////////////////////////////////////////////////////////////////////////////
@@ -4689,6 +4750,10 @@ TruncDivWorksCorrectlyWhenDividingSignedIntWithSignedInt)
 	EXPECT_EQ(Range(Interval(I<int>(-2), I<int>(3))),
 		trunc_div(Range(Interval(I<int>(-2), I<int>(3))),
 			Range(Interval(I<int>(1), I<int>(4)))));
+	// (0, 1000) / (2, 2)
+	EXPECT_EQ(Range(Interval(I<int>(0), I<int>(500))),
+		trunc_div(Range(Interval(I<int>(0), I<int>(1000))),
+			Range(Interval(I<int>(2), I<int>(2)))));
 	// (INT_MIN, INT_MIN) / (1, 1)
 	EXPECT_EQ(Range(Interval(I<int>(vmin<int>()), I<int>(vmin<int>()))),
 		trunc_div(Range(Interval(I<int>(vmin<int>()), I<int>(vmin<int>()))),
@@ -382,6 +382,70 @@ GetMaxRangeWithSpecifiedIndexesForNestedStructureWorksCorrecly)
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// isSupportedType(), isSupportedOperand()
+////////////////////////////////////////////////////////////////////////////////
+
+TEST_F(UtilityTest,
+NumbersAndStructuresOfNumbersAreSupported)
+{
+	struct cl_type t1;
+	t1.code = CL_TYPE_INT;
+	EXPECT_TRUE(Utility::isSupportedType(&t1));
+
+	struct cl_type t2;
+	t2.code = CL_TYPE_PTR;
+	EXPECT_FALSE(Utility::isSupportedType(&t2));
+
+	// struct {
+	//		int a;
+	//		int *b;
+	// }
+	struct cl_type t3;
+	t3.code = CL_TYPE_STRUCT;
+	t3.item_cnt = 1;
+	t3.items = new struct cl_type_item[2];
+	t3.items[0].type = &t1;
+	t3.items[1].type = &t2;
+	EXPECT_TRUE(Utility::isSupportedType(&t3));
+
+	t3.item_cnt = 2;
+	EXPECT_FALSE(Utility::isSupportedType(&t3));
+
+	delete [] t3.items;
+}
+
+TEST_F(UtilityTest,
+AddressesAndPointerConstantsAreNotSupported)
+{
+	struct cl_type ptr;
+	ptr.code = CL_TYPE_PTR;
+
+	// NULL
+	struct cl_operand op1;
+	op1.code = CL_OPERAND_CST;
+	op1.data.cst.code = CL_TYPE_INT;
+	op1.type = &ptr;
+	EXPECT_FALSE(Utility::isSupportedOperand(op1));
+
+	// &a
+	struct cl_operand op2;
+	op2.code = CL_OPERAND_VAR;
+	op2.type = &ptr;
+	EXPECT_FALSE(Utility::isSupportedOperand(op2));
+
+	struct cl_type num;
+	num.code = CL_TYPE_INT;
+
+	// 1
+	op1.type = &num;
+	EXPECT_TRUE(Utility::isSupportedOperand(op1));
+
+	// *p
+	op2.type = &num;
+	EXPECT_TRUE(Utility::isSupportedOperand(op2));
+}
+
 int main(int argc, char *argv[])
 {
 	::testing::InitGoogleTest(&argc, argv);